@@ -0,0 +1,51 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  bench_types.h
+ *
+ *    Description:  the multivector types the bench tools iterate over
+ *
+ *                  BENCH_TYPES(X) lists the conformal types by name; X(T) is expanded
+ *                  to cga3D::T (xBench) or NT<DIM> (xCost),
+ *                  and pairs<F>( ... ) calls F::template run<A,B>( na, nb ) for every pair of listed types.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  bench_types_INC
+#define  bench_types_INC
+
+#define BENCH_TYPES(X) X(Sca) X(Vec) X(Vec2D) X(Biv) X(Tri) X(Rot) X(Ori) X(Inf) X(Mnk) X(Pss) \
+  X(Pnt) X(Par) X(Cir) X(Sph) X(Drv) X(Tnv) X(Drb) X(Tnb) X(Drt) X(Tnt) \
+  X(Dll) X(Lin) X(Flp) X(Pln) X(Dlp) X(Trs) X(Mot) X(Trv) X(Bst) X(Dil) X(Tsd)
+
+#define BENCH_VERSORS(X) X(Rot) X(Trs) X(Mot) X(Trv) X(Bst) X(Dil) X(Tsd)
+
+#define BENCH_NAME(T) #T,
+
+namespace bench {
+
+  template<class ... XS> struct Types {};
+
+  /// the listed types after a leading void (so that lists can be built as void X(A) X(B) ...)
+  template<class ... XS>
+  Types<XS...> types( Types<void, XS...> ){ return Types<XS...>(); }
+
+  template<class F, class A, class ... BS>
+  void pairRow( const char * na, Types<BS...>, const char * const * nb ){
+    int tmp[] = { 0, ( F::template run<A, BS>( na, *nb++ ), 0 )... };
+    (void)tmp;
+  }
+
+  /// F::run<A,B>( na, nb ) for every A in AS and B in BS
+  template<class F, class ... AS, class ... BS>
+  void pairs( Types<AS...>, const char * const * na, Types<BS...> b, const char * const * nb ){
+    int tmp[] = { 0, ( pairRow<F, AS>( *na++, b, nb ), 0 )... };
+    (void)tmp;
+  }
+
+} // bench::
+
+#endif   /* ----- #ifndef bench_types_INC  ----- */
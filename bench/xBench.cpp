@@ -0,0 +1,381 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  xBench.cpp
+ *
+ *    Description:  headless timings of the core products and generators
+ *
+ *                  make bench          (writes build/bin/xBench.json)
+ *                  xBench [ms] > out.json
+ *
+ *                  Every gp, op and ip among the cga3D types, the Gen, Ro and Op
+ *                  functions, Jacobian against finite differences, Frame::twist,
+ *                  cached Frame::mat and mot against recomputing them,
+ *                  Frame::step against FrameArray::step,
+ *                  Chain::fk / fkChanged / fabrik, ChainBatch::fk, ChainIK::solve,
+ *                  FrameTree::update, MotorTrack sampling against CoupledTwist::mot,
+ *                  packed rotor and motor codes, Field solvers, ConvexHull::calc and
+ *                  Root::System.  Each entry reports ns per call, calls per second and,
+ *                  for products, the flops of their instruction lists (ProdCost in
+ *                  vsr_products.h).
+ *                  JSON goes to stdout, progress to stderr.  ms is the time spent
+ *                  on each entry (default 20).
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "vsr_cga3D_op.h"
+#include "vsr_cga3D_frame.h"
+#include "vsr_cga3D_frameArray.h"
+#include "vsr_cga3D_frameTree.h"
+#include "vsr_chain.h"
+#include "vsr_chain_batch.h"
+#include "vsr_chain_ik.h"
+#include "vsr_field.h"
+#include "vsr_hull.h"
+#include "vsr_root.h"
+#include "vsr_track.h"
+#include "vsr_jacobian.h"
+#include "vsr_packed.h"
+
+#include "bench_types.h"
+
+using namespace vsr;
+using namespace vsr::cga3D;
+using namespace std;
+
+namespace bench {
+
+  typedef chrono::steady_clock Clock;
+
+  struct Result {
+    string group, name;
+    double ns;
+    int flops;
+  };
+
+  vector<Result> results;
+  double minMs = 20;
+
+  /// keeps the compiler from dropping the work that wrote p
+  template<class T>
+  void clobber( const T * p ){ asm volatile( "" : : "g"(p) : "memory" ); }
+
+  /// best ns per call of f() over rounds of n calls, until minMs have passed
+  template<class F>
+  double time( F f, int n ){
+    double best = 1e30, total = 0;
+    while ( total < minMs * 1e6 ){
+      Clock::time_point t = Clock::now();
+      f(n);
+      double ns = chrono::duration<double, nano>( Clock::now() - t ).count();
+      total += ns;
+      if ( ns / n < best ) best = ns / n;
+    }
+    return best;
+  }
+
+  template<class F>
+  void add( const string& group, const string& name, F f, int n, int flops = 0 ){
+    Result r = { group, name, time( f, n ), flops };
+    results.push_back( r );
+    fprintf( stderr, "%-10s %-20s %10.2f ns\n", group.c_str(), name.c_str(), r.ns );
+  }
+
+  void json( FILE * fp ){
+    fprintf( fp, "{\n  \"time\": %ld,\n  \"ms_per_entry\": %g,\n  \"results\": [\n", (long)::time(0), minMs );
+    for (size_t i = 0; i < results.size(); ++i){
+      const Result& r = results[i];
+      fprintf( fp, "    { \"group\": \"%s\", \"name\": \"%s\", \"ns_per_op\": %.3f, \"ops_per_sec\": %.0f",
+        r.group.c_str(), r.name.c_str(), r.ns, r.ns > 0 ? 1e9 / r.ns : 0 );
+      if ( r.flops ) fprintf( fp, ", \"flops\": %d, \"gflops\": %.3f", r.flops, r.ns > 0 ? r.flops / r.ns : 0 );
+      fprintf( fp, " }%s\n", i + 1 < results.size() ? "," : "" );
+    }
+    fprintf( fp, "  ]\n}\n" );
+  }
+
+  double rnd(){ return (double)rand() / RAND_MAX - .5; }
+
+  template<class A>
+  A rand(){ A a; for (int i = 0; i < A::Num; ++i) a[i] = rnd(); return a; }
+
+  template<class A>
+  vector<A> rands( int n ){ vector<A> v( n ); for (auto& a : v) a = rand<A>(); return v; }
+
+  /*-----------------------------------------------------------------------------
+   *  PRODUCTS: a[i] K b[i] over arrays of Len elements (run for each pair of types)
+   *-----------------------------------------------------------------------------*/
+  static const int Len = 64;
+
+  typedef CGA<5>::M M;
+
+  struct Products{
+    template<class A, class B>
+    static void run( const char * na, const char * nb ){
+      vector<A> a = rands<A>( Len );
+      vector<B> b = rands<B>( Len );
+      string name = string( na ) + " " + nb;
+
+      typedef decltype( A() * B() ) G;
+      vector<G> g( Len );
+      add( "gp", name, [&]( int n ){
+        for (int k = 0; k < n; k += Len)
+          for (int i = 0; i < Len; ++i) g[i] = a[i] * b[i];
+        clobber( g.data() );
+      }, Len * 64, Prod<A, B, M, true>::Cost::Flops );
+
+      typedef decltype( A() ^ B() ) O;
+      vector<O> o( Len );
+      add( "op", name, [&]( int n ){
+        for (int k = 0; k < n; k += Len)
+          for (int i = 0; i < Len; ++i) o[i] = a[i] ^ b[i];
+        clobber( o.data() );
+      }, Len * 64, OProd<A, B, M, true>::Cost::Flops );
+
+      typedef decltype( A() <= B() ) I;
+      vector<I> p( Len );
+      add( "ip", name, [&]( int n ){
+        for (int k = 0; k < n; k += Len)
+          for (int i = 0; i < Len; ++i) p[i] = a[i] <= b[i];
+        clobber( p.data() );
+      }, Len * 64, IProd<A, B, M, true>::Cost::Flops );
+    }
+  };
+
+} // bench::
+
+#define BENCH_TYPE(T) , T
+
+int main( int argc, char ** argv ){
+
+  using namespace bench;
+
+  if ( argc > 1 ) minMs = atof( argv[1] );
+  srand( 1 );
+
+  /*-----------------------------------------------------------------------------
+   *  PRODUCTS
+   *-----------------------------------------------------------------------------*/
+  static const char * const names[] = { BENCH_TYPES(BENCH_NAME) 0 };
+  auto all = types( Types< void BENCH_TYPES(BENCH_TYPE) >() );
+  pairs<Products>( all, names, all, names );
+
+  /*-----------------------------------------------------------------------------
+   *  GENERATORS AND ROUND / FLAT FUNCTIONS
+   *-----------------------------------------------------------------------------*/
+  vector<Biv> biv = rands<Biv>( Len );
+  vector<Dll> dll = rands<Dll>( Len );
+  vector<Par> par = rands<Par>( Len );
+  vector<Vec> vec = rands<Vec>( Len );
+  vector<Cir> cir = rands<Cir>( Len );
+  vector<Lin> lin = rands<Lin>( Len );
+  vector<Mot> mot( Len );
+  for (int i = 0; i < Len; ++i){
+    biv[i] *= .5;
+    dll[i] *= .5;
+    par[i] = ( Ro::null( rand<Vec>() ) ^ Ro::null( rand<Vec>() ) ) * .5;
+    mot[i] = Gen::mot( dll[i] );
+    cir[i] = Ro::null( rand<Vec>() ) ^ Ro::null( rand<Vec>() ) ^ Ro::null( rand<Vec>() );
+  }
+
+  vector<Rot> rot( Len );
+  vector<Mot> mout( Len );
+  vector<Dll> dout( Len );
+  vector<Bst> bst( Len );
+  vector<Trs> trs( Len );
+  vector<Pnt> pnt( Len );
+  vector<VT> sca( Len );
+
+  add( "Gen", "rot", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) rot[i] = Gen::rot( biv[i] ); clobber( rot.data() ); }, Len * 16 );
+  add( "Gen", "mot", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) mout[i] = Gen::mot( dll[i] ); clobber( mout.data() ); }, Len * 16 );
+  add( "Gen", "log", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) dout[i] = Gen::log( mot[i] ); clobber( dout.data() ); }, Len * 16 );
+  add( "Gen", "bst", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) bst[i] = Gen::bst( par[i] ); clobber( bst.data() ); }, Len * 16 );
+  add( "Gen", "trs", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) trs[i] = Gen::trs( vec[i] ); clobber( trs.data() ); }, Len * 16 );
+
+  add( "Ro", "null", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) pnt[i] = Ro::null( vec[i] ); clobber( pnt.data() ); }, Len * 16 );
+  add( "Ro", "split", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) pnt[i] = Ro::split( par[i] )[0]; clobber( pnt.data() ); }, Len * 16 );
+  add( "Ro", "loc", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) pnt[i] = Ro::loc( cir[i] ); clobber( pnt.data() ); }, Len * 16 );
+  add( "Ro", "size", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) sca[i] = Ro::size( cir[i], true ); clobber( sca.data() ); }, Len * 16 );
+
+  add( "Op", "dl", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) dout[i] = Op::dl( lin[i] ); clobber( dout.data() ); }, Len * 16 );
+
+  //derivatives of a point spun by a motor: exact, and forward differences in the 8 coefficients
+  typedef Jacobian<Pnt, Mot> JPM;
+  vector<JPM> jac( Len );
+  add( "Jacobian", "Pnt.sp(Mot)", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) jac[i].set( pnt[i], mot[i] ); clobber( jac.data() ); }, Len );
+  add( "Jacobian", "Pnt.sp(Mot) differences", [&]( int n ){
+    for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i){
+      Pnt r = pnt[i].sp( mot[i] );
+      for (int l = 0; l < Mot::Num; ++l){
+        Mot m = mot[i]; m[l] += 1e-6;
+        Pnt d = pnt[i].sp( m );
+        for (int j = 0; j < Pnt::Num; ++j) jac[i].db[j][l] = ( d[j] - r[j] ) * 1e6;
+      }
+    }
+    clobber( jac.data() );
+  }, Len );
+
+  /*-----------------------------------------------------------------------------
+   *  FRAMES AND CHAINS
+   *-----------------------------------------------------------------------------*/
+  Frame frame;
+  add( "Frame", "twist", [&]( int n ){ for (int k = 0; k < n; ++k) frame.twist( dll[k % Len] * .01 ); clobber( &frame ); }, 256 );
+
+  //what Render( const Frame& ) and Chain::fk ask of a frame that has not moved: recomputed, then cached
+  const Frame still( mot[0] );
+  gfx::Mat4f mat;
+  Mot mstill;
+  add( "Frame", "Xf::mat(rot,vec,scale)", [&]( int n ){ for (int k = 0; k < n; ++k) mat = Xf::mat( still.rot(), still.vec(), still.scale() ); clobber( &mat ); }, 256 );
+  add( "Frame", "mat", [&]( int n ){ for (int k = 0; k < n; ++k) mat = still.mat(); clobber( &mat ); }, 256 );
+  add( "Frame", "trs * rot", [&]( int n ){ for (int k = 0; k < n; ++k) mstill = still.trs() * still.rot(); clobber( &mstill ); }, 256 );
+  add( "Frame", "mot", [&]( int n ){ for (int k = 0; k < n; ++k) mstill = still.mot(); clobber( &mstill ); }, 256 );
+
+  //per frame: a vector of Frames against a FrameArray, sequential and on every core
+  const int NumFrames = 4096;
+  vector<Frame> frames( NumFrames );
+  for (int i = 0; i < NumFrames; ++i){ frames[i].dx() = vec[i % Len] * .01; frames[i].db() = biv[i % Len] * .01; frames[i].ax() = frames[i].ab() = 1; }
+  FrameArray fa = FrameArray::From( frames );
+  add( "Frame", "step", [&]( int n ){ for (int k = 0; k < n; k += NumFrames) for (auto& f : frames) f.step(); clobber( frames.data() ); }, NumFrames );
+  add( "FrameArray", "step seq", [&]( int n ){ for (int k = 0; k < n; k += NumFrames) fa.step( par::seq ); clobber( &fa ); }, NumFrames );
+  add( "FrameArray", "step par", [&]( int n ){ for (int k = 0; k < n; k += NumFrames) fa.step( par::par ); clobber( &fa ); }, NumFrames );
+  add( "FrameArray", "twist seq", [&]( int n ){ for (int k = 0; k < n; k += NumFrames) fa.twist( par::seq, mot[0] ); clobber( &fa ); }, NumFrames );
+
+  Chain chain( 6 );
+  for (int i = 0; i < chain.num(); ++i) chain.joint(i).rot() = Gen::rot( biv[i] * .2 );
+  add( "Chain", "fk", [&]( int n ){ for (int k = 0; k < n; ++k) chain.fk(); clobber( &chain ); }, 64 );
+  Pnt target = Ro::null( 1, 2, 1 );
+  add( "Chain", "fabrik", [&]( int n ){ for (int k = 0; k < n; ++k){ chain.fk(); chain.fabrik( target, chain.num() - 1, 0 ); } clobber( &chain ); }, 4 );
+
+  //only the last joint turned: fkChanged() starts from it, fk() from the base
+  add( "Chain", "fk last joint", [&]( int n ){
+    for (int k = 0; k < n; ++k){ chain.joint( chain.num() - 1 ).rot() = Gen::rot( biv[k % Len] * .2 ); chain.fk(); }
+    clobber( &chain );
+  }, 64 );
+  add( "Chain", "fkChanged last joint", [&]( int n ){
+    for (int k = 0; k < n; ++k){ chain.joint( chain.num() - 1 ).rot() = Gen::rot( biv[k % Len] * .2 ); chain.fkChanged(); }
+    clobber( &chain );
+  }, 64 );
+
+  //per configuration: the six joints turned by NumFrames sets of angles at once
+  vector<ChainBatch::ScaBatch> angles( chain.num(), ChainBatch::ScaBatch( NumFrames ) );
+  for (int j = 0; j < chain.num(); ++j)
+    for (int i = 0; i < NumFrames; ++i) angles[j].data(0)[i] = rnd() * PI;
+  ChainBatch configs( chain.num(), NumFrames );
+  add( "ChainBatch", "fk seq", [&]( int n ){ for (int k = 0; k < n; k += NumFrames) configs.fk( par::seq, chain, angles ); clobber( &configs ); }, NumFrames );
+  add( "ChainBatch", "fk par", [&]( int n ){ for (int k = 0; k < n; k += NumFrames) configs.fk( par::par, chain, angles ); clobber( &configs ); }, NumFrames );
+
+  //inverse kinematics: from rest to a pose of 8 joints, and 64 joints following a moving target
+  Chain arm( 8 ), snake( 64 );
+  for (int i = 0; i < snake.num(); ++i){
+    if ( i < arm.num() ) arm.link(i).rot() = Gen::rot( biv[i] * .5 );
+    snake.link(i).rot() = Gen::rot( biv[i % Len] * .5 );
+  }
+  ChainIK armIK( arm ), snakeIK( snake );
+  for (int i = 0; i < arm.num(); ++i) armIK.angle( i, rnd() );
+  for (int i = 0; i < snake.num(); ++i) snakeIK.angle( i, rnd() * .5 );
+  arm.fk(); snake.fk();
+  const Frame pose = arm.frame( arm.num() - 1 ), head = snake.frame( snake.num() - 1 );
+  add( "ChainIK", "8 joints from rest", [&]( int n ){
+    for (int k = 0; k < n; ++k){ for (int i = 0; i < arm.num(); ++i) armIK.angle( i, 0 ); armIK.solve( pose ); }
+    clobber( &arm );
+  }, 4 );
+  add( "ChainIK", "64 joints tracking", [&]( int n ){
+    for (int k = 0; k < n; ++k){
+      Frame t = head;
+      t.pos() = Ro::null( Vec( head.pos() ) + Vec( cos( k * .01 ), sin( k * .01 ), 0 ) * .1 );
+      snakeIK.solve( t );
+    }
+    clobber( &snake );
+  }, 64 );
+
+  //the same chain on a FrameTree, its last joint turned: one node recomputed instead of six
+  FrameTree ctree;
+  int first = ctree.add( chain );
+  add( "Chain", "tree last joint", [&]( int n ){
+    for (int k = 0; k < n; ++k){
+      chain.joint( chain.num() - 1 ).rot() = Gen::rot( biv[k % Len] * .2 );
+      ctree.pull( first, chain ); ctree.update( par::seq ); ctree.push( first, chain );
+    }
+    clobber( &chain );
+  }, 64 );
+
+  //per node: a tree of four children each, every node changed, or one leaf
+  FrameTree tree;
+  for (int i = 0; i < NumFrames; ++i) tree.add( mot[i % Len], i ? ( i - 1 ) / 4 : -1 );
+  add( "FrameTree", "update all seq", [&]( int n ){
+    for (int k = 0; k < n; k += NumFrames){ for (int i = 0; i < NumFrames; ++i) tree.local( i, mot[i % Len] ); tree.update( par::seq ); }
+    clobber( &tree );
+  }, NumFrames );
+  add( "FrameTree", "update all par", [&]( int n ){
+    for (int k = 0; k < n; k += NumFrames){ for (int i = 0; i < NumFrames; ++i) tree.local( i, mot[i % Len] ); tree.update( par::par ); }
+    clobber( &tree );
+  }, NumFrames );
+  add( "FrameTree", "update one leaf", [&]( int n ){
+    for (int k = 0; k < n; ++k){ tree.local( NumFrames - 1, mot[k % Len] ); tree.update(); }
+    clobber( &tree );
+  }, 256 );
+
+  /*-----------------------------------------------------------------------------
+   *  TRACKS: the coupled twist itself, and a cubic track through 32 of its motors
+   *-----------------------------------------------------------------------------*/
+  CoupledTwist coupled;
+  for (int i = 0; i < 3; ++i) coupled[i] = dll[i];
+  MotorTrack track( coupled, 32 );
+  vector<double> ts( Len );
+  for (int i = 0; i < Len; ++i) ts[i] = (double)i / ( Len - 1 );
+  add( "Track", "CoupledTwist::mot", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) mout[i] = coupled.mot( ts[i] ); clobber( mout.data() ); }, Len * 4 );
+  add( "Track", "at", [&]( int n ){ for (int k = 0; k < n; k += Len) for (int i = 0; i < Len; ++i) mout[i] = track.at( ts[i] ); clobber( mout.data() ); }, Len * 4 );
+  add( "Track", "eval", [&]( int n ){ for (int k = 0; k < n; k += Len) track.eval( ts.data(), Len, mout.data() ); clobber( mout.data() ); }, Len * 4 );
+
+  /*-----------------------------------------------------------------------------
+   *  PACKED: decoding compact rotors and motors
+   *-----------------------------------------------------------------------------*/
+  PackedArray<Rot16> prot( rot );
+  PackedArray<Mot16> pmot( mot );
+  PackedArray<MotF> pmotf( mot );
+  vector<Rot> rout( Len );
+  add( "Packed", "Rot16 decode", [&]( int n ){ for (int k = 0; k < n; k += Len) prot.decode( 0, Len, rout.data() ); clobber( rout.data() ); }, Len * 4 );
+  add( "Packed", "Mot16 decode", [&]( int n ){ for (int k = 0; k < n; k += Len) pmot.decode( 0, Len, mout.data() ); clobber( mout.data() ); }, Len * 4 );
+  add( "Packed", "MotF decode", [&]( int n ){ for (int k = 0; k < n; k += Len) pmotf.decode( 0, Len, mout.data() ); clobber( mout.data() ); }, Len * 4 );
+  add( "Packed", "Mot16 encode", [&]( int n ){ for (int k = 0; k < n; k += Len) pmot.encode( mot.data(), Len, 0 ); clobber( pmot.data() ); }, Len * 4 );
+
+  /*-----------------------------------------------------------------------------
+   *  FIELDS
+   *-----------------------------------------------------------------------------*/
+  Field<Vec> field( 16, 16, 16 ), prev( 16, 16, 16 ), velocity( 16, 16, 16 );
+  for (int i = 0; i < field.num(); ++i){
+    prev.dataPtr()[i] = rand<Vec>();
+    velocity.dataPtr()[i] = rand<Vec>();
+  }
+  add( "Field", "advect", [&]( int n ){ for (int k = 0; k < n; ++k) field.advect( prev, velocity, .1, false ); clobber( field.dataPtr() ); }, 1 );
+  add( "Field", "diffuse", [&]( int n ){ for (int k = 0; k < n; ++k) field.diffuse( prev, .1, false, false ); clobber( field.dataPtr() ); }, 1 );
+  add( "Field", "gsSolver", [&]( int n ){ for (int k = 0; k < n; ++k) field.gsSolver( prev ); clobber( field.dataPtr() ); }, 1 );
+
+  /*-----------------------------------------------------------------------------
+   *  HULLS AND ROOT SYSTEMS
+   *-----------------------------------------------------------------------------*/
+  vector<NEVec<3>> cloud( 256 );
+  for (auto& v : cloud) v = NEVec<3>( rnd(), rnd(), rnd() );
+  ConvexHull<3> hull;
+  add( "ConvexHull", "calc", [&]( int n ){ for (int k = 0; k < n; ++k) hull.calc( cloud ); clobber( &hull ); }, 1 );
+
+  typedef NEVec<4> V4;
+  vector<V4> roots;
+  add( "Root", "System", [&]( int n ){
+    for (int k = 0; k < n; ++k) roots = Root::System( V4(0,1,-1,0), V4(1,-1,0,0), V4(0,0,1,0), V4(-1,-1,-1,1) * .5 );
+    clobber( roots.data() );
+  }, 1 );
+
+  json( stdout );
+
+  return 0;
+}
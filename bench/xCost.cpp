@@ -0,0 +1,86 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  xCost.cpp
+ *
+ *    Description:  cost matrix of the products of a conformal algebra, as CSV
+ *
+ *                  make bench/xCost.cpp              (writes build/bin/xCost.json)
+ *                  xCost > cost.csv
+ *
+ *                  One row per gp, op and ip of every pair of types of CGA<COST_DIM>
+ *                  (default 5, set with USRFLAGS=-DCOST_DIM=6), and per sandwich of
+ *                  every type by a versor.  Columns are those of ProdCost: multiplies,
+ *                  adds, flops, output blades written, and the fraction of coefficient
+ *                  pairs multiplied.  Nothing is timed, every number is a compile time
+ *                  constant (see xBench for timings).
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#include <cstdio>
+
+#include "vsr_products.h"
+
+#include "bench_types.h"
+
+#ifndef COST_DIM
+#define COST_DIM 5
+#endif
+
+using namespace vsr;
+
+namespace bench {
+
+  typedef CGA<COST_DIM>::M M;
+
+  void row( const char * k, const char * na, const char * nb, int muls, int adds, int blades, double density, const char * path ){
+    printf( "%s,%s,%s,%d,%d,%d,%d,%.3f,%s\n", k, na, nb, muls, adds, muls + adds, blades, density, path );
+  }
+
+  template<class C>
+  void row( const char * k, const char * na, const char * nb ){
+    row( k, na, nb, C::Muls, C::Adds, C::Blades, C::Density, "" );
+  }
+
+  struct Products{
+    template<class A, class B>
+    static void run( const char * na, const char * nb ){
+      row< typename Prod<A, B, M, true>::Cost >( "gp", na, nb );
+      row< typename OProd<A, B, M, true>::Cost >( "op", na, nb );
+      row< typename IProd<A, B, M, true>::Cost >( "ip", na, nb );
+    }
+  };
+
+  /// b * a * ~b for versor B
+  struct Sandwiches{
+    template<class A, class B>
+    static void run( const char * na, const char * nb ){
+      typedef SandwichProd<A, B, M, true> S;
+      typedef typename S::Cost C;
+      row( "sp", na, nb, C::Muls, C::Adds, C::Blades, (double)C::Muls / ( A::Num * B::Num * B::Num ), S::UseFused ? "fused" : "staged" );
+    }
+  };
+
+} // bench::
+
+#define COST_TYPE(T) , N##T<COST_DIM>
+
+int main(){
+
+  using namespace bench;
+
+  static const char * const names[] = { BENCH_TYPES(BENCH_NAME) 0 };
+  static const char * const versors[] = { BENCH_VERSORS(BENCH_NAME) 0 };
+
+  auto all = types( Types< void BENCH_TYPES(COST_TYPE) >() );
+  auto vs = types( Types< void BENCH_VERSORS(COST_TYPE) >() );
+
+  printf( "product,a,b,muls,adds,flops,blades,density,path\n" );
+  pairs<Products>( all, names, all, names );
+  pairs<Sandwiches>( all, names, vs, versors );
+
+  return 0;
+}
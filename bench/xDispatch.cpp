@@ -0,0 +1,199 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  xDispatch.cpp
+ *
+ *    Description:  checks and times every level of the kernels of vsr_dispatch.h
+ *
+ *                  make bench/xDispatch.cpp        (writes build/bin/xDispatch.json)
+ *                  VSR_SIMD=sse2 xDispatch         (level used by CGAMVBatch and Field)
+ *
+ *                  For each level this cpu supports and each kernel: the largest
+ *                  difference from the instruction lists, Field loop or Gen function
+ *                  it stands in for (relative, for the exponentials and logarithms at
+ *                  each accuracy), and ns per element of both.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include "vsr_cga3D_op.h"
+#include "vsr_batch.h"
+#include "vsr_dispatch.h"
+
+using namespace vsr;
+using namespace vsr::cga3D;
+using namespace std;
+
+namespace bench {
+
+  typedef chrono::steady_clock Clock;
+
+  static const int Len = 1003;  //not a multiple of any width, so tails are checked too
+
+  template<class T>
+  void clobber( const T * p ){ asm volatile( "" : : "g"(p) : "memory" ); }
+
+  /// best ns per element of f() over n elements
+  template<class F>
+  double time( F f, int n = Len ){
+    double best = 1e30;
+    for (int k = 0; k < 100; ++k){
+      Clock::time_point t = Clock::now();
+      f();
+      double ns = chrono::duration<double, nano>( Clock::now() - t ).count() / n;
+      if ( ns < best ) best = ns;
+    }
+    return best;
+  }
+
+  double rnd(){ return (double)rand() / RAND_MAX - .5; }
+
+  template<class A>
+  A rand(){ A a; for (int i = 0; i < A::Num; ++i) a[i] = rnd(); return a; }
+
+  /// SoA arrays of a batch
+  template<class S>
+  vector<const double *> in( const S& s ){ vector<const double *> p; for (int k = 0; k < S::Num; ++k) p.push_back( s.data(k) ); return p; }
+  template<class S>
+  vector<double *> out( S& s ){ vector<double *> p; for (int k = 0; k < S::Num; ++k) p.push_back( s.data(k) ); return p; }
+
+  template<class S>
+  double err( const S& a, const S& b ){
+    double e = 0;
+    for (size_t i = 0; i < a.size(); ++i) for (int k = 0; k < S::Num; ++k) e = fmax( e, fabs( a.data(k)[i] - b.data(k)[i] ) );
+    return e;
+  }
+
+  int count = 0;
+
+  void entry( const simd::Kernels& K, const char * name, double e, double nk, double ng, int acc = -1 ){
+    static const char * const tiers[] = { "fast", "single", "full" };
+    printf( "%s    { \"level\": \"%s\", \"name\": \"%s\", ", count++ ? ",\n" : "", K.name, name );
+    if ( acc >= 0 ) printf( "\"accuracy\": \"%s\", ", tiers[acc] );
+    printf( "\"error\": %g, \"ns_kernel\": %.3f, \"ns_generic\": %.3f }", e, nk, ng );
+  }
+
+  /// kernel f of accuracy acc over a, against g( a[i] ): error relative to max( 1, |g| )
+  template<class R, class A>
+  struct Maps {
+    template<class G>
+    static void check( const simd::Kernels& K, int acc, const char * name, simd::Kernels::Map f, const vector<A>& a, G g ){
+      vector<R> rg( Len );
+      double ng = time( [&](){ for (int i = 0; i < Len; ++i) rg[i] = g( a[i] ); clobber( rg.data() ); } );
+      auto ba = CGAMVBatch<5, decltype( swBase( A() ) )>::From( a );
+      CGAMVBatch<5, decltype( swBase( R() ) )> br( Len );
+      vector<const double *> pa = in( ba );
+      vector<double *> pr = out( br );
+      double nk = time( [&](){ f( pa.data(), pr.data(), Len ); clobber( br.data(0) ); } );
+      double e = 0;
+      for (int i = 0; i < Len; ++i){
+        double s = 1;
+        for (int k = 0; k < R::Num; ++k) s = fmax( s, fabs( rg[i][k] ) );
+        for (int k = 0; k < R::Num; ++k) e = fmax( e, fabs( br.data(k)[i] - rg[i][k] ) / s );
+      }
+      entry( K, name, e, nk, ng, acc );
+    }
+  };
+
+} // bench::
+
+int main(){
+
+  using namespace bench;
+
+  srand( 1 );
+
+  typedef CGA<5>::M M;
+  NPntBatch<5> pnt( Len ), pk( Len ), pg( Len );
+  NMotBatch<5> ma( Len ), mb( Len ), mk( Len ), mg( Len );
+  for (int i = 0; i < Len; ++i){
+    pnt.set( i, Ro::null( rand<Vec>() ) );
+    ma.set( i, rand<Mot>() );
+    mb.set( i, rand<Mot>() );
+  }
+  Mot m = Gen::mot( rand<Dll>() );
+
+  //generic: the inline instruction lists over blocks of VSR_SIMD_BYTES
+  auto tm = CGAMV<5, decltype( lanes( m ) )>( lanes( m ) );
+  SandwichProd< NPntBatch<5>::PackElem, decltype(tm), M, true > s;
+  double gsp = time( [&](){ for (size_t j = 0; j < pnt.blocks(); ++j) pg.store( j, s.fused( pnt.block(j), tm ) ); clobber( pg.data(0) ); } );
+  double ggp = time( [&](){ for (size_t j = 0; j < ma.blocks(); ++j) mg.store( j, ma.block(j) * mb.block(j) ); clobber( mg.data(0) ); } );
+
+
+  //fields: one sweep of the interior, against the scalar loop of Field::relax
+  const int W = 18, C = Vec::Num, N = W * W * W;
+  vector<Vec> prev( N ), x0( N ), xg, xk;
+  for (int i = 0; i < N; ++i){ prev[i] = rand<Vec>(); x0[i] = rand<Vec>(); }
+  auto loop = [&]( vector<Vec>& x ){
+    for (int i = 1; i < W - 1; ++i) for (int j = 1; j < W - 1; ++j) for (int k = 1; k < W - 1; ++k){
+      int ix = ( i * W + j ) * W + k, d = W, h = W * W;
+      Vec nb = x[ix - 1] + x[ix + 1] + x[ix - d] + x[ix + d] + x[ix - h] + x[ix + h];
+      x[ix] = ( prev[ix] + nb * .1 ) * ( 1 / 1.6 );
+    }
+  };
+  double grx = time( [&](){ xg = x0; loop( xg ); clobber( xg.data() ); }, N );
+
+  printf( "{\n  \"selected\": \"%s\",\n  \"results\": [\n", simd::kernels().name );
+
+  //exponentials and logarithms, with zero and half turn arguments mixed in
+  vector<Biv> biv( Len );
+  vector<Dll> dll( Len );
+  vector<Par> par( Len );
+  vector<Rot> rot( Len );
+  vector<Mot> mot( Len );
+  vector<Bst> bst( Len );
+  for (int i = 0; i < Len; ++i){
+    double s = i % 7 ? 4 : 0;
+    biv[i] = rand<Biv>() * s;
+    dll[i] = rand<Dll>() * s;
+    par[i] = rand<Par>() * s;
+    rot[i] = i % 11 ? Gen::rot( biv[i] ) : Rot( -1, 0, 0, 0 );
+    mot[i] = Gen::mot( dll[i] );
+    bst[i] = Gen::bst( par[i] );
+  }
+
+  vector<const double *> ip = in( pnt ), ia = in( ma ), ib = in( mb );
+  vector<double *> op = out( pk ), om = out( mk );
+
+  for (int l = simd::SSE2; l <= simd::supported(); ++l){
+    const simd::Kernels& K = simd::kernels( (simd::Level)l );
+
+    double nsp = time( [&](){ K.spPnt( m.val, ip.data(), op.data(), Len ); clobber( pk.data(0) ); } );
+    entry( K, "Pnt.sp(Mot)", err( pk, pg ), nsp, gsp );
+
+    double ngp = time( [&](){ K.gpMot( ia.data(), ib.data(), om.data(), Len ); clobber( mk.data(0) ); } );
+    entry( K, "Mot * Mot", err( mk, mg ), ngp, ggp );
+
+    for (int a = simd::Fast; a <= simd::Full; ++a){
+      Maps<Rot, Biv>::check( K, a, "Gen::rot", K.rot[a], biv, []( const Biv& b ){ return Gen::rot( b ); } );
+      Maps<Mot, Dll>::check( K, a, "Gen::mot", K.mot[a], dll, []( const Dll& d ){ return Gen::mot( d ); } );
+      Maps<Bst, Par>::check( K, a, "Gen::bst", K.bst[a], par, []( const Par& p ){ return Gen::bst( p ); } );
+      Maps<Biv, Rot>::check( K, a, "Gen::log(Rot)", K.logRot[a], rot, []( const Rot& r ){ return Gen::log( r ); } );
+      Maps<Dll, Mot>::check( K, a, "Gen::log(Mot)", K.logMot[a], mot, []( const Mot& m ){ return Gen::log( m ); } );
+      Maps<Par, Bst>::check( K, a, "Gen::log(Bst)", K.logBst[a], bst, []( const Bst& b ){ return Gen::log( b ); } );
+    }
+
+    //relaxing the rows along k from the last sweep is not the scalar loop's order: compare
+    //against the loop after both converge
+    double nrx = time( [&](){ xk = x0; K.relax( (double*)xk.data(), (const double*)prev.data(), W, W, W, C, .1, 1 / 1.6 ); clobber( xk.data() ); }, N );
+    xg = x0; xk = x0;
+    for (int it = 0; it < 60; ++it){
+      loop( xg );
+      K.relax( (double*)xk.data(), (const double*)prev.data(), W, W, W, C, .1, 1 / 1.6 );
+    }
+    double e = 0;
+    for (int i = 0; i < N; ++i) for (int k = 0; k < C; ++k) e = fmax( e, fabs( xg[i][k] - xk[i][k] ) );
+    entry( K, "Field relax", e, nrx, grx );
+  }
+
+  printf( "\n  ]\n}\n" );
+
+  return 0;
+}
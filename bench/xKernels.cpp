@@ -0,0 +1,118 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  xKernels.cpp
+ *
+ *    Description:  checks and times the SIMD kernels of vsr_cga3D_kernels.h
+ *
+ *                  make bench/xKernels.cpp KERNELS=1   (writes build/bin/xKernels.json)
+ *
+ *                  For each kernel: the largest difference from the instruction list it
+ *                  replaces over random arguments, and ns per call of both.  Gen::mot
+ *                  is checked by Gen::log, which has no kernel.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef VSR_KERNELS
+#error build with make bench/xKernels.cpp KERNELS=1
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include "vsr_cga3D_op.h"
+
+using namespace vsr;
+using namespace vsr::cga3D;
+using namespace std;
+
+namespace bench {
+
+  typedef chrono::steady_clock Clock;
+  typedef CGA<5>::M M;
+
+  static const int Len = 256;
+
+  template<class T>
+  void clobber( const T * p ){ asm volatile( "" : : "g"(p) : "memory" ); }
+
+  /// best ns per element of f() over Len elements
+  template<class F>
+  double time( F f ){
+    double best = 1e30;
+    for (int k = 0; k < 200; ++k){
+      Clock::time_point t = Clock::now();
+      f();
+      double ns = chrono::duration<double, nano>( Clock::now() - t ).count() / Len;
+      if ( ns < best ) best = ns;
+    }
+    return best;
+  }
+
+  double rnd(){ return (double)rand() / RAND_MAX - .5; }
+
+  template<class A>
+  vector<A> rands(){ vector<A> v( Len ); for (auto& a : v) for (int i = 0; i < A::Num; ++i) a[i] = rnd(); return v; }
+
+  template<class A>
+  double err( const vector<A>& a, const vector<A>& b ){
+    double e = 0;
+    for (int k = 0; k < Len; ++k) for (int i = 0; i < A::Num; ++i) e = fmax( e, fabs( a[k][i] - b[k][i] ) );
+    return e;
+  }
+
+  int count = 0;
+
+  void entry( const char * name, double e, double nk, double ng ){
+    printf( "%s    { \"name\": \"%s\", \"error\": %g, \"ns_kernel\": %.3f", count++ ? ",\n" : "", name, e, nk );
+    if ( ng > 0 ) printf( ", \"ns_generic\": %.3f", ng );
+    printf( " }" );
+  }
+
+  /// kernel( a[i], b[i] ) against generic( a[i], b[i] )
+  template<class R, class A, class B, class K, class G>
+  void check( const char * name, K kernel, G generic ){
+    vector<A> a = rands<A>();
+    vector<B> b = rands<B>();
+    vector<R> rk( Len ), rg( Len );
+    double nk = time( [&](){ for (int i = 0; i < Len; ++i) rk[i] = kernel( a[i], b[i] ); clobber( rk.data() ); } );
+    double ng = time( [&](){ for (int i = 0; i < Len; ++i) rg[i] = generic( a[i], b[i] ); clobber( rg.data() ); } );
+    entry( name, err( rk, rg ), nk, ng );
+  }
+
+} // bench::
+
+int main(){
+
+  using namespace bench;
+
+  srand( 1 );
+  printf( "{\n  \"results\": [\n" );
+
+  typedef Prod<Rot, Rot, M, true> RR;
+  check<Rot, Rot, Rot>( "Rot * Rot", []( const Rot& a, const Rot& b ){ return a * b; },
+    []( const Rot& a, const Rot& b ){ return Rot( RR::DO::template Make<RR::Type>( a, b ) ); } );
+
+  typedef Prod<Mot, Mot, M, true> MM;
+  check<Mot, Mot, Mot>( "Mot * Mot", []( const Mot& a, const Mot& b ){ return a * b; },
+    []( const Mot& a, const Mot& b ){ return Mot( MM::DO::template Make<MM::Type>( a, b ) ); } );
+
+  typedef SandwichProd<Dll, Mot, M, true> SD;
+  check<Dll, Dll, Mot>( "Dll.sp(Mot)", []( const Dll& a, const Mot& b ){ return a.sp( b ); },
+    []( const Dll& a, const Mot& b ){ return SandwichPick<SD::UseFused>::sp( SD(), a, b ); } );
+
+  vector<Dll> d = rands<Dll>(), logs( Len );
+  vector<Mot> mots( Len );
+  double nm = time( [&](){ for (int i = 0; i < Len; ++i) mots[i] = Gen::mot( d[i] ); clobber( mots.data() ); } );
+  for (int i = 0; i < Len; ++i) logs[i] = Gen::log( mots[i] );
+  entry( "Gen::mot(Dll)", err( logs, d ), nm, 0 );
+
+  printf( "\n  ]\n}\n" );
+
+  return 0;
+}
@@ -0,0 +1,174 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  xPar.cpp
+ *
+ *    Description:  par:: loops and the algorithms that take a policy, par::seq against par::par
+ *
+ *                  make bench/xPar.cpp          (writes build/bin/xPar.json)
+ *                  xPar [threads] [n]
+ *
+ *                  Each case is run under par::seq and then under par::par on a pool of
+ *                  threads workers (default: one per other core), over n elements
+ *                  (default 1 << 16).  Results must be equal bit for bit; reports the
+ *                  time of each run.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <vector>
+
+#include "vsr_cga3D_op.h"
+#include "vsr_group.h"
+#include "vsr_field.h"
+#include "vsr_knot.h"
+#include "vsr_cga3D_frameTree.h"
+#include "vsr_par.h"
+
+using namespace vsr;
+using namespace vsr::cga3D;
+using namespace std;
+
+namespace bench {
+
+  typedef chrono::steady_clock Clock;
+
+  double val( int i ){ return ( ( i * 7919 ) % 1000 ) / 1000.0 - .5; }
+
+  template<class A>
+  A elem( int i ){ A a; for (int k = 0; k < A::Num; ++k) a[k] = val( i * A::Num + k ); return a; }
+
+  /// sum of all coordinates, weighted by position (differs if any value or order does)
+  template<class A>
+  double sum( const vector<A>& v ){
+    double s = 0;
+    for (size_t i = 0; i < v.size(); ++i)
+      for (int k = 0; k < A::Num; ++k) s += v[i][k] * ( 1 + ( i + k ) % 7 );
+    return s;
+  }
+
+  template<class A>
+  bool same( const vector<A>& a, const vector<A>& b ){
+    if ( a.size() != b.size() ) return false;
+    for (size_t i = 0; i < a.size(); ++i)
+      for (int k = 0; k < A::Num; ++k) if ( a[i][k] != b[i][k] ) return false;
+    return true;
+  }
+
+  int N;
+
+  /// points moved by a motor
+  template<class P>
+  vector<Pnt> transform( const P& p ){
+    vector<Pnt> a( N ), r( N );
+    for (int i = 0; i < N; ++i) a[i] = Ro::null( elem<Vec>( i ) );
+    Mot m = Gen::mot( elem<Dll>( 1 ) );
+    par::transform( p, a.begin(), a.end(), r.begin(), m );
+    return r;
+  }
+
+  /// sum of vectors
+  template<class P>
+  vector<Vec> reduce( const P& p ){
+    vector<Vec> a( N );
+    for (int i = 0; i < N; ++i) a[i] = elem<Vec>( i );
+    return vector<Vec>( 1, par::reduce( p, a.begin(), a.end(), Vec(), std::plus<Vec>() ) );
+  }
+
+  /// points through a wallpaper group (glides) over a 4 x 4 lattice
+  template<class P>
+  vector<Pnt> group( const P& p ){
+    SpaceGroup2D<Vec> sg( 4, 1, true, 1, true );
+    vector<Pnt> a( N / 64 + 1 );
+    for (size_t i = 0; i < a.size(); ++i) a[i] = Ro::null( elem<Vec>( i ) );
+    return sg.apply( p, a, 4, 4 );
+  }
+
+  /// advection of a vector field (diffuse under par::par sweeps red-black, so is not compared)
+  template<class P>
+  vector<Vec> field( const P& p ){
+    Field<Vec> f( 24, 24, 24 ), prev( 24, 24, 24 ), velocity( 24, 24, 24 );
+    for (int i = 0; i < f.num(); ++i){
+      prev.dataPtr()[i] = elem<Vec>( i );
+      velocity.dataPtr()[i] = elem<Vec>( i + 1 );
+    }
+    f.advect( p, prev, velocity, .1, false );
+    return vector<Vec>( f.dataPtr(), f.dataPtr() + f.num() );
+  }
+
+  /// orbit of a torus knot
+  template<class P>
+  vector<Pnt> knot( const P& p ){
+    TorusKnot tk( 3, 2, .001 );
+    tk.calc( p, Ro::null( 1, 0, 0 ) );
+    return tk.pnt;
+  }
+
+  /// world motors of a random tree of N nodes
+  template<class P>
+  vector<Mot> tree( const P& p ){
+    FrameTree t;
+    for (int i = 0; i < N; ++i) t.add( Gen::mot( elem<Dll>( i ) * .1 ), i ? ( i * 7919 ) % 1009 % i : -1 );
+    t.update( p );
+    vector<Mot> r( N );
+    for (int i = 0; i < N; ++i) r[i] = t.world( i );
+    return r;
+  }
+
+  template<class A>
+  struct Case {
+    const char * name;
+    vector<A> (*seq)( const par::Sequential& );
+    vector<A> (*par)( const par::Parallel& );
+  };
+
+  template<class F>
+  double time( F f ){
+    Clock::time_point t = Clock::now();
+    f();
+    return chrono::duration<double, milli>( Clock::now() - t ).count();
+  }
+
+  int bad = 0;
+  bool first = true;
+
+  template<class A>
+  void run( const Case<A>& c, const par::Parallel& p ){
+    vector<A> s, q;
+    double ts = time( [&](){ s = c.seq( par::seq ); } );
+    double tp = time( [&](){ q = c.par( p ); } );
+    bool ok = same( s, q );
+    if ( !ok ) ++bad;
+    printf( "%s    { \"name\": \"%s\", \"seq_ms\": %.2f, \"par_ms\": %.2f, \"sum\": %g, \"same\": %s }",
+            first ? "" : ",\n", c.name, ts, tp, sum( q ), ok ? "true" : "false" );
+    first = false;
+  }
+
+} // bench::
+
+int main( int argc, char ** argv ){
+
+  using namespace bench;
+
+  int threads = argc > 1 ? atoi( argv[1] ) : thread::hardware_concurrency() - 1;
+  N = argc > 2 ? atoi( argv[2] ) : 1 << 16;
+
+  par::Pool pool( threads );
+  par::Parallel p = { 0, &pool };
+
+  printf( "{\n  \"threads\": %d,\n  \"n\": %d,\n  \"results\": [\n", pool.size(), N );
+  run( Case<Pnt>{ "transform", transform<par::Sequential>, transform<par::Parallel> }, p );
+  run( Case<Vec>{ "reduce", reduce<par::Sequential>, reduce<par::Parallel> }, p );
+  run( Case<Pnt>{ "SpaceGroup2D", group<par::Sequential>, group<par::Parallel> }, p );
+  run( Case<Vec>{ "Field", field<par::Sequential>, field<par::Parallel> }, p );
+  run( Case<Pnt>{ "TorusKnot", knot<par::Sequential>, knot<par::Parallel> }, p );
+  run( Case<Mot>{ "FrameTree", tree<par::Sequential>, tree<par::Parallel> }, p );
+  printf( "\n  ]\n}\n" );
+
+  return bad ? 1 : 0;
+}
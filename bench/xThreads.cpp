@@ -0,0 +1,151 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  xThreads.cpp
+ *
+ *    Description:  Field, Chain, ConvexHull, Root and Rand workloads on many threads at once
+ *
+ *                  make bench/xThreads.cpp          (writes build/bin/xThreads.json)
+ *                  xThreads [threads] [rounds]
+ *
+ *                  Each workload is first run alone on the main thread.  Then every
+ *                  thread (default: one per core) repeats all of them, on its own
+ *                  objects, rounds times (default 20), and each result must equal the
+ *                  one computed alone, bit for bit.  Any hidden shared state in the
+ *                  library shows up as mismatches (or as crashes under
+ *                  USRFLAGS=-fsanitize=thread).
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <vector>
+
+#include "vsr_cga3D_op.h"
+#include "vsr_cga3D_frame.h"
+#include "vsr_chain.h"
+#include "vsr_field.h"
+#include "vsr_hull.h"
+#include "vsr_root.h"
+#include "vsr_stat.h"
+
+using namespace vsr;
+using namespace vsr::cga3D;
+using namespace std;
+
+namespace bench {
+
+  typedef chrono::steady_clock Clock;
+
+  /// deterministic values in -.5 ... .5 (no generator shared between threads)
+  double val( int i ){ return ( ( i * 7919 ) % 1000 ) / 1000.0 - .5; }
+
+  template<class A>
+  A elem( int i ){ A a; for (int k = 0; k < A::Num; ++k) a[k] = val( i * A::Num + k ); return a; }
+
+  /// Diffusion and advection of a vector field (relaxed through simd::kernels())
+  double field(){
+    Field<Vec> f( 12, 12, 12 ), prev( 12, 12, 12 ), velocity( 12, 12, 12 );
+    for (int i = 0; i < f.num(); ++i){
+      prev.dataPtr()[i] = elem<Vec>( i );
+      velocity.dataPtr()[i] = elem<Vec>( i + 1 );
+    }
+    f.diffuse( prev, .1, false, false );
+    f.advect( prev, velocity, .1, false );
+    f.diffuse( prev, .1, true, true );
+    double s = 0;
+    for (int i = 0; i < f.num(); ++i) s += f.dataPtr()[i][0] + f.dataPtr()[i][1] + f.dataPtr()[i][2];
+    return s;
+  }
+
+  /// Forward kinematics, then fabrik and its inverse towards a target
+  double chain(){
+    Chain c( 6 );
+    for (int i = 0; i < c.num(); ++i) c.joint(i).rot() = Gen::rot( elem<Biv>( i ) * .2 );
+    c.fk();
+    c.fabrik( Ro::null( 1, 2, 1 ), c.num() - 1, 0 );
+    c.ifabrik( Ro::null( -1, 1, .5 ), 0, c.num() - 1 );
+    double s = 0;
+    for (int i = 0; i < c.num(); ++i){ Vec v = c[i].vec(); s += v[0] + v[1] + v[2]; }
+    return s;
+  }
+
+  /// Hull of a fixed cloud: number of faces and their first vertices
+  double hull(){
+    vector<NEVec<3>> cloud( 128 );
+    for (size_t i = 0; i < cloud.size(); ++i) cloud[i] = NEVec<3>( val( 3*i ), val( 3*i + 1 ), val( 3*i + 2 ) );
+    ConvexHull<3> h;
+    h.calc( cloud );
+    double s = h.graph.face().size();
+    for (auto f : h.graph.face()) s += f->a()[0] + f->a()[1] + f->a()[2];
+    return s;
+  }
+
+  /// Root system of F4
+  double root(){
+    typedef NEVec<4> V4;
+    vector<V4> r = Root::System( V4(0,1,-1,0), V4(1,-1,0,0), V4(0,0,1,0), V4(-1,-1,-1,1) * .5 );
+    double s = r.size();
+    for (auto& v : r) s += v[0] * 1 + v[1] * 2 + v[2] * 3 + v[3] * 4;
+    return s;
+  }
+
+  /// Same seed, same sequence, whatever other threads draw
+  double rnd(){
+    Rand::Seed( 7 );
+    double s = 0;
+    for (int i = 0; i < 1000; ++i) s += Rand::Num() + Rand::Int( 10 );
+    return s;
+  }
+
+  typedef double (*Work)();
+  const Work work[] = { field, chain, hull, root, rnd };
+  const char * const name[] = { "Field", "Chain", "ConvexHull", "Root", "Rand" };
+  const int NumWork = sizeof( work ) / sizeof( Work );
+
+} // bench::
+
+int main( int argc, char ** argv ){
+
+  using namespace bench;
+
+  int threads = argc > 1 ? atoi( argv[1] ) : thread::hardware_concurrency();
+  int rounds = argc > 2 ? atoi( argv[2] ) : 20;
+  if ( threads < 2 ) threads = 2;
+
+  double alone[ NumWork ];
+  for (int w = 0; w < NumWork; ++w) alone[w] = work[w]();
+
+  atomic<int> mismatch[ NumWork ];
+  for (int w = 0; w < NumWork; ++w) mismatch[w] = 0;
+
+  Clock::time_point t = Clock::now();
+  vector<thread> pool;
+  for (int k = 0; k < threads; ++k){
+    pool.push_back( thread( [&, k](){
+      for (int r = 0; r < rounds; ++r)
+        for (int i = 0; i < NumWork; ++i){
+          int w = ( i + k ) % NumWork;   //threads start on different workloads
+          if ( work[w]() != alone[w] ) ++mismatch[w];
+        }
+    }));
+  }
+  for (auto& p : pool) p.join();
+  double ms = chrono::duration<double, milli>( Clock::now() - t ).count();
+
+  int bad = 0;
+  printf( "{\n  \"threads\": %d,\n  \"rounds\": %d,\n  \"ms\": %.1f,\n  \"results\": [\n", threads, rounds, ms );
+  for (int w = 0; w < NumWork; ++w){
+    printf( "    { \"name\": \"%s\", \"runs\": %d, \"mismatches\": %d }%s\n", name[w], threads * rounds, (int)mismatch[w], w < NumWork - 1 ? "," : "" );
+    bad += mismatch[w];
+  }
+  printf( "  ]\n}\n" );
+
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,54 @@
+#include <cassert>
+
+#include "vsr_generic_op.h"
+
+/*
+ * Conformal model of 5D euclidean space (CGA<7>, 128 blades).  The product tables
+ * are generated by constexpr functions (vsr_cayley.h), so this builds in seconds.
+ * Each result is checked (assert) against what it must be, then printed.
+ */
+
+using namespace vsr;
+
+/// a and b agree in every coefficient
+template<class A>
+bool near( const A& a, const A& b, VT eps = 1e-12 ){
+  for (int i = 0; i < A::Num; ++i) if ( fabs( a[i] - b[i] ) > eps ) return false;
+  return true;
+}
+
+int main(){
+
+  NPnt<7> pa = Ro::point(1,0,0,0,0);
+  NPnt<7> pb = Ro::point(0,1,0,0,0);
+  NPnt<7> pc = Ro::point(0,0,1,0,0);
+
+  //circle through three points: each lies on it
+  auto cir = pa ^ pb ^ pc;
+  assert( near( pa ^ cir, decltype( pa ^ cir )() ) );
+  assert( near( pb ^ cir, decltype( pb ^ cir )() ) );
+  assert( near( pc ^ cir, decltype( pc ^ cir )() ) );
+  cir.print();
+
+  //rotor in the e1 e4 plane: unit, and turns pa about the origin within that plane
+  auto rot = Gen::rot( NVec<7>(1,0,0,0,0) ^ NVec<7>(0,0,0,.5,0) );
+  assert( fabs( rot.rwt() - 1 ) < 1e-12 );
+  rot.print();
+
+  NPnt<7> ra = pa.sp(rot);
+  assert( near( ra, pa.sp0(rot) ) );
+  assert( near( ra, Ro::point( ra[0], 0, 0, ra[3], 0 ) ) );
+  assert( fabs( ra[0] * ra[0] + ra[3] * ra[3] - 1 ) < 1e-12 );
+  ra.print();
+
+  //translator along e5
+  NTrs<7> trs = Gen::trs(0,0,0,0,2);
+  NPnt<7> ta = pa.sp(trs);
+  assert( near( ta, Ro::point(1,0,0,0,2) ) );
+  ta.print();
+
+  //the circle moves with its points
+  assert( near( cir.sp(trs), pa.sp(trs) ^ pb.sp(trs) ^ pc.sp(trs) ) );
+
+  return 0;
+}
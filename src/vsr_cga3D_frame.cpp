@@ -20,34 +20,45 @@
 namespace vsr{
 
     Frame::Frame() 
-    : mPos( Ro::null(0,0,0) ), mRot(1,0,0,0), mScale(1), aBiv(.9), aVec(.9) {}
+    : mPos( Ro::null(0,0,0) ), mRot(1,0,0,0), mScale(1), aBiv(.9), aVec(.9), mValid(0) {}
     
     Frame::Frame(VT _x, VT _y, VT _z) 
-    : mPos( Ro::null(_x,_y,_z) ), mRot(1,0,0,0), mScale(1),  aBiv(.9), aVec(.9) {}
+    : mPos( Ro::null(_x,_y,_z) ), mRot(1,0,0,0), mScale(1),  aBiv(.9), aVec(.9), mValid(0) {}
 
     Frame::Frame(const Vec& v, const Rotor& r, VT s ) 
-    : mPos( v.null() ), mRot( r ), mScale(s), aBiv(.9), aVec(.9) {} 
+    : mPos( v.null() ), mRot( r ), mScale(s), aBiv(.9), aVec(.9), mValid(0) {} 
 
     Frame::Frame(const Point& p, const Rotor& r, VT s ) 
-    : mPos( p ), mRot( r ), mScale(s), aBiv(.9), aVec(.9) {} 
+    : mPos( p ), mRot( r ), mScale(s), aBiv(.9), aVec(.9), mValid(0) {} 
 
     Frame::Frame(const DualLine& d)
-    : mScale(1),  aBiv(.9), aVec(.9) 
+    : mScale(1),  aBiv(.9), aVec(.9), mValid(0) 
     {
-      Motor m = Gen::mot( d );
-      mPos = PAO.sp(m);
-      mRot = m;
+      mot( Gen::mot( d ) );
     }  
 
-     Frame::Frame(const Motor& m ) : mPos( PAO.sp(m) ), mRot(m), mScale(1), aBiv(.9), aVec(.9) {} 
+     Frame::Frame(const Motor& m ) : mScale(1), aBiv(.9), aVec(.9), mValid(0) { mot( m ); } 
+
+    /// Fill every cached value now
+    const Frame& Frame::update() const {
+      mot(); dlx(); image(); mat();
+      return *this;
+    }
 
     
     /*-----------------------------------------------------------------------------
-     *  Local X, Y, Z axes (calculated every time, could be stored into 3x3 image)
+     *  Local X, Y, Z axes (calculated together on first use after the rotor changes)
      *-----------------------------------------------------------------------------*/
-    Vec Frame::x()  const { return Vec::x.sp( mRot ); }
-    Vec Frame::y()  const { return Vec::y.sp( mRot ); }
-    Vec Frame::z()  const { return Vec::z.sp( mRot ); }   
+    Vec Frame::x()  const { if ( !( mValid & AXES ) ) axes(); return mAxis[0]; }
+    Vec Frame::y()  const { if ( !( mValid & AXES ) ) axes(); return mAxis[1]; }
+    Vec Frame::z()  const { if ( !( mValid & AXES ) ) axes(); return mAxis[2]; }   
+
+    void Frame::axes() const {
+      mAxis[0] = Vec::x.sp( mRot );
+      mAxis[1] = Vec::y.sp( mRot );
+      mAxis[2] = Vec::z.sp( mRot );
+      mValid |= AXES;
+    }
 
     /* Local Euclidean Planes (at origin) -- for homogenous planes see dxy(), dxz() etc */
     Biv Frame::xy()  const { return x() ^ y(); }    ///< xz euclidean bivector
@@ -59,10 +70,28 @@ namespace vsr{
     Lin Frame::ly() const { return mPos ^ y() ^ Inf(1); }  ///< y direction direct line
     Lin Frame::lz() const { return mPos ^ z() ^ Inf(1); }  ///< z direction direct line      
     
-    /* Dual Lines along Axes */
-    Dll Frame::dlx() const { return lx().dual(); }    ///< x direction dual line
-    Dll Frame::dly() const { return ly().dual(); }    ///< y direction dual line
-    Dll Frame::dlz() const { return lz().dual(); }    ///< z direction dual line
+    /* Dual Lines along Axes (calculated together) */
+    Dll Frame::dlx() const { if ( !( mValid & LINES ) ) lines(); return mLine[0]; }    ///< x direction dual line
+    Dll Frame::dly() const { if ( !( mValid & LINES ) ) lines(); return mLine[1]; }    ///< y direction dual line
+    Dll Frame::dlz() const { if ( !( mValid & LINES ) ) lines(); return mLine[2]; }    ///< z direction dual line
+
+    void Frame::lines() const {
+      mLine[0] = lx().dual();
+      mLine[1] = ly().dual();
+      mLine[2] = lz().dual();
+      mValid |= LINES;
+    }
+
+    /* Matrices */
+    gfx::Mat4f Frame::image() const {
+      if ( !( mValid & IMAGE ) ){ mImage = Xf::mat( mRot ); mValid |= IMAGE; }
+      return mImage;
+    }
+
+    gfx::Mat4f Frame::mat() const {
+      if ( !( mValid & MAT ) ){ mMat = Xf::mat( mRot, vec(), mScale ); mValid |= MAT; }
+      return mMat;
+    }
     
     /* Homogenous Planes */
     Dlp Frame::dxz() const  { return -z() <= dlx(); }    ///< xz dual plane
@@ -94,10 +123,13 @@ namespace vsr{
     Cir Frame::icxz() const { return Ro::round( bound(), xz() ); }     ///< xz circle (imaginary, direct)
     Cir Frame::icyz() const { return Ro::round( bound(), yz() ); }     ///< yz circle (imaginary, direct)
  
-    /// Set position and orientation by motor 
+    /// Set position and orientation by motor, and keep it (normalized) as mot()
     void Frame::mot(const Mot& m) { 
           mPos = PAO.sp(m); 
           mRot = m; 
+          VT n = m.rnorm();
+          mMot = (n != 0) ? m / n : m;
+          mValid = MOT;
       } 
 
     /// Generate Translation versor based on Position
@@ -105,9 +137,13 @@ namespace vsr{
           
     /// Get Absolute Motor Relative to Origin 
      Mot Frame::mot() const { 
-      Mot m(trs() * rot()); 
-      VT n = m.rnorm();
-      return (n !=0 ) ? m / n : m ; 
+      if ( !( mValid & MOT ) ){
+        Mot m(trs() * rot()); 
+        VT n = m.rnorm();
+        mMot = (n !=0 ) ? m / n : m ; 
+        mValid |= MOT;
+      }
+      return mMot;
     }  
 
     /// Get Absolute Motor Relative to Origin 
@@ -130,6 +166,7 @@ namespace vsr{
     Frame& Frame::dilate(double t) { 
       Dls s =  bound().dil( bound(), t ) ;
       mScale = Ro::rad(s);
+      mValid &= ~MAT;
       return *this;
     }
 
@@ -137,6 +174,7 @@ namespace vsr{
     Frame& Frame::dilate(const Pnt& p, double t) { 
       Dls s =  bound().dil( p, t ) ;
       mScale = Ro::rad(s);
+      mValid &= ~MAT;
       return *this;
     }
 
@@ -151,6 +189,7 @@ namespace vsr{
     Frame&  Frame::move() {
       mPos = (mPos + dVec).null();//.sp( Gen::trs(dVec) );
       dVec *= aVec; 
+      moved();
       return *this;
     }
     
@@ -158,6 +197,7 @@ namespace vsr{
     Frame&  Frame::spin() {      
       mRot = Gen::rot(dBiv) * mRot;
       dBiv *= aBiv;
+      touch();
       return *this; 
     }
 
@@ -175,6 +215,7 @@ namespace vsr{
     /// Move by dx, dy, dz and return this
     Frame& Frame::move( VT dx, VT dy, VT dz) {
       mPos = (mPos + Vec(dx,dy,dz) ).null();     
+      moved();
       return *this; 
     }
 
@@ -187,6 +228,7 @@ namespace vsr{
     Frame& Frame::twist( const Mot& mot ){
       mPos = mPos.spin(mot);
       mRot = mRot.spin(mot);
+      touch();
       return *this;
     }
 
@@ -200,6 +242,7 @@ namespace vsr{
       mPos = Ro::loc( mPos.spin(b) );
       mRot = mRot.spin(b);
       mRot = mRot.unit();
+      touch();
       return *this;
     }
 
@@ -208,21 +251,31 @@ namespace vsr{
       //Vec current = z();
       Rot tRot = Gen::ratio( -Vec::z, (v-vec()).unit() );
       mRot = tRot;
+      touch();
       Vec ty = Op::pj( Vec::y, xy() ).unit();
       //auto cs = ty <= y();
       Rot yRot = Gen::ratio( y(), ty );
       mRot = yRot * tRot; 
+      touch();
       return *this;
     }
 
+    /// Copy moved by v: a null point shifted by v rather than a translator, axes kept
+    Frame Frame::moveBy( const Vec& v ) const{
+      Frame f( *this );
+      f.mPos = ( mPos + v ).null();
+      f.moved();
+      return f;
+    }
+
     Frame Frame::moveX( VT amt ) const{
-      return Frame( mPos.trs( x() * amt) , mRot, mScale );
+      return moveBy( x() * amt );
     }
     Frame Frame::moveY( VT amt ) const {
-      return Frame( mPos.trs( y() * amt) , mRot, mScale );
+      return moveBy( y() * amt );
     }
     Frame Frame::moveZ( VT amt ) const{
-      return Frame( mPos.trs( z() * amt) , mRot, mScale );
+      return moveBy( z() * amt );
     }
 
 }
@@ -190,6 +190,9 @@ namespace Gen{
    */  
    Mot mot( const Dll& dll){
 
+#ifdef VSR_KERNELS
+      return kernel::mot<Mot>( dll );
+#else
       Dll b = dll;
       Biv B(b[0],b[1],b[2]); //Biv B(dll);  
 
@@ -216,6 +219,7 @@ namespace Gen{
       auto ts = B*tw;        //Vec_Biv
 
       return Mot(cc, B[0] * sc, B[1] * sc, B[2] * sc, tt[0], tt[1], tt[2], ts[3] * sc);
+#endif
   }
 
     /*! Dual Line Generator from a Motor 
@@ -0,0 +1,82 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_simd.cpp
+ *
+ *    Description:  picks the kernels of vsr_dispatch.h for the cpu at hand
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <atomic>
+
+#include "vsr_dispatch.h"
+
+namespace vsr {
+
+namespace simd {
+
+  //one table per build of vsr_simd_kernels.cpp
+  namespace sse2 { extern const Kernels table; }
+#if defined(__x86_64__) || defined(__i386__)
+  namespace avx2 { extern const Kernels table; }
+  namespace avx512 { extern const Kernels table; }
+#endif
+
+  Level supported(){
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();  //in case this runs before static constructors have
+    static const Level best =
+      __builtin_cpu_supports( "avx512f" ) ? AVX512 :
+      __builtin_cpu_supports( "avx2" ) && __builtin_cpu_supports( "fma" ) ? AVX2 : SSE2;
+    return best;
+#else
+    return SSE2;
+#endif
+  }
+
+  const Kernels& kernels( Level l ){
+    switch( l ){
+#if defined(__x86_64__) || defined(__i386__)
+      case AVX512: return avx512::table;
+      case AVX2: return avx2::table;
+#endif
+      default: return sse2::table;
+    }
+  }
+
+  namespace {
+
+    /// level asked for by VSR_SIMD, or the widest
+    Level env(){
+      const char * s = getenv( "VSR_SIMD" );
+      if ( s ){
+        if ( !strcmp( s, "sse2" ) ) return SSE2;
+        if ( !strcmp( s, "avx2" ) ) return AVX2;
+      }
+      return AVX512;
+    }
+
+    //select() may run while other threads read the table
+    std::atomic<const Kernels *>& current(){
+      static std::atomic<const Kernels *> k( &kernels( env() < supported() ? env() : supported() ) );
+      return k;
+    }
+
+  }
+
+  const Kernels& kernels(){ return *current(); }
+
+  Level select( Level l ){
+    const Kernels * k = &kernels( l < supported() ? l : supported() );
+    current() = k;
+    return k->level;
+  }
+
+} // simd::
+
+} //vsr::
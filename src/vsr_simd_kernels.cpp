@@ -0,0 +1,408 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_simd_kernels.cpp
+ *
+ *    Description:  the kernels of vsr_dispatch.h, built once per instruction set
+ *
+ *                  The Makefile compiles this file as vsr_simd_sse2.o, vsr_simd_avx2.o
+ *                  and vsr_simd_avx512.o with -DVSR_SIMD_ISA=<name> and that set's -m
+ *                  flags, each defining vsr::simd::<name>::table.
+ *
+ *                  Every function the linker could merge with one built elsewhere
+ *                  (inline functions and templates with external linkage) would let
+ *                  AVX-512 code leak into programs run on older cpus.  So products
+ *                  only ever run on the pack type P below, which is in an unnamed
+ *                  namespace and so gives every instantiation it appears in internal
+ *                  linkage, and double data only moves through raw pointers and
+ *                  library calls (malloc, memcpy).
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef VSR_SIMD_ISA
+#error build through the Makefile (vsr_simd_sse2.o, vsr_simd_avx2.o, vsr_simd_avx512.o)
+#endif
+
+#define VSR_SIMD_STR_(x) #x
+#define VSR_SIMD_STR(x) VSR_SIMD_STR_(x)
+
+#undef VSR_KERNELS  //the kernels of vsr_cga3D_kernels.h are specializations on double
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "vsr_simd.h"
+#include "vsr_products.h"
+#include "vsr_dispatch.h"
+
+namespace vsr {
+
+namespace simd {
+
+namespace VSR_SIMD_ISA {
+
+namespace {
+
+  static const int W = VSR_SIMD_BYTES / sizeof(double);
+
+  /// W doubles, the same interface as Lanes<double>
+  struct P {
+
+    typedef double VT;
+    static const int Width = W;
+
+    typedef double Vec __attribute__(( vector_size( VSR_SIMD_BYTES ) ));
+    Vec val;
+
+    P() = default;
+    P( double s ){ for (int i = 0; i < W; ++i) val[i] = s; }
+
+    /// m < W doubles, zero filled
+    static P load( const double * p, size_t m = W ){ P r( 0.0 ); memcpy( &r.val, p, m * sizeof(double) ); return r; }
+    void store( double * p, size_t m = W ) const { memcpy( p, &val, m * sizeof(double) ); }
+
+    double operator[] (int i) const { return val[i]; }
+    double& operator[] (int i) { return val[i]; }
+
+    P operator - () const { P r; r.val = -val; return r; }
+
+    P& operator += (const P& b){ val += b.val; return *this; }
+    P& operator -= (const P& b){ val -= b.val; return *this; }
+    P& operator *= (const P& b){ val *= b.val; return *this; }
+    P& operator /= (const P& b){ val /= b.val; return *this; }
+
+    friend P operator + (P a, const P& b){ return a += b; }
+    friend P operator - (P a, const P& b){ return a -= b; }
+    friend P operator * (P a, const P& b){ return a *= b; }
+    friend P operator / (P a, const P& b){ return a /= b; }
+  };
+
+  typedef CGA<5>::M M;
+  typedef CGAMV<5, Rebind<CGA<5>::Pnt, P>::Type> Pnt;
+  typedef CGAMV<5, Rebind<CGA<5>::Mot, P>::Type> Mot;
+  typedef CGAMV<5, Rebind<CGA<5>::Dll, P>::Type> Dll;
+  typedef CGAMV<5, Rebind<CGA<5>::Biv, P>::Type> Biv;
+  typedef CGAMV<5, Rebind<CGA<5>::Rot, P>::Type> Rot;
+  typedef CGAMV<5, Rebind<CGA<5>::Par, P>::Type> Par;
+  typedef CGAMV<5, Rebind<CGA<5>::Bst, P>::Type> Bst;
+  typedef CGAMV<5, Rebind<CGA<5>::Drv, P>::Type> Drv;
+  typedef CGAMV<5, Rebind<CGA<5>::Drt, P>::Type> Drt;
+  typedef CGAMV<5, Rebind<CGA<5>::Ori, P>::Type> Ori;
+  typedef CGAMV<5, Rebind<CGA<5>::Inf, P>::Type> Inf;
+
+  template<class A>
+  A scale( A a, const P& f ){ for (int k = 0; k < A::Num; ++k) a[k] *= f; return a; }
+
+  /*-----------------------------------------------------------------------------
+   *  LANE-WISE MATH: masks and selects in place of branches, and series in place
+   *  of libm, their length set by Accuracy (see the error bounds beside each one)
+   *-----------------------------------------------------------------------------*/
+  typedef long long Mask __attribute__(( vector_size( VSR_SIMD_BYTES ) ));
+
+  Mask bits( const P& a ){ return (Mask)a.val; }
+  P real( const Mask& m ){ P r; r.val = (P::Vec)m; return r; }
+
+  Mask operator < ( const P& a, const P& b ){ return a.val < b.val; }
+  Mask operator > ( const P& a, const P& b ){ return a.val > b.val; }
+  Mask operator == ( const P& a, const P& b ){ return a.val == b.val; }
+
+  /// m ? a : b in each lane
+  P sel( const Mask& m, const P& a, const P& b ){ return real( ( m & bits(a) ) | ( ~m & bits(b) ) ); }
+
+  P vabs( const P& a ){ return sel( a < 0.0, -a, a ); }
+  P vmax( const P& a, const P& b ){ return sel( a > b, a, b ); }
+  P vmin( const P& a, const P& b ){ return sel( a < b, a, b ); }
+
+  /// one vector square root (this file is built with -fno-math-errno)
+  P vsqrt( const P& a ){ P r; for (int l = 0; l < W; ++l) r[l] = __builtin_sqrt( a[l] ); return r; }
+
+  const double Big = 6755399441055744.0;          // 1.5 2^52: ( x + Big ) - Big rounds x
+
+  P vround( const P& x ){ return ( x + Big ) - Big; }
+  /// integral k (|k| < 2^51) to and from 64 bit integers
+  Mask vint( const P& k ){ return bits( k + Big ) - bits( P( Big ) ); }
+  P vreal( const Mask& i ){ return real( i + bits( P( Big ) ) ) - Big; }
+
+  const double Pi = 3.14159265358979323846, PiO2 = 1.57079632679489661923, PiO4 = .78539816339744830962;
+  const double PiO2_1 = 1.57079632673412561417e+00;   // pi/2 in three parts of 33 bits (fdlibm)
+  const double PiO2_2 = 6.07710050630396597660e-11;
+  const double PiO2_3 = 2.02226624871116645580e-21;
+  const double Ln2Hi = 6.93147180369123816490e-01, Ln2Lo = 1.90821492927058770002e-10;
+
+  constexpr int terms( int acc, int fast, int single, int full ){ return acc == Fast ? fast : acc == Single ? single : full; }
+
+  constexpr double fact( int n ){ return n < 2 ? 1 : n * fact( n - 1 ); }
+  constexpr double pow4( int n ){ return n < 1 ? 1 : 4 * pow4( n - 1 ); }
+  constexpr double sgn( int n ){ return n % 2 ? -1 : 1; }
+
+  /// sum of c[k] z^k for k < N
+  template<int N>
+  P series( const P& z, const double * c ){ P r( c[N - 1] ); for (int k = N - 2; k >= 0; --k) r = r * z + c[k]; return r; }
+
+  //Taylor coefficients, each series in its own variable
+  constexpr double SinC[] = { 1, -1 / fact(3), 1 / fact(5), -1 / fact(7), 1 / fact(9), -1 / fact(11), 1 / fact(13), -1 / fact(15) };
+  constexpr double CosC[] = { 1, -1 / fact(2), 1 / fact(4), -1 / fact(6), 1 / fact(8), -1 / fact(10), 1 / fact(12), -1 / fact(14), 1 / fact(16) };
+  constexpr double ExpC[] = { 1, 1, 1 / fact(2), 1 / fact(3), 1 / fact(4), 1 / fact(5), 1 / fact(6), 1 / fact(7),
+                              1 / fact(8), 1 / fact(9), 1 / fact(10), 1 / fact(11), 1 / fact(12), 1 / fact(13) };
+  constexpr double SinhcC[] = { 1, 1 / fact(3), 1 / fact(5), 1 / fact(7), 1 / fact(9), 1 / fact(11), 1 / fact(13) };
+  constexpr double AtanhC[] = { 1, 1 / 3., 1 / 5., 1 / 7., 1 / 9., 1 / 11., 1 / 13., 1 / 15., 1 / 17., 1 / 19. };
+  constexpr double AtanC[] = { 1, -1 / 3., 1 / 5., -1 / 7., 1 / 9., -1 / 11., 1 / 13., -1 / 15., 1 / 17., -1 / 19., 1 / 21. };
+  #define VSR_ASINHC(k) sgn(k) * fact( 2 * k ) / ( pow4(k) * fact(k) * fact(k) * ( 2 * k + 1 ) )
+  constexpr double AsinhcC[] = { 1, VSR_ASINHC(1), VSR_ASINHC(2), VSR_ASINHC(3), VSR_ASINHC(4), VSR_ASINHC(5), VSR_ASINHC(6), VSR_ASINHC(7) };
+  #undef VSR_ASINHC
+
+  /// sin and cos of x = k pi/2 + r, |r| <= pi/4 (next terms 4e-5, 2e-9, 5e-17), |x| < 2^20
+  template<int A>
+  void vsincos( const P& x, P& s, P& c ){
+    P k = vround( x * ( 1 / PiO2 ) );
+    P r = ( ( x - k * PiO2_1 ) - k * PiO2_2 ) - k * PiO2_3;
+    P z = r * r;
+    P sr = r * series< terms(A, 3, 5, 8) >( z, SinC );
+    P cr = series< terms(A, 4, 6, 9) >( z, CosC );
+    P q = k - 4.0 * vround( k * .25 - .375 );          // k mod 4
+    Mask odd = ( q - 2.0 * vround( q * .5 - .25 ) ) == 1.0;
+    s = sel( odd, cr, sr );
+    s = sel( q > 1.5, -s, s );
+    c = sel( odd, sr, cr );
+    c = sel( vabs( q - 1.5 ) < 1.0, -c, c );
+  }
+
+  /// e^x = 2^k e^r, |r| <= ln2 / 2 (next terms 2e-6, 2e-9, 4e-18), x clamped to +-708
+  template<int A>
+  P vexp( const P& x ){
+    P t = vmin( vmax( x, -708.0 ), 708.0 );
+    P k = vround( t * 1.44269504088896340736 );
+    P r = ( t - k * Ln2Hi ) - k * Ln2Lo;
+    return series< terms(A, 6, 9, 14) >( r, ExpC ) * real( ( vint( k ) + 1023 ) << 52 );
+  }
+
+  /// log x for normal x > 0: x = 2^e m, m in [sqrt(1/2), sqrt 2), log m = 2 atanh z (next terms 4e-6, 2e-9, 2e-17)
+  template<int A>
+  P vlog( const P& x ){
+    Mask b = bits( x );
+    P e = vreal( ( b >> 52 ) - 1023 );
+    P m = real( ( b & 0x000fffffffffffffLL ) | 0x3ff0000000000000LL );
+    Mask big = m > 1.41421356237309504880;
+    m = sel( big, m * .5, m );
+    e = sel( big, e + 1.0, e );
+    P z = ( m - 1.0 ) / ( m + 1.0 );
+    return e * Ln2Hi + ( 2.0 * z * series< terms(A, 3, 5, 10) >( z * z, AtanhC ) + e * Ln2Lo );
+  }
+
+  /// atan of a in [0,1]: less pi/4 past tan(pi/8), then halved to below tan(pi/16) (next terms 9e-6, 9e-9, 2e-17)
+  template<int A>
+  P vatan01( const P& a ){
+    Mask big = a > .41421356237309504880;
+    P t = sel( big, ( a - 1.0 ) / ( a + 1.0 ), a );
+    P h = t / ( 1.0 + vsqrt( 1.0 + t * t ) );
+    return sel( big, PiO4, 0.0 ) + 2.0 * h * series< terms(A, 3, 5, 11) >( h * h, AtanC );
+  }
+
+  /// atan2( y, x ), 0 at the origin
+  template<int A>
+  P vatan2( const P& y, const P& x ){
+    P ay = vabs( y ), ax = vabs( x );
+    P hi = vmax( ay, ax );
+    P r = vatan01<A>( vmin( ay, ax ) / sel( hi > 0.0, hi, 1.0 ) );
+    r = sel( ay > ax, PiO2 - r, r );
+    r = sel( x < 0.0, Pi - r, r );
+    return sel( y < 0.0, -r, r );
+  }
+
+  /// sinh(a)/a and cosh(a) for a >= 0 (series below 1/2: next terms 3e-6, 1e-8, 5e-17)
+  template<int A>
+  void vsinhc( const P& a, P& sc, P& ch ){
+    P e = vexp<A>( a ), ei = 1.0 / e;
+    ch = ( e + ei ) * .5;
+    sc = sel( a < .5, series< terms(A, 3, 4, 7) >( a * a, SinhcC ), ( e - ei ) / ( 2.0 * a ) );
+  }
+
+  /// asinh(a)/a for a >= 0 (series below 1/8: next terms 2e-5, 2e-9, 4e-17)
+  template<int A>
+  P vasinhc( const P& a ){
+    P l = vlog<A>( a + vsqrt( a * a + 1.0 ) ) / a;
+    return sel( a < .125, series< terms(A, 2, 4, 8) >( a * a, AsinhcC ), l );
+  }
+
+  /// sin(a)/a, 1 at 0
+  P vsinc( const P& s, const P& a ){ return sel( a > 0.0, s / a, 1.0 ); }
+
+  /// block of arrays a (from element i, m of them) into an A
+  template<class A>
+  A load( const double * const * a, size_t i, size_t m ){
+    A r;
+    for (int k = 0; k < A::Num; ++k) r[k] = P::load( a[k] + i, m );
+    return r;
+  }
+
+  template<class A>
+  void store( const A& r, double * const * a, size_t i, size_t m ){
+    for (int k = 0; k < A::Num; ++k) r[k].store( a[k] + i, m );
+  }
+
+  //kernels are flattened so that f below inlines into both of its calls, the full block one
+  //with m = W constant (an aligned-size memcpy is one vector load or store)
+  #define VSR_KERNEL __attribute__(( flatten ))
+
+  /// f( i, m ) over blocks of W from 0 to n, the last one m = n - i long
+  template<class F>
+  void blocks( size_t n, F f ){
+    size_t i = 0;
+    for (; i + W <= n; i += W) f( i, (size_t)W );
+    if ( i < n ) f( i, n - i );
+  }
+
+  VSR_KERNEL void spPnt( const double * m, const double * const * in, double * const * out, size_t n ){
+    Mot tm;
+    for (int k = 0; k < Mot::Num; ++k) tm[k] = m[k];
+    SandwichProd<Pnt, Mot, M, true> s;
+    blocks( n, [&]( size_t i, size_t w ){ store( s.fused( load<Pnt>( in, i, w ), tm ), out, i, w ); } );
+  }
+
+  VSR_KERNEL void gpMot( const double * const * a, const double * const * b, double * const * r, size_t n ){
+    blocks( n, [&]( size_t i, size_t w ){ store( Mot( load<Mot>( a, i, w ) * load<Mot>( b, i, w ) ), r, i, w ); } );
+  }
+
+  /*-----------------------------------------------------------------------------
+   *  EXPONENTIALS AND LOGARITHMS: the formulas of Gen:: (vsr_generic_op.h and
+   *  vsr_cga3D_op.cpp) with every branch turned into a select
+   *-----------------------------------------------------------------------------*/
+  template<class R, class D, class F>
+  void map( const double * const * a, double * const * r, size_t n, F f ){
+    blocks( n, [&]( size_t i, size_t w ){ store( R( f( load<D>( a, i, w ) ) ), r, i, w ); } );
+  }
+
+  /// Gen::rot: cos c - sin c / c b, with c^2 = -b.wt()
+  template<int A>
+  VSR_KERNEL void rot( const double * const * a, double * const * r, size_t n ){
+    map<Rot, Biv>( a, r, n, []( const Biv& b ){
+      P c = vsqrt( vmax( -csca<M>( b, b ), 0.0 ) ), sc, cc;
+      vsincos<A>( c, sc, cc );
+      Rot t = scale( b, -vsinc( sc, c ) );
+      t[0] = cc;
+      return t;
+    } );
+  }
+
+  /// Gen::mot in the closed form of kernel::mot (vsr_cga3D_kernels.h)
+  template<int A>
+  VSR_KERNEL void mot( const double * const * a, double * const * r, size_t n ){
+    map<Mot, Dll>( a, r, n, []( const Dll& t ){
+      P c = vsqrt( t[0] * t[0] + t[1] * t[1] + t[2] * t[2] ), sc, cc;
+      vsincos<A>( c, sc, cc );
+      P inv = sel( c > 0.0, 1.0 / c, 0.0 ), sinc = vsinc( sc, c );
+      P n0 = t[2] * inv, n1 = -t[1] * inv, n2 = t[0] * inv;
+      P tn = t[3] * n0 + t[4] * n1 + t[5] * n2;
+      P k = tn * ( cc - sinc );
+      Mot m;
+      m[0] = cc; m[1] = t[0] * sinc; m[2] = t[1] * sinc; m[3] = t[2] * sinc;
+      m[4] = t[3] * sinc + n0 * k; m[5] = t[4] * sinc + n1 * k; m[6] = t[5] * sinc + n2 * k;
+      m[7] = tn * sc;
+      return m;
+    } );
+  }
+
+  /// Gen::bst: cn - sn p, trigonometric for p.wt() < 0 and hyperbolic above
+  template<int A>
+  VSR_KERNEL void bst( const double * const * a, double * const * r, size_t n ){
+    map<Bst, Par>( a, r, n, []( const Par& p ){
+      P td = csca<M>( p, p ), c = vsqrt( vabs( td ) ), sc, cc, shc, ch;
+      vsincos<A>( c, sc, cc );
+      vsinhc<A>( c, shc, ch );
+      Mask ell = td < 0.0;
+      Bst t = scale( p, -sel( ell, vsinc( sc, c ), shc ) );
+      t[0] = sel( ell, cc, ch );
+      return t;
+    } );
+  }
+
+  /// Gen::log of a rotor: atan2( |b|, s ) b / |b|, and pi e12 for -1
+  template<int A>
+  VSR_KERNEL void logRot( const double * const * a, double * const * r, size_t n ){
+    map<Biv, Rot>( a, r, n, []( const Rot& t ){
+      Biv b( t );
+      P nb = vsqrt( vmax( csca<M>( b, ~b ), 0.0 ) );
+      b = scale( b, sel( nb > 0.0, vatan2<A>( nb, t[0] ) / nb, 0.0 ) );
+      b[0] += sel( nb > 0.0, 0.0, sel( t[0] < 0.0, Pi, 0.0 ) );
+      return b;
+    } );
+  }
+
+  /// Gen::log of a motor; a half turn (s = -1) has no axis and gets a zero bivector
+  template<int A>
+  VSR_KERNEL void logMot( const double * const * a, double * const * r, size_t n ){
+    map<Dll, Mot>( a, r, n, []( const Mot& m ){
+      Dll q( m );
+      Ori o; o[0] = 1.0;
+      Inf f; f[0] = 1.0;
+      Drt d; d[0] = m[7];
+      P ac = vatan2<A>( vsqrt( vmax( 1.0 - m[0] * m[0], 0.0 ) ), m[0] ), sc, cc;
+      vsincos<A>( ac, sc, cc );
+      P den = vsinc( sc, ac ), den2 = ac * sc;
+      Biv b = scale( Biv( o <= ( q * f ) ), sel( den > 0.0, -1.0 / den, 0.0 ) );
+      Dll tq( b * q );
+      Mask pure = den2 == 0.0;                      // pure rotation (no slide along the screw)
+      Drv c = scale( Drv( b * d ), sel( pure, 0.0, -1.0 / den2 ) );
+      Drv cpara = scale( Drv( b * tq ), sel( pure, -1.0, -1.0 / den2 ) );
+      Dll t( b ), tc( c ), tp( cpara );
+      for (int k = 0; k < Dll::Num; ++k) t[k] += tc[k] + tp[k];
+      return t;
+    } );
+  }
+
+  /// Gen::log of a boost: p asinh(s)/s for p.wt() = s^2 > 0, p atan2(s, b0)/s for -s^2
+  template<int A>
+  VSR_KERNEL void logBst( const double * const * a, double * const * r, size_t n ){
+    map<Par, Bst>( a, r, n, []( const Bst& b ){
+      Par p( b );
+      P td = csca<M>( p, p ), s = vsqrt( vabs( td ) );
+      P ne = vatan2<A>( s, b[0] ) / sel( s > 0.0, s, 1.0 );
+      return scale( p, sel( td > 0.0, vasinhc<A>( s ), sel( td < 0.0, ne, 1.0 ) ) );
+    } );
+  }
+
+  VSR_KERNEL void relax( double * x, const double * prev, int w, int h, int d, int c, double a, double s ){
+    if ( w < 3 || h < 3 || d < 3 ) return;
+    const size_t len = (size_t)( d - 2 ) * c;     //doubles in the interior of a row
+    const size_t dj = (size_t)d * c, di = (size_t)h * d * c;
+    double * old = (double*)malloc( ( len + 2 * c ) * sizeof(double) );
+    const P pa( a ), ps( s );
+    for (int i = 1; i < w - 1; ++i){
+      for (int j = 1; j < h - 1; ++j){
+        double * row = x + ( (size_t)i * h + j ) * dj + c;
+        const double * pr = prev + ( row - x );
+        memcpy( old, row - c, ( len + 2 * c ) * sizeof(double) );
+        blocks( len, [&]( size_t q, size_t m ){
+          P nb = P::load( old + q, m ) + P::load( old + q + 2 * c, m )
+               + P::load( row + q - dj, m ) + P::load( row + q + dj, m )
+               + P::load( row + q - di, m ) + P::load( row + q + di, m );
+          ( ( P::load( pr + q, m ) + pa * nb ) * ps ).store( row + q, m );
+        } );
+      }
+    }
+    free( old );
+  }
+
+} // (unnamed)
+
+extern const Kernels table = {
+  W == 8 ? AVX512 : W == 4 ? AVX2 : SSE2, VSR_SIMD_STR( VSR_SIMD_ISA ), W,
+  spPnt, gpMot,
+  { rot<Fast>, rot<Single>, rot<Full> },
+  { mot<Fast>, mot<Single>, mot<Full> },
+  { bst<Fast>, bst<Single>, bst<Full> },
+  { logRot<Fast>, logRot<Single>, logRot<Full> },
+  { logMot<Fast>, logMot<Single>, logMot<Full> },
+  { logBst<Fast>, logBst<Single>, logBst<Full> },
+  relax
+};
+
+} // VSR_SIMD_ISA::
+
+} // simd::
+
+} //vsr::
@@ -0,0 +1,64 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_test.h
+ *
+ *    Description:  minimal checks for the headless tests (make check)
+ *
+ *                  CHECK( a < b ) prints the failing expression and its line, and
+ *                  test::result() is the exit status of the test: 1 if any check failed.
+ *                  dist( a, b ) is the largest difference of the coefficients of two
+ *                  multivectors of the same type, rnd<T>() one with random coefficients.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_test_INC
+#define  vsr_test_INC
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHECK(x) test::check( (x), #x, __FILE__, __LINE__ )
+
+namespace test {
+
+  static int failed = 0;
+  static int passed = 0;
+
+  inline bool check( bool ok, const char * what, const char * file, int line ){
+    if ( ok ) ++passed;
+    else { ++failed; printf( "%s:%d: check failed: %s\n", file, line, what ); }
+    return ok;
+  }
+
+  /// exit status: prints the number of checks
+  inline int result(){
+    printf( "%d checks, %d failed\n", passed + failed, failed );
+    return failed ? 1 : 0;
+  }
+
+  /// uniform in [-1, 1]
+  inline double rnd(){ return 2.0 * rand() / RAND_MAX - 1.0; }
+
+  template<class T>
+  T rnd(){
+    T t;
+    for (int i = 0; i < T::Num; ++i) t[i] = rnd();
+    return t;
+  }
+
+  /// largest difference of the coefficients of a and b
+  template<class T>
+  double dist( const T& a, const T& b ){
+    double d = 0;
+    for (int i = 0; i < T::Num; ++i) d = fmax( d, fabs( a[i] - b[i] ) );
+    return d;
+  }
+
+} // test::
+
+#endif   /* ----- #ifndef vsr_test_INC  ----- */
@@ -0,0 +1,87 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  xSandwich.cpp
+ *
+ *    Description:  SandwichProd (vsr_sandwich.h) against the full products
+ *
+ *                  make tests/xSandwich.cpp
+ *
+ *                  For random a and b, fused(), staged() and sp() of b * a * ~b (and of
+ *                  the reflection b * a.involution() * ~b) must agree with the product
+ *                  multiplied out in full and cast to the type of a, in CGA<5> (null
+ *                  basis), in euclidean 3-space and in spacetime.  Each pair also checks
+ *                  that sp() takes the cheaper path, including versors of more than
+ *                  sandwich::MaxFused blades, for which the fused list is not counted.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#include "vsr_cga3D_types.h"
+
+#include "vsr_test.h"
+
+using namespace vsr;
+using namespace vsr::cga3D;
+
+/// b * a * ~b (or b * a.involution() * ~b), multiplied out and cast to A
+template<class M, bool S, bool Invol, class A, class B>
+A full( const A& a, const B& b ){
+  typedef typename A::Type AT;
+  typedef typename B::Type BT;
+  typedef Prod< BT, AT, M, S > First;
+  typedef Prod< typename First::Type, BT, M, S > Second;
+  const AT& x = a;
+  const BT& y = b;
+  BT ry = Reverse< BT >::Type::template Make( y );
+  return A( Second().gp( First().gp( y, Invol ? x.involution() : x ), ry ).template cast< AT >() );
+}
+
+template<class M, bool S, bool Invol, class A, class B>
+void check( const char * na, const char * nb ){
+  typedef SandwichProd< A, B, M, S, Invol > SP;
+  for (int n = 0; n < 8; ++n){
+    A a = test::rnd<A>();
+    B b = test::rnd<B>();
+    A f = full<M, S, Invol>( a, b );
+    bool ok = CHECK( test::dist( SP().fused( a, b ), f ) < 1e-12 )
+      && CHECK( test::dist( SP().staged( a, b ), f ) < 1e-12 )
+      && CHECK( test::dist( SP().sp( a, b ), f ) < 1e-12 );
+    if ( !ok ){ printf( "  %s %s %s\n", na, Invol ? "reflected in" : "spun by", nb ); break; }
+  }
+  if ( !CHECK( SP::UseFused == ( SP::FusedCost <= SP::StagedCost ) ) )
+    printf( "  %s %s %s: fused %d, staged %d\n", na, Invol ? "reflected in" : "spun by", nb, SP::FusedCost, SP::StagedCost );
+}
+
+typedef CGA<5>::M M;
+
+#define SPIN(A,B) check< M, true, false, A, B >( #A, #B );
+#define REFLECT(A,B) check< M, true, true, A, B >( #A, #B );
+#define CONFORMAL(A) SPIN(A,Rot) SPIN(A,Trs) SPIN(A,Mot) SPIN(A,Bst) SPIN(A,Tsd) SPIN(A,Dil) \
+  REFLECT(A,Vec) REFLECT(A,Sph) REFLECT(A,Dlp) REFLECT(A,Pnt)
+
+typedef RMetric<3,0>::Type EucM;
+typedef RMetric<1,3>::Type StaM;
+typedef MGAMV< StaM, MGA<StaM>::Vec > STVec;
+typedef MGAMV< StaM, MGA<StaM>::Biv > STBiv;
+typedef MGAMV< StaM, MGA<StaM>::Rot > STRot;
+
+int main(){
+
+  CONFORMAL(Pnt) CONFORMAL(Par) CONFORMAL(Cir) CONFORMAL(Sph) CONFORMAL(Dll) CONFORMAL(Lin)
+  CONFORMAL(Dlp) CONFORMAL(Pln) CONFORMAL(Vec) CONFORMAL(Drv) CONFORMAL(Tnv) CONFORMAL(Flp)
+
+  check< EucM, false, false, NEVec<3>, NERot<3> >( "Vec", "Rot" );
+  check< EucM, false, false, NEBiv<3>, NERot<3> >( "Biv", "Rot" );
+  check< EucM, false, true, NEVec<3>, NEVec<3> >( "Vec", "Vec" );
+  check< EucM, false, true, NEBiv<3>, NEVec<3> >( "Biv", "Vec" );
+
+  check< StaM, false, false, STVec, STRot >( "Vec", "Rot" );
+  check< StaM, false, false, STBiv, STRot >( "Biv", "Rot" );
+  check< StaM, false, true, STVec, STVec >( "Vec", "Vec" );
+  check< StaM, false, true, STBiv, STVec >( "Biv", "Vec" );
+
+  return test::result();
+}
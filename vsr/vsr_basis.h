@@ -25,7 +25,7 @@ namespace vsr{
 using namespace std;
   
 
-typedef double VT; 
+typedef double VT;  //default scalar type (see MVT in vsr_mv.h)
 typedef short TT;  
 
 constexpr TT blade(){ return 0; }
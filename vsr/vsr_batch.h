@@ -0,0 +1,405 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_batch.h
+ *
+ *    Description:  structure-of-arrays containers of multivectors
+ *
+ *                  MVBatch< MV<XS...> > stores each blade coefficient in its own
+ *                  aligned contiguous array.  Blocks of Width elements are loaded
+ *                  into MVT< Lanes<VT>, XS... > and pushed through the same
+ *                  compile-time instruction lists as single multivectors.
+ *
+ *                  CGAMVBatch<DIM,A> adds the conformal products, e.g. transforming
+ *                  a cloud of points by one motor:
+ *
+ *                    CGAMVBatch<5, CGA<5>::Pnt> pts( n );
+ *                    ...
+ *                    auto moved = pts.sp( mot );
+ *
+ *                  Points spun by a motor and products of motors in CGA<5> doubles
+ *                  instead go through the kernels of vsr_dispatch.h, which are built
+ *                  for the widest vector unit of the cpu running them (link libvsr).
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_batch_INC
+#define  vsr_batch_INC
+
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <type_traits>
+
+#include "vsr_simd.h"
+#include "vsr_products.h"
+#include "vsr_dispatch.h"
+
+namespace vsr {
+
+template<class A>
+struct MVBatch;
+
+/*!
+ *  \brief  Structure of arrays of multivectors of type MVT<T,XS...>
+ *
+ *  Coefficient k of element i lives at data(k)[i].  Every blade array is padded to a
+ *  multiple of Width so kernels never need a scalar remainder loop.
+ */
+template<class T, TT ... XS>
+struct MVBatch< MVT<T, XS...> > {
+
+  typedef MVT<T, XS...> Type;
+  typedef T VT;
+  typedef Lanes<T> Pack;
+  typedef MVT<Pack, XS...> PackType;   ///< one block of Width multivectors
+
+  static const int Num = Type::Num;
+  static const int Width = Pack::Width;
+  static const size_t Align = Width * sizeof(T);
+
+  protected:
+
+  size_t mSize;    ///< number of multivectors
+  size_t mStride;  ///< padded length of each blade array
+  void * mAlloc;   ///< owning allocation
+  T * mData;       ///< Num arrays of mStride coefficients, aligned to Align
+
+  void alloc( size_t n ){
+    mSize = n;
+    mStride = ( (n + Width - 1) / Width ) * Width;
+    size_t bytes = mStride * Num * sizeof(T);
+    mAlloc = bytes ? malloc( bytes + Align ) : NULL;
+    mData = mAlloc ? (T*)( ( (size_t)mAlloc + Align - 1 ) & ~(Align - 1) ) : NULL;
+    if (mData) memset( (void*)mData, 0, bytes );
+  }
+
+  public:
+
+  explicit MVBatch( size_t n = 0 ) { alloc(n); }
+
+  MVBatch( const MVBatch& b ) {
+    alloc( b.mSize );
+    if (mData) memcpy( (void*)mData, b.mData, mStride * Num * sizeof(T) );
+  }
+
+  MVBatch( MVBatch&& b ) : mSize(b.mSize), mStride(b.mStride), mAlloc(b.mAlloc), mData(b.mData) {
+    b.mSize = b.mStride = 0; b.mAlloc = NULL; b.mData = NULL;
+  }
+
+  MVBatch& operator = ( MVBatch b ){
+    std::swap( mSize, b.mSize ); std::swap( mStride, b.mStride );
+    std::swap( mAlloc, b.mAlloc ); std::swap( mData, b.mData );
+    return *this;
+  }
+
+  ~MVBatch(){ free( mAlloc ); }
+
+  /// Reallocate to n elements (contents are zeroed)
+  void resize( size_t n ){ free( mAlloc ); alloc(n); }
+
+  size_t size() const { return mSize; }
+  size_t stride() const { return mStride; }
+  /// Number of Width wide blocks
+  size_t blocks() const { return mStride / Width; }
+
+  /// Aligned array of coefficient k (of all elements)
+  T * data( int k ) { return mData + k * mStride; }
+  const T * data( int k ) const { return mData + k * mStride; }
+
+  /// p[k] = data(k) for every k, for kernels taking structures of arrays
+  void arrays( const T ** p ) const { for (int k = 0; k < Num; ++k) p[k] = data(k); }
+  void arrays( T ** p ) { for (int k = 0; k < Num; ++k) p[k] = data(k); }
+
+  /// Gather element i
+  Type get( size_t i ) const {
+    Type r;
+    for (int k = 0; k < Num; ++k) r[k] = data(k)[i];
+    return r;
+  }
+
+  /// Scatter element i
+  template<class B>
+  void set( size_t i, const B& b ){
+    for (int k = 0; k < Num; ++k) data(k)[i] = b[k];
+  }
+
+  /// Load block j (elements j*Width ... j*Width + Width-1)
+  PackType load( size_t j ) const {
+    PackType r;
+    for (int k = 0; k < Num; ++k) r[k] = Pack::load( data(k) + j * Width );
+    return r;
+  }
+
+  /// Store block j
+  template<class B>
+  void store( size_t j, const B& b ){
+    for (int k = 0; k < Num; ++k) b[k].store( data(k) + j * Width );
+  }
+};
+
+/// Broadcast a single multivector into every lane of a pack multivector
+template<class T, TT ... XS>
+MVT< Lanes<T>, XS... > lanes( const MVT<T, XS...>& a ){
+  MVT< Lanes<T>, XS... > r;
+  for (int k = 0; k < MVT<T, XS...>::Num; ++k) r[k] = a[k];
+  return r;
+}
+
+
+/// Pairs with a run time dispatched kernel (vsr_dispatch.h): SP for A.sp(B), GP for A * B
+template<class A, class B>
+struct BatchDispatch { static const bool SP = false, GP = false; };
+
+template<>
+struct BatchDispatch< CGA<5>::Pnt, CGA<5>::Mot > { static const bool SP = true, GP = false; };
+
+template<>
+struct BatchDispatch< CGA<5>::Mot, CGA<5>::Mot > { static const bool SP = false, GP = true; };
+
+
+/*!
+ *  \brief  Structure of arrays of conformal multivectors
+ *
+ *  Products run one block at a time on CGAMV< DIM, MVT<Lanes<VT>,XS...> > so they are
+ *  built from exactly the same instruction lists as CGAMV<DIM,A>.
+ */
+template<TT DIM, class A>
+struct CGAMVBatch : public MVBatch<A> {
+
+  typedef MVBatch<A> Base;
+  typedef CGAMV<DIM, A> Elem;
+  typedef CGAMV<DIM, typename Base::PackType> PackElem;
+  typedef typename RMetric<DIM-1,1>::Type M;
+
+  template< class B > using BType = CGAMVBatch<DIM, B>;
+
+  explicit CGAMVBatch( size_t n = 0 ) : Base(n) {}
+
+  /// Fill from a container of CGAMV<DIM,A> (e.g. std::vector<Pnt>)
+  template<class C>
+  static CGAMVBatch From( const C& c ){
+    CGAMVBatch r( c.size() );
+    size_t i = 0;
+    for (const auto& e : c) r.set( i++, e );
+    return r;
+  }
+
+  Elem operator [] ( size_t i ) const { return Elem( this->get(i) ); }
+
+  PackElem block( size_t j ) const { return PackElem( this->load(j) ); }
+
+  /// Copy out into a container of CGAMV<DIM,A>
+  template<class C>
+  void copyTo( C& c ) const {
+    c.resize( this->size() );
+    for (size_t i = 0; i < this->size(); ++i) c[i] = (*this)[i];
+  }
+
+  /*-----------------------------------------------------------------------------
+   *  Element-wise products with another batch of the same size
+   *-----------------------------------------------------------------------------*/
+  template<class B>
+  CGAMVBatch<DIM, typename Prod<A, B, M, true>::Type>
+  gp( const CGAMVBatch<DIM,B>& b ) const {
+    CGAMVBatch<DIM, typename Prod<A, B, M, true>::Type> r( this->size() );
+    gp( b, r, std::integral_constant< bool, BatchDispatch<A,B>::GP >() );
+    return r;
+  }
+  /// Same, into r (of the same size)
+  template<class B, class R>
+  void gp( const CGAMVBatch<DIM,B>& b, R& r ) const {
+    gp( b, r, std::integral_constant< bool, BatchDispatch<A,B>::GP >() );
+  }
+
+  template<class B>
+  CGAMVBatch<DIM, typename OProd<A, B, M, true>::Type>
+  op( const CGAMVBatch<DIM,B>& b ) const {
+    CGAMVBatch<DIM, typename OProd<A, B, M, true>::Type> r( this->size() );
+    for (size_t j = 0; j < this->blocks(); ++j) r.store( j, block(j) ^ b.block(j) );
+    return r;
+  }
+
+  template<class B>
+  CGAMVBatch<DIM, typename IProd<A, B, M, true>::Type>
+  ip( const CGAMVBatch<DIM,B>& b ) const {
+    CGAMVBatch<DIM, typename IProd<A, B, M, true>::Type> r( this->size() );
+    for (size_t j = 0; j < this->blocks(); ++j) r.store( j, block(j) <= b.block(j) );
+    return r;
+  }
+
+  /*-----------------------------------------------------------------------------
+   *  Element-wise products with one multivector
+   *-----------------------------------------------------------------------------*/
+  template<class B>
+  CGAMVBatch<DIM, typename Prod<A, B, M, true>::Type>
+  gp( const CGAMV<DIM,B>& b ) const {
+    CGAMVBatch<DIM, typename Prod<A, B, M, true>::Type> r( this->size() );
+    auto tb = CGAMV<DIM, decltype( lanes(b) )>( lanes(b) );
+    for (size_t j = 0; j < this->blocks(); ++j) r.store( j, block(j) * tb );
+    return r;
+  }
+
+  template<class B>
+  CGAMVBatch<DIM, typename OProd<A, B, M, true>::Type>
+  op( const CGAMV<DIM,B>& b ) const {
+    CGAMVBatch<DIM, typename OProd<A, B, M, true>::Type> r( this->size() );
+    auto tb = CGAMV<DIM, decltype( lanes(b) )>( lanes(b) );
+    for (size_t j = 0; j < this->blocks(); ++j) r.store( j, block(j) ^ tb );
+    return r;
+  }
+
+  template<class B>
+  CGAMVBatch<DIM, typename IProd<A, B, M, true>::Type>
+  ip( const CGAMV<DIM,B>& b ) const {
+    CGAMVBatch<DIM, typename IProd<A, B, M, true>::Type> r( this->size() );
+    auto tb = CGAMV<DIM, decltype( lanes(b) )>( lanes(b) );
+    for (size_t j = 0; j < this->blocks(); ++j) r.store( j, block(j) <= tb );
+    return r;
+  }
+
+  /*-----------------------------------------------------------------------------
+   *  Versor application: writes into out (which must have the same size)
+   *-----------------------------------------------------------------------------*/
+  /// Spin every element by versor b (fused form: the b[i]*b[j] sums are hoisted out of the loop)
+  template<class B>
+  void sp( const CGAMV<DIM,B>& b, CGAMVBatch& out ) const {
+    sp( b, out, std::integral_constant< bool, BatchDispatch<A,B>::SP >() );
+  }
+  /// Spin element i by versor i of b
+  template<class B>
+  void sp( const CGAMVBatch<DIM,B>& b, CGAMVBatch& out ) const {
+    for (size_t j = 0; j < this->blocks(); ++j) out.store( j, block(j).sp( b.block(j) ) );
+  }
+  /// Reflect every element in versor b
+  template<class B>
+  void re( const CGAMV<DIM,B>& b, CGAMVBatch& out ) const {
+    auto tb = CGAMV<DIM, decltype( lanes(b) )>( lanes(b) );
+    SandwichProd< PackElem, decltype(tb), M, true, true > s;
+    for (size_t j = 0; j < this->blocks(); ++j) out.store( j, s.fused( block(j), tb ) );
+  }
+  /// Reflect element i in versor i of b
+  template<class B>
+  void re( const CGAMVBatch<DIM,B>& b, CGAMVBatch& out ) const {
+    for (size_t j = 0; j < this->blocks(); ++j) out.store( j, block(j).re( b.block(j) ) );
+  }
+
+  template<class B>
+  CGAMVBatch sp( const B& b ) const { CGAMVBatch r( this->size() ); sp( b, r ); return r; }
+  template<class B>
+  CGAMVBatch spin( const B& b ) const { return sp(b); }
+  template<class B>
+  CGAMVBatch re( const B& b ) const { CGAMVBatch r( this->size() ); re( b, r ); return r; }
+  template<class B>
+  CGAMVBatch reflect( const B& b ) const { return re(b); }
+
+  /*-----------------------------------------------------------------------------
+   *  Duals and involutions: signed copies of the coefficient arrays
+   *-----------------------------------------------------------------------------*/
+  typedef CGAMVBatch<DIM, typename Elem::PssProd::Type> DualBatch;
+  typedef CGAMVBatch<DIM, typename Elem::EucPssProd::Type> DualEBatch;
+
+  /// Dual (undual) of every element into out (of the same size)
+  void dual( DualBatch& out ) const { for (size_t j = 0; j < this->blocks(); ++j) out.store( j, block(j).dual() ); }
+  void undual( DualBatch& out ) const { for (size_t j = 0; j < this->blocks(); ++j) out.store( j, block(j).undual() ); }
+  void duale( DualEBatch& out ) const { for (size_t j = 0; j < this->blocks(); ++j) out.store( j, block(j).duale() ); }
+  void unduale( DualEBatch& out ) const { for (size_t j = 0; j < this->blocks(); ++j) out.store( j, block(j).unduale() ); }
+
+  DualBatch dual() const { DualBatch r( this->size() ); dual( r ); return r; }
+  DualBatch undual() const { DualBatch r( this->size() ); undual( r ); return r; }
+  DualEBatch duale() const { DualEBatch r( this->size() ); duale( r ); return r; }
+  DualEBatch unduale() const { DualEBatch r( this->size() ); unduale( r ); return r; }
+
+  /// Reverse (involute) every element in place: negates the arrays of the flipped blades
+  CGAMVBatch& reverseInPlace(){ Flips< typename Reverse< A >::Type >::each( [this]( int k ){ negate( k ); } ); return *this; }
+  CGAMVBatch& involuteInPlace(){ Flips< typename Involute< A >::Type >::each( [this]( int k ){ negate( k ); } ); return *this; }
+
+  private:
+
+  void negate( int k ){
+    typedef typename Base::Pack Pack;
+    typename Base::VT * p = this->data(k);
+    for (size_t j = 0; j < this->stride(); j += Base::Width) ( -Pack::load( p + j ) ).store( p + j );
+  }
+
+  template<class B, class R>
+  void gp( const CGAMVBatch<DIM,B>& b, R& r, std::false_type ) const {
+    for (size_t j = 0; j < this->blocks(); ++j) r.store( j, block(j) * b.block(j) );
+  }
+  template<class B, class R>
+  void gp( const CGAMVBatch<DIM,B>& b, R& r, std::true_type ) const {
+    const double * pa[A::Num], * pb[B::Num]; double * pr[R::Num];
+    this->arrays( pa ); b.arrays( pb ); r.arrays( pr );
+    simd::kernels().gpMot( pa, pb, pr, this->size() );
+  }
+
+  template<class B>
+  void sp( const CGAMV<DIM,B>& b, CGAMVBatch& out, std::false_type ) const {
+    auto tb = CGAMV<DIM, decltype( lanes(b) )>( lanes(b) );
+    SandwichProd< PackElem, decltype(tb), M, true > s;
+    for (size_t j = 0; j < this->blocks(); ++j) out.store( j, s.fused( block(j), tb ) );
+  }
+  template<class B>
+  void sp( const CGAMV<DIM,B>& b, CGAMVBatch& out, std::true_type ) const {
+    const double * pa[A::Num]; double * po[A::Num];
+    this->arrays( pa ); out.arrays( po );
+    simd::kernels().spPnt( b.val, pa, po, this->size() );
+  }
+};
+
+/// e.g. NPntBatch<5>, NMotBatch<5,float>
+template<TT N, class T = VT> using NPntBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Pnt, T>::Type>;
+template<TT N, class T = VT> using NVecBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Vec, T>::Type>;
+template<TT N, class T = VT> using NParBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Par, T>::Type>;
+template<TT N, class T = VT> using NCirBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Cir, T>::Type>;
+template<TT N, class T = VT> using NSphBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Sph, T>::Type>;
+template<TT N, class T = VT> using NDllBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Dll, T>::Type>;
+template<TT N, class T = VT> using NRotBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Rot, T>::Type>;
+template<TT N, class T = VT> using NMotBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Mot, T>::Type>;
+template<TT N, class T = VT> using NBivBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Biv, T>::Type>;
+template<TT N, class T = VT> using NBstBatch = CGAMVBatch<N, typename Rebind<typename CGA<N>::Bst, T>::Type>;
+
+/*-----------------------------------------------------------------------------
+ *  Exponentials and logarithms of whole batches of CGA<5> doubles, e.g. sampling
+ *  a screw motion:
+ *
+ *    NDllBatch<5> d( n );  ...  d.set( i, dll * ( i * dt ) );
+ *    NMotBatch<5> m( n );
+ *    Gen::mot<simd::Single>( d, m );
+ *
+ *  Acc is simd::Fast, Single or Full (vsr_dispatch.h).  Nothing branches or prints:
+ *  log of a rotor of -1 gives pi e12, like Gen::log, and log of a motor with no axis
+ *  (a half turn) a zero bivector.  Outputs must have the size of the inputs.
+ *-----------------------------------------------------------------------------*/
+namespace Gen {
+
+  /// r = f( a ) through the kernel f of simd::kernels()
+  template<class R, class A>
+  void map( simd::Kernels::Map f, const A& a, R& r ){
+    const double * pa[A::Num]; double * pr[R::Num];
+    a.arrays( pa ); r.arrays( pr );
+    f( pa, pr, a.size() );
+  }
+
+  template<int Acc = simd::Full> void rot( const NBivBatch<5>& b, NRotBatch<5>& r ){ map( simd::kernels().rot[Acc], b, r ); }
+  template<int Acc = simd::Full> void mot( const NDllBatch<5>& d, NMotBatch<5>& r ){ map( simd::kernels().mot[Acc], d, r ); }
+  template<int Acc = simd::Full> void bst( const NParBatch<5>& p, NBstBatch<5>& r ){ map( simd::kernels().bst[Acc], p, r ); }
+  template<int Acc = simd::Full> void log( const NRotBatch<5>& a, NBivBatch<5>& r ){ map( simd::kernels().logRot[Acc], a, r ); }
+  template<int Acc = simd::Full> void log( const NMotBatch<5>& a, NDllBatch<5>& r ){ map( simd::kernels().logMot[Acc], a, r ); }
+  template<int Acc = simd::Full> void log( const NBstBatch<5>& a, NParBatch<5>& r ){ map( simd::kernels().logBst[Acc], a, r ); }
+
+  template<int Acc = simd::Full> NRotBatch<5> rot( const NBivBatch<5>& b ){ NRotBatch<5> r( b.size() ); rot<Acc>( b, r ); return r; }
+  template<int Acc = simd::Full> NMotBatch<5> mot( const NDllBatch<5>& d ){ NMotBatch<5> r( d.size() ); mot<Acc>( d, r ); return r; }
+  template<int Acc = simd::Full> NBstBatch<5> bst( const NParBatch<5>& p ){ NBstBatch<5> r( p.size() ); bst<Acc>( p, r ); return r; }
+  template<int Acc = simd::Full> NBivBatch<5> log( const NRotBatch<5>& a ){ NBivBatch<5> r( a.size() ); log<Acc>( a, r ); return r; }
+  template<int Acc = simd::Full> NDllBatch<5> log( const NMotBatch<5>& a ){ NDllBatch<5> r( a.size() ); log<Acc>( a, r ); return r; }
+  template<int Acc = simd::Full> NParBatch<5> log( const NBstBatch<5>& a ){ NParBatch<5> r( a.size() ); log<Acc>( a, r ); return r; }
+
+} // Gen::
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_batch_INC  ----- */
@@ -0,0 +1,212 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_cayley.h
+ *
+ *    Description:  product tables as constexpr data
+ *
+ *                  Cayley<A,B,Metric,SplitIt,Kind> answers, for blade lists A and B,
+ *                  "which blades does a * b have" (Type) and "which a[i] * b[j] write
+ *                  blade k, with what sign" (Do<R>) by evaluating constexpr functions
+ *                  of the blade bits, instead of instantiating a split product per
+ *                  pair of blades and insert-sorting the results (CGP, now in old/).
+ *
+ *                  Template instantiations grow with the number of result blades
+ *                  and instructions only, so larger algebras (CGA<6>, CGA<7>) build
+ *                  in reasonable time and memory.  The instruction lists it generates
+ *                  are the same, in the same order, as those of the recursive
+ *                  generator: for each result blade, a[i] * b[j] by decreasing i, j.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_cayley_INC
+#define  vsr_cayley_INC
+
+#include "vsr_instructions.h"
+#include "vsr_sandwich.h"
+
+namespace vsr {
+
+namespace cayley {
+
+  /// product kinds (SP, the sandwich, only names kernels: see Kernel in vsr_products.h)
+  enum { GP = 0, OP = 1, IP = 2, SP = 3 };
+
+  /// no key (past the last blade)
+  static const int None = 1 << 30;
+
+  /// blades sort by grade, then by value (as compare() in vsr_basis.h)
+  constexpr int key( TT a ){ return ( grade(a) << 16 ) | ( a & 0xFFFF ); }
+  constexpr TT blade( int k ){ return k & 0xFFFF; }
+
+  constexpr int min( int a, int b ){ return a < b ? a : b; }
+
+  typedef unsigned long long Word;
+  constexpr Word orAll(){ return 0; }
+  template<class ... XS>
+  constexpr Word orAll( Word a, XS ... xs ){ return a | orAll( xs... ); }
+
+  /// lowest blade of grade g, and the next blade of the same grade (Gosper's hack)
+  constexpr int first( int g ){ return ( 1 << g ) - 1; }
+  constexpr int nextSame( int x, int c ){ return ( ( ( ( x + c ) ^ x ) >> 2 ) / c ) | ( x + c ); }
+  constexpr int nextSame( int x ){ return x == 0 ? None : nextSame( x, x & -x ); }
+
+  constexpr bool any(){ return false; }
+  template<class ... XS>
+  constexpr bool any( bool a, XS ... xs ){ return a || any( xs... ); }
+
+  constexpr bool keep( int kind, TT a, TT b ){
+    return kind == GP ? true : kind == OP ? outer(a,b) : inner(a,b);
+  }
+
+  /// coefficient of t in the product of diagonal blades a, b
+  constexpr double diag( int kind, TT a, TT b, TT t, TT dim, TT neg, bool split ){
+    return !keep(kind,a,b) ? 0.0 : sandwich::dsign(a,b,neg) * ( split ? sandwich::pop( a^b, t, dim ) : ( (a^b) == t ? 1.0 : 0.0 ) );
+  }
+
+  /// coefficient of t in the product of b with each diagonal part of a
+  constexpr double pushB( int kind, TT a, TT b, TT t, TT dim, TT neg ){
+    return sandwich::pushWt(b,0,dim) * diag( kind, a, sandwich::nth(b,0,dim), t, dim, neg, true )
+      + ( sandwich::mixed(b,dim) ? sandwich::pushWt(b,1,dim) * diag( kind, a, sandwich::nth(b,1,dim), t, dim, neg, true ) : 0.0 );
+  }
+
+  /// coefficient of t in a * b, all blades in the null basis if split
+  constexpr double coef( int kind, TT a, TT b, TT t, TT dim, TT neg, bool split ){
+    return !split ? diag( kind, a, b, t, dim, neg, false ) :
+      sandwich::pushWt(a,0,dim) * pushB( kind, sandwich::nth(a,0,dim), b, t, dim, neg )
+      + ( sandwich::mixed(a,dim) ? sandwich::pushWt(a,1,dim) * pushB( kind, sandwich::nth(a,1,dim), b, t, dim, neg ) : 0.0 );
+  }
+
+  /// coefficient rounded to -1, 0, 1
+  constexpr int sign( double c ){ return c > .5 ? 1 : c < -.5 ? -1 : 0; }
+
+} //cayley::
+
+/*!
+ *  \brief  Product table of blade lists A and B (MVTs)
+ *
+ *  Type is the blade list of the product (sorted as Reduce sorts it), Do<R>::Type the
+ *  instruction list writing the blades of R (as Index<InstList,R>::Type).  A and B may
+ *  be any multivector types (CGAMV, ...), the table is that of the MVTs they derive from.
+ */
+template<class A, class B, class Metric, bool SplitIt, int Kind>
+struct Cayley : Cayley< decltype( swBase( *(const A*)0 ) ), decltype( swBase( *(const B*)0 ) ), Metric, SplitIt, Kind > {};
+
+template<class T, TT ... AS, class S, TT ... BS, class Metric, bool SplitIt, int Kind>
+struct Cayley< MVT<T, AS...>, MVT<S, BS...>, Metric, SplitIt, Kind >{
+
+  static const TT Dim = Metric::Num;
+  static const TT Neg = NegMask<Metric>::Val;
+  /// the other candidate blade of a product in the null basis (no, ni both toggled)
+  static const TT Swap = SplitIt ? ( sandwich::obit(Dim) | sandwich::ibit(Dim) ) : 0;
+
+  static const int NA = sizeof...(AS);
+  static const int NB = sizeof...(BS);
+  static constexpr TT BladeA[NA + 1] = { AS..., 0 };
+  static constexpr TT BladeB[NB + 1] = { BS..., 0 };
+
+  static constexpr int Coef( TT a, TT b, TT t ){
+    return cayley::sign( cayley::coef( Kind, a, b, t, Dim, Neg, SplitIt ) );
+  }
+
+  /// blades of A and B as bits (blade x is bit x % 64 of Lo, or of Hi past 64)
+  static constexpr cayley::Word Bit( TT x, int w ){ return x / 64 == w ? cayley::Word(1) << ( x % 64 ) : 0; }
+  static constexpr cayley::Word LoA = cayley::orAll( Bit( AS, 0 )... ), HiA = cayley::orAll( Bit( AS, 1 )... );
+  static constexpr cayley::Word LoB = cayley::orAll( Bit( BS, 0 )... ), HiB = cayley::orAll( Bit( BS, 1 )... );
+
+  /// index of blade x in B (or A), -1 if absent (scalar masks: reading arrays costs more)
+  static constexpr int ScanB( TT x, int j ){ return j == NB ? -1 : BladeB[j] == x ? j : ScanB( x, j + 1 ); }
+  static constexpr int ScanA( TT x, int i ){ return i == NA ? -1 : BladeA[i] == x ? i : ScanA( x, i + 1 ); }
+  static constexpr int FindB( TT x ){ return ( ( x < 64 ? LoB : HiB ) >> ( x % 64 ) ) & 1 ? ScanB( x, 0 ) : -1; }
+  static constexpr int FindA( TT x ){ return ( ( x < 64 ? LoA : HiA ) >> ( x % 64 ) ) & 1 ? ScanA( x, 0 ) : -1; }
+
+  /// j (c = 0 the lower, c = 1 the higher) such that a[i] * b[j] can write blade t, -1 if none
+  static constexpr int Lo( int x, int y ){ return x < 0 ? y : y < 0 ? x : cayley::min(x,y); }
+  static constexpr int Hi( int x, int y ){ return x < 0 || y < 0 ? -1 : x < y ? y : x; }
+  static constexpr int JOf( int i, TT t, int c ){
+    return !Swap ? ( c == 0 ? FindB( t ^ BladeA[i] ) : -1 ) :
+      c == 0 ? Lo( FindB( t ^ BladeA[i] ), FindB( t ^ BladeA[i] ^ Swap ) )
+             : Hi( FindB( t ^ BladeA[i] ), FindB( t ^ BladeA[i] ^ Swap ) );
+  }
+  static constexpr bool Writes( int i, int j, TT t ){ return i >= 0 && j >= 0 && Coef( BladeA[i], BladeB[j], t ) != 0; }
+
+  /// first instruction p = 2 i + c from p on writing blade t, 2 NA if none
+  static constexpr int Next( TT t, int p ){
+    return p == 2 * NA ? p : Writes( p / 2, JOf( p / 2, t, p % 2 ), t ) ? p : Next( t, p + 1 );
+  }
+
+  /// does a[i] (b[j]) feed blade t
+  static constexpr bool ReadsA( int i, TT t ){ return Writes( i, JOf(i,t,0), t ) || Writes( i, JOf(i,t,1), t ); }
+  static constexpr bool ReadsB( int j, TT t ){
+    return Writes( FindA( t ^ BladeB[j] ), j, t ) || ( Swap && Writes( FindA( t ^ BladeB[j] ^ Swap ), j, t ) );
+  }
+
+  /// bits of the result blades in word W (blades 64 W to 64 W + 63)
+  template<int W>
+  static constexpr cayley::Word Bit( TT a, TT b, TT x ){
+    return x / 64 == W && Coef( a, b, x ) != 0 ? cayley::Word(1) << ( x % 64 ) : 0;
+  }
+  template<int W>
+  static constexpr cayley::Word PairWord( TT a, TT b ){
+    return Bit<W>( a, b, a ^ b ) | ( Swap ? Bit<W>( a, b, a ^ b ^ Swap ) : 0 );
+  }
+  template<int W>
+  static constexpr cayley::Word RowWord( TT a ){ return cayley::orAll( PairWord<W>( a, BS )... ); }
+  static constexpr cayley::Word ResLo = cayley::orAll( RowWord<0>( AS )... );
+  static constexpr cayley::Word ResHi = Dim > 6 ? cayley::orAll( RowWord<1>( AS )... ) : 0;
+
+  /// is blade x in the result
+  static constexpr bool Has( TT x ){ return ( ( x < 64 ? ResLo : ResHi ) >> ( x % 64 ) ) & 1; }
+
+  /// key of the first result blade after blade x of grade g (of grade g + 1 on if x is the last)
+  static constexpr int NextKey( int x, int g ){
+    return x >= ( 1 << Dim ) ? ( g == Dim ? cayley::None : NextKey( cayley::first( g + 1 ), g + 1 ) ) :
+      Has(x) ? cayley::key(x) : NextKey( cayley::nextSame(x), g );
+  }
+  static constexpr int After( int k ){ return k < 0 ? NextKey( 0, 0 ) : NextKey( cayley::nextSame( cayley::blade(k) ), grade( cayley::blade(k) ) ); }
+
+  /// instructions writing blade t, from p on, prepended to XS (so last pair first)
+  template<TT t, int p, bool End = ( p == 2 * NA ), class ... XS>
+  struct Insts{
+    static const int i = p / 2;
+    static const int j = JOf( i, t, p % 2 );
+    typedef typename Insts< t, Next( t, p + 1 ), Next( t, p + 1 ) == 2 * NA,
+      Instruct< ( Coef( BladeA[i], BladeB[j], t ) < 0 ), t, i, j >, XS... >::Type Type;
+  };
+  template<TT t, int p, class ... XS>
+  struct Insts< t, p, true, XS... >{
+    typedef XList<XS...> Type;
+  };
+
+  /// result blades from key k on, appended to XS
+  template<int k, bool End = ( k == cayley::None ), TT ... XS>
+  struct Blades{
+    typedef typename Blades< After(k), After(k) == cayley::None, XS..., cayley::blade(k) >::Type Type;
+  };
+  template<int k, TT ... XS>
+  struct Blades< k, true, XS... >{
+    typedef MVT<T, XS...> Type;
+  };
+
+  typedef typename Blades< After(-1) >::Type Type;
+
+  /// instruction lists writing the blades of R
+  template<class R>
+  struct Do : Do< decltype( swBase( *(const R*)0 ) ) > {};
+  template<class U, TT ... RS>
+  struct Do< MVT<U, RS...> >{
+    typedef XList< typename Insts< RS, Next( RS, 0 ) >::Type ... > Type;
+  };
+};
+
+template<class T, TT ... AS, class S, TT ... BS, class Metric, bool SplitIt, int Kind>
+constexpr TT Cayley< MVT<T, AS...>, MVT<S, BS...>, Metric, SplitIt, Kind >::BladeA[];
+template<class T, TT ... AS, class S, TT ... BS, class Metric, bool SplitIt, int Kind>
+constexpr TT Cayley< MVT<T, AS...>, MVT<S, BS...>, Metric, SplitIt, Kind >::BladeB[];
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_cayley_INC  ----- */
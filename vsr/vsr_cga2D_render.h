@@ -43,7 +43,8 @@ namespace vsr {
    }
   }
 
-  MBO& MeshBuffer(const Dll& s ) {  static MBO mbo( Mesh::Line( Vec(-50,0), Vec(50,0) ), GL::DYNAMIC ); return mbo; }  
+  //buffers are per thread, as is the GL context drawing them
+  MBO& MeshBuffer(const Dll& s ) {  static thread_local MBO mbo( Mesh::Line( Vec(-50,0), Vec(50,0) ), GL::DYNAMIC ); return mbo; }  
   MBO& MeshBuffer(const Lin& s ) {  return MeshBuffer( Dll() ); }  
 
   /* vector<MBO>& MeshBuffer(const Vec& s){ */ 
@@ -52,14 +53,14 @@ namespace vsr {
   /* } */
 
   vector<MBO>& MeshBuffer(const Pnt& s){ 
-    static vector<MBO> m = { Mesh::Circle(), Mesh::Point( Pnt() ) };
+    static thread_local vector<MBO> m = { Mesh::Circle(), Mesh::Point( Pnt() ) };
     return m; 
   }
 
   vector<MBO>& MeshBuffer(const Sph& s ) { return MeshBuffer( Pnt() ); }
 
   vector<MBO>& MeshBuffer(const Par& s ) { 
-    static vector<MBO> m = { Mesh::Sphere(), Mesh::Points( Ro::split(s) ) };
+    static thread_local vector<MBO> m = { Mesh::Sphere(), Mesh::Points( Ro::split(s) ) };
     return m; 
   }
 
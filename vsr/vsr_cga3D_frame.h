@@ -24,6 +24,7 @@
  
 #include "vsr_cga3D_op.h"
 #include "vsr_cga3D_xf.h" 
+#include "vsr_outermorphism.h"
 
  
 namespace vsr {
@@ -32,6 +33,13 @@ namespace vsr {
    *
    *  3D position and orientation along with methods for extracting local geometry.
    *  (i.e. a circle on a local xy plane, or a line in the in local y axis) 
+   *
+   *  The motor, the local axes, the dual lines along them and the 4x4 matrices are
+   *  computed on first use and kept until position, orientation or scale change.
+   *  Every mutator drops them, including the accessors that return a reference
+   *  (pos(), rot(), scale()): write through such a reference before the next read.
+   *  A const Frame fills its cache when read, so call update() before sharing one
+   *  among threads that read it.
    */
   class Frame{
     
@@ -47,6 +55,27 @@ namespace vsr {
 
     VT mScale;  ///< Scale
 
+    /// Bits of mValid: which cached values are up to date
+    enum { MOT = 1, AXES = 2, LINES = 4, IMAGE = 8, MAT = 16 };
+
+    mutable unsigned char mValid;   ///< Cached values in date
+    mutable Mot mMot;               ///< Cached mot()
+    mutable Vec mAxis[3];           ///< Cached x(), y(), z()
+    mutable Dll mLine[3];           ///< Cached dlx(), dly(), dlz()
+    mutable gfx::Mat4f mImage;      ///< Cached image()
+    mutable gfx::Mat4f mMat;        ///< Cached mat()
+
+    /// Drop cached values (after orientation changes)
+    void touch() { mValid = 0; }
+    /// Drop cached values that depend on position (after it changes)
+    void moved() { mValid &= AXES | IMAGE; }
+
+    void axes() const;      ///< Fill mAxis
+    void lines() const;     ///< Fill mLine
+
+    /// Copy moved by v (for moveX, moveY, moveZ)
+    Frame moveBy( const Vec& v ) const;
+
     public:
 
     // these typedefs help Frame play nice with Field class . . .
@@ -67,36 +96,41 @@ namespace vsr {
     Frame(const Motor& m );
 
     /// Set Position and Orientation from Point and Rotor
-    Frame& set( Pnt p, Rot r = Rot(1,0,0,0) ) { mPos = p; mRot = r; return *this; } 
+    Frame& set( Pnt p, Rot r = Rot(1,0,0,0) ) { mPos = p; mRot = r; touch(); return *this; } 
     /// Set Scale
-    Frame& scale( VT s ) { mScale = s; return *this; }    
+    Frame& scale( VT s ) { mScale = s; mValid &= ~MAT; return *this; }    
     /// Reset to Origin
-    Frame& reset() { mPos = Ro::null(0,0,0); mRot = Rot(1,0,0,0); return *this; }
+    Frame& reset() { mPos = Ro::null(0,0,0); mRot = Rot(1,0,0,0); touch(); return *this; }
     
     /// Get Scale
     VT scale() const { return mScale; }
     /// Get Scale
-    VT& scale() { return mScale; }
+    VT& scale() { mValid &= ~MAT; return mScale; }
+
+    /// Fill every cached value now
+    const Frame& update() const;
 
 
     /*-----------------------------------------------------------------------------
      *  ORIENTATION METHODS (ROTOR, QUATERNION, ETC)
      *-----------------------------------------------------------------------------*/
     /// Get 4x4 Rotation Matrix
-    gfx::Mat4f image(){ return Xf::mat(mRot); }
+    gfx::Mat4f image() const;
+    /// Get 4x4 Matrix of rotation, position and scale (as drawn by Render)
+    gfx::Mat4f mat() const;
     /// Get Rotor
     Rotor rot() const { return mRot; }
     /// Get Rotor
     Rotor rotor() const { return mRot; }
 
     /// Set Rotor by reference 
-    Rot& rot() { return mRot; } 
+    Rot& rot() { touch(); return mRot; } 
     // Set Rotor by reference
-    Rot& rotor() { return mRot; }     
+    Rot& rotor() { touch(); return mRot; }     
     /// Set rotor with rotor 
-    Frame& rot( const Rot& r) { mRot = r; return *this; }  
+    Frame& rot( const Rot& r) { mRot = r; touch(); return *this; }  
     /// Set rotor with bivector generator 
-    Frame& rot( const Biv& B) { mRot = Gen::rot(B); return *this; }      
+    Frame& rot( const Biv& B) { mRot = Gen::rot(B); touch(); return *this; }      
     /// Transpose rotor to quaternionic representation
     Rot quat() const { return Rot( mRot[0], -mRot[3], mRot[2], mRot[1] ); }
     /// Orient z axis towards v
@@ -109,13 +143,13 @@ namespace vsr {
     /// Get Position
     Point pos() const { return mPos; }  
     /// Get / Set Position by Reference
-    Point& pos() { return mPos; }  
+    Point& pos() { moved(); return mPos; }  
     /// Get Euclidean Vector of position
     Vec vec() const { return mPos; }   
     /// Set Position from Point p
-    Frame& pos( Pnt p ) { mPos = p; return *this; } 
+    Frame& pos( Pnt p ) { mPos = p; moved(); return *this; } 
     /// Set Position from x,y,z coordinates
-    Frame& pos( VT _x, VT _y, VT _z) { mPos = Ro::null(_x,_y,_z); return *this; } 
+    Frame& pos( VT _x, VT _y, VT _z) { mPos = Ro::null(_x,_y,_z); moved(); return *this; } 
     //Frame& set( VT _x, VT _y, VT _z) { mPos = Ro::null(_x,_y,_z); return *this; }
 
     
@@ -178,7 +212,7 @@ namespace vsr {
     Vec up() const { return y(); }   
     Vec forward() const { return -z(); }  
   
-    /// Set position and orientation by motor (absolute) 
+    /// Set position and orientation by motor (absolute), which is kept as mot()
     void mot(const Mot& m);
 
     /// Generate Translation versor based on Position
@@ -189,6 +223,10 @@ namespace vsr {
 
     /// Get Absolute Motor Relative to Origin 
     Motor motor() const;
+
+    /// Matrix of mot() acting on type T, to move many elements at once (e.g. a mesh)
+    template<class T>
+    Outermorphism<Mot, T> outermorphism() const { return Outermorphism<Mot, T>( mot() ); }
     
     /// Dual Sphere Shell
     Dls bound() const;
@@ -0,0 +1,432 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_cga3D_frameArray.h
+ *
+ *    Description:  many Frames stored as structures of arrays, stepped a block at a time
+ *
+ *                  FrameArray fa( 100000 );
+ *                  fa[i].pos( p ).db( b );         //FrameRef: reads and writes slot i
+ *                  Frame f = fa[i];
+ *                  fa.step();                      //Frame::step() of every frame
+ *                  fa.twist( par::seq, mot );      //any loop takes a policy (vsr_par.h)
+ *
+ *                  Positions, rotors, velocities, scales and accelerations each live in
+ *                  a CGAMVBatch (vsr_batch.h), so a block of Width frames is loaded into
+ *                  registers at once.  Gen::rot of the rotational velocities and points
+ *                  spun by one motor go through the kernels of vsr_dispatch.h.  Under
+ *                  par::par (the default) blocks are shared out among the pool's threads;
+ *                  each frame's result is the same under either policy.
+ *
+ *                  Results match Frame's to rounding: spin() takes Gen::rot from the
+ *                  Full accuracy kernel, and boost() locates points by the origin weight.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_cga3D_frameArray_INC
+#define  vsr_cga3D_frameArray_INC
+
+#include <math.h>
+#include <vector>
+
+#include "vsr_cga3D_frame.h"
+#include "vsr_batch.h"
+#include "vsr_par.h"
+
+namespace vsr {
+
+  class FrameArray;
+
+  /*!
+   *  \brief  Frame i of a FrameArray, read and written in place
+   *
+   *  Getters gather the coefficients of slot i, setters scatter them; the geometry of
+   *  Frame (axes, lines, motor, matrices) is computed from a gathered copy.
+   */
+  class FrameRef {
+
+    FrameArray * mArray;
+    size_t mIdx;
+
+    public:
+
+    FrameRef( FrameArray& a, size_t i ) : mArray( &a ), mIdx( i ) {}
+
+    /// Copy the contents of a frame into the slot (not the reference)
+    FrameRef& operator = ( const Frame& f );
+    FrameRef& operator = ( const FrameRef& f ){ return *this = f.frame(); }
+
+    size_t idx() const { return mIdx; }
+
+    Pnt pos() const;      ///< Position
+    Rot rot() const;      ///< Orientation
+    VT scale() const;     ///< Scale
+    Vec dx() const;       ///< Translational velocity
+    Biv db() const;       ///< Rotational velocity
+    VT ax() const;        ///< Translational acceleration
+    VT ab() const;        ///< Rotational acceleration
+
+    FrameRef& pos( const Pnt& p );
+    FrameRef& pos( VT x, VT y, VT z ) { return pos( Ro::null( x, y, z ) ); }
+    FrameRef& rot( const Rot& r );
+    FrameRef& scale( VT s );
+    FrameRef& dx( const Vec& v );
+    FrameRef& db( const Biv& b );
+    FrameRef& ax( VT a );
+    FrameRef& ab( VT a );
+
+    /// Gathered copy
+    Frame frame() const;
+    operator Frame() const { return frame(); }
+
+    Vec vec() const { return pos(); }
+    Vec x() const { return frame().x(); }
+    Vec y() const { return frame().y(); }
+    Vec z() const { return frame().z(); }
+    Mot mot() const { return frame().mot(); }
+    Dll dlx() const { return frame().dlx(); }
+    Dll dly() const { return frame().dly(); }
+    Dll dlz() const { return frame().dlz(); }
+
+    /// 4x4 rotation matrix, as Frame::image()
+    gfx::Mat4f image() const { return Xf::mat( rot() ); }
+    /// 4x4 model matrix (rotation, position and scale)
+    gfx::Mat4f mat() const { return Xf::mat( rot(), vec(), scale() ); }
+  };
+
+
+  /*!
+   *  \brief  Structure of arrays of Frames, with batch integration steps
+   */
+  class FrameArray {
+
+    public:
+
+    typedef NPntBatch<5> PntBatch;
+    typedef NRotBatch<5> RotBatch;
+    typedef NVecBatch<5> VecBatch;
+    typedef NBivBatch<5> BivBatch;
+    typedef CGAMVBatch<5, CGA<5>::Sca> ScaBatch;
+
+    typedef Lanes<VT> Pack;
+    static const int Width = Pack::Width;
+
+    protected:
+
+    PntBatch mPos;      ///< Positions
+    RotBatch mRot;      ///< Orientations
+    VecBatch mDVec;     ///< Translational velocities
+    BivBatch mDBiv;     ///< Rotational velocities
+    ScaBatch mScale;    ///< Scales
+    ScaBatch mAVec;     ///< Translational accelerations
+    ScaBatch mABiv;     ///< Rotational accelerations
+
+    /// Frames at the origin, unit scale, at rest, accelerations of .9 (as Frame())
+    void init(){
+      for (size_t i = 0; i < mPos.stride(); ++i){
+        mPos.data(3)[i] = 1;
+        mRot.data(0)[i] = 1;
+        mScale.data(0)[i] = 1;
+        mAVec.data(0)[i] = .9;
+        mABiv.data(0)[i] = .9;
+      }
+    }
+
+    /// Blocks per chunk: about par::ChunkBytes of frames
+    static size_t grain( const par::Parallel& p ){
+      static const size_t bytes = Width * sizeof(VT) * ( PntBatch::Num + RotBatch::Num + VecBatch::Num + BivBatch::Num + 3 );
+      if ( p.grain ) return ( p.grain + Width - 1 ) / Width;
+      return par::ChunkBytes > bytes ? par::ChunkBytes / bytes : 1;
+    }
+
+    /// f( b, e ) over ranges of blocks [b, e) covering the array
+    template<class F>
+    void blocks( const par::Sequential&, const F& f ){ f( 0, mPos.blocks() ); }
+
+    template<class F>
+    void blocks( const par::Parallel& p, const F& f ){ p.pool().run( mPos.blocks(), grain( p ), f ); }
+
+    /// Elements [b * Width, e * Width) that are in the array
+    size_t count( size_t b, size_t e ) const { return std::min( size(), e * Width ) - std::min( size(), b * Width ); }
+
+    /// Coefficient arrays of batch a from element o on
+    template<class B>
+    static void arrays( const B& a, size_t o, const double ** p ){ for (int k = 0; k < B::Num; ++k) p[k] = a.data(k) + o; }
+    template<class B>
+    static void arrays( B& a, size_t o, double ** p ){ for (int k = 0; k < B::Num; ++k) p[k] = a.data(k) + o; }
+
+    /// Point of Euclidean coordinates x, y, z into block j of mPos (as Ro::null)
+    void null( size_t j, const Pack& x, const Pack& y, const Pack& z ){
+      size_t o = j * Width;
+      x.store( mPos.data(0) + o );
+      y.store( mPos.data(1) + o );
+      z.store( mPos.data(2) + o );
+      Pack( 1.0 ).store( mPos.data(3) + o );
+      ( ( x * x + y * y + z * z ) / Pack( 2.0 ) ).store( mPos.data(4) + o );
+    }
+
+    /// v[j] *= a[j] for every coefficient of the blocks [b, e) of v
+    template<class B>
+    static void damp( B& v, const ScaBatch& a, size_t b, size_t e ){
+      for (size_t j = b; j < e; ++j){
+        Pack s = Pack::load( a.data(0) + j * Width );
+        for (int k = 0; k < B::Num; ++k){
+          double * p = v.data(k) + j * Width;
+          ( Pack::load( p ) * s ).store( p );
+        }
+      }
+    }
+
+    public:
+
+    explicit FrameArray( size_t n = 0 )
+    : mPos( n ), mRot( n ), mDVec( n ), mDBiv( n ), mScale( n ), mAVec( n ), mABiv( n ) { init(); }
+
+    /// Copy of a container of Frames
+    template<class C>
+    static FrameArray From( const C& c ){
+      FrameArray r( c.size() );
+      size_t i = 0;
+      for (const auto& f : c) r.set( i++, f );
+      return r;
+    }
+
+    /// Reallocate to n frames (all reset as Frame())
+    void resize( size_t n ){
+      mPos.resize( n ); mRot.resize( n ); mDVec.resize( n ); mDBiv.resize( n );
+      mScale.resize( n ); mAVec.resize( n ); mABiv.resize( n );
+      init();
+    }
+
+    size_t size() const { return mPos.size(); }
+
+    FrameRef operator [] ( size_t i ) { return FrameRef( *this, i ); }
+    Frame operator [] ( size_t i ) const { return frame( i ); }
+
+    /// Gather frame i
+    Frame frame( size_t i ) const {
+      Frame f( mPos[i], mRot[i], mScale.data(0)[i] );
+      f.dx() = mDVec[i];
+      f.db() = mDBiv[i];
+      f.ax() = mAVec.data(0)[i];
+      f.ab() = mABiv.data(0)[i];
+      return f;
+    }
+
+    /// Scatter frame f into slot i
+    void set( size_t i, const Frame& f ){
+      mPos.set( i, f.pos() );
+      mRot.set( i, f.rot() );
+      mDVec.set( i, f.dx() );
+      mDBiv.set( i, f.db() );
+      mScale.data(0)[i] = f.scale();
+      mAVec.data(0)[i] = f.ax();
+      mABiv.data(0)[i] = f.ab();
+    }
+
+    /// Copy out into a container of Frames
+    template<class C>
+    void copyTo( C& c ) const {
+      c.resize( size() );
+      for (size_t i = 0; i < size(); ++i) c[i] = frame( i );
+    }
+
+    /// The arrays themselves
+    PntBatch& pos() { return mPos; }
+    const PntBatch& pos() const { return mPos; }
+    RotBatch& rot() { return mRot; }
+    const RotBatch& rot() const { return mRot; }
+    VecBatch& dx() { return mDVec; }
+    const VecBatch& dx() const { return mDVec; }
+    BivBatch& db() { return mDBiv; }
+    const BivBatch& db() const { return mDBiv; }
+    ScaBatch& scale() { return mScale; }
+    const ScaBatch& scale() const { return mScale; }
+    ScaBatch& ax() { return mAVec; }
+    const ScaBatch& ax() const { return mAVec; }
+    ScaBatch& ab() { return mABiv; }
+    const ScaBatch& ab() const { return mABiv; }
+
+    /*-----------------------------------------------------------------------------
+     *  INTEGRATION: each as the Frame method of the same name, on every frame
+     *-----------------------------------------------------------------------------*/
+    /// Move and Spin
+    template<class P>
+    FrameArray& step( const P& policy ){
+      blocks( policy, [this]( size_t b, size_t e ){ moveBlocks( b, e ); spinBlocks( b, e ); } );
+      return *this;
+    }
+
+    /// Translation step (translate by velocity vector, then damp it)
+    template<class P>
+    FrameArray& move( const P& policy ){
+      blocks( policy, [this]( size_t b, size_t e ){ moveBlocks( b, e ); } );
+      return *this;
+    }
+
+    /// Spin step (rotate by the exponential of the rotational velocity, then damp it)
+    template<class P>
+    FrameArray& spin( const P& policy ){
+      blocks( policy, [this]( size_t b, size_t e ){ spinBlocks( b, e ); } );
+      return *this;
+    }
+
+    /// Twist every frame by motor m
+    template<class P>
+    FrameArray& twist( const P& policy, const Mot& m ){
+      auto tm = CGAMV<5, decltype( lanes(m) )>( lanes(m) );
+      blocks( policy, [&]( size_t b, size_t e ){
+        const double * in[ PntBatch::Num ]; double * out[ PntBatch::Num ];
+        arrays( mPos, b * Width, in ); arrays( mPos, b * Width, out );
+        simd::kernels().spPnt( m.val, in, out, count( b, e ) );
+        for (size_t j = b; j < e; ++j) mRot.store( j, mRot.block(j).sp( tm ) );
+      });
+      return *this;
+    }
+
+    /// Twist every frame by the motor of dual line d
+    template<class P>
+    FrameArray& twist( const P& policy, const Dll& d ){ return twist( policy, Gen::mot( d ) ); }
+
+    /// Twist frame i by motor i of m (of the same size)
+    template<class P>
+    FrameArray& twist( const P& policy, const NMotBatch<5>& m ){
+      blocks( policy, [&]( size_t b, size_t e ){
+        for (size_t j = b; j < e; ++j){
+          auto tm = m.block(j);
+          mPos.store( j, mPos.block(j).sp( tm ) );
+          mRot.store( j, mRot.block(j).sp( tm ) );
+        }
+      });
+      return *this;
+    }
+
+    /// Twist frame i by the motor of dual line i of d (of the same size)
+    template<class P>
+    FrameArray& twist( const P& policy, const NDllBatch<5>& d ){
+      NMotBatch<5> m( d.size() );
+      blocks( policy, [&]( size_t b, size_t e ){
+        const double * in[ NDllBatch<5>::Num ]; double * out[ NMotBatch<5>::Num ];
+        arrays( d, b * Width, in ); arrays( m, b * Width, out );
+        simd::kernels().mot[ simd::Full ]( in, out, count( b, e ) );
+      });
+      return twist( policy, m );
+    }
+
+    /// Boost every frame by b, relocate the points and renormalize the rotors
+    template<class P>
+    FrameArray& boost( const P& policy, const Bst& bst ){
+      auto tb = CGAMV<5, decltype( lanes(bst) )>( lanes(bst) );
+      blocks( policy, [&]( size_t b, size_t e ){
+        for (size_t j = b; j < e; ++j){
+          //Ro::loc of a point: Euclidean part over the weight on the origin
+          auto p = mPos.block(j).sp( tb );
+          Pack w = Pack( 1.0 ) / p[3];
+          null( j, p[0] * w, p[1] * w, p[2] * w );
+
+          //unit(): over sqrt( |wt| ), unless that is zero
+          auto r = mRot.block(j).sp( tb );
+          Pack wt = ( r <= r )[0], s;
+          for (int l = 0; l < Width; ++l){
+            VT t = sqrt( fabs( wt[l] ) );
+            s[l] = t == 0 ? 0 : 1.0 / t;
+          }
+          for (int k = 0; k < RotBatch::Num; ++k) r[k] *= s;
+          mRot.store( j, r );
+        }
+      });
+      return *this;
+    }
+
+    /// Boost every frame by the boost of point pair p
+    template<class P>
+    FrameArray& boost( const P& policy, const Par& p ){ return boost( policy, Gen::bst( p ) ); }
+
+    FrameArray& step(){ return step( par::par ); }
+    FrameArray& move(){ return move( par::par ); }
+    FrameArray& spin(){ return spin( par::par ); }
+    FrameArray& twist( const Mot& m ){ return twist( par::par, m ); }
+    FrameArray& twist( const Dll& d ){ return twist( par::par, d ); }
+    FrameArray& twist( const NMotBatch<5>& m ){ return twist( par::par, m ); }
+    FrameArray& twist( const NDllBatch<5>& d ){ return twist( par::par, d ); }
+    FrameArray& boost( const Bst& b ){ return boost( par::par, b ); }
+    FrameArray& boost( const Par& p ){ return boost( par::par, p ); }
+
+    /*-----------------------------------------------------------------------------
+     *  MATRICES: Xf::mat( rot, vec, scale ) of every frame, e.g. for instanced drawing
+     *-----------------------------------------------------------------------------*/
+    template<class P>
+    void mats( const P& policy, gfx::Mat4f * out ) const {
+      par::for_each_index( policy, size(), [&]( size_t i ){
+        out[i] = Xf::mat( mRot[i], Vec( mPos[i] ), mScale.data(0)[i] );
+      });
+    }
+
+    std::vector<gfx::Mat4f> mats() const {
+      std::vector<gfx::Mat4f> r( size() );
+      mats( par::par, r.data() );
+      return r;
+    }
+
+    private:
+
+    void moveBlocks( size_t b, size_t e ){
+      for (size_t j = b; j < e; ++j){
+        size_t o = j * Width;
+        null( j, Pack::load( mPos.data(0) + o ) + Pack::load( mDVec.data(0) + o ),
+                 Pack::load( mPos.data(1) + o ) + Pack::load( mDVec.data(1) + o ),
+                 Pack::load( mPos.data(2) + o ) + Pack::load( mDVec.data(2) + o ) );
+      }
+      damp( mDVec, mAVec, b, e );
+    }
+
+    /// Rotors of the velocities go through a buffer of Buf blocks on the stack
+    void spinBlocks( size_t b, size_t e ){
+      static const size_t Buf = 8;
+      alignas( 64 ) double buf[ RotBatch::Num ][ Buf * Width ];
+      double * out[ RotBatch::Num ];
+      for (int k = 0; k < RotBatch::Num; ++k) out[k] = buf[k];
+      const double * in[ BivBatch::Num ];
+
+      for (size_t c = b; c < e; c += Buf){
+        size_t ce = std::min( e, c + Buf );
+        arrays( mDBiv, c * Width, in );
+        simd::kernels().rot[ simd::Full ]( in, out, ( ce - c ) * Width );
+        for (size_t j = c; j < ce; ++j){
+          RotBatch::PackElem g;
+          for (int k = 0; k < RotBatch::Num; ++k) g[k] = Pack::load( buf[k] + ( j - c ) * Width );
+          mRot.store( j, g * mRot.block(j) );
+        }
+      }
+      damp( mDBiv, mABiv, b, e );
+    }
+
+    friend class FrameRef;
+  };
+
+
+  inline Pnt FrameRef::pos() const { return mArray->mPos[mIdx]; }
+  inline Rot FrameRef::rot() const { return mArray->mRot[mIdx]; }
+  inline VT FrameRef::scale() const { return mArray->mScale.data(0)[mIdx]; }
+  inline Vec FrameRef::dx() const { return mArray->mDVec[mIdx]; }
+  inline Biv FrameRef::db() const { return mArray->mDBiv[mIdx]; }
+  inline VT FrameRef::ax() const { return mArray->mAVec.data(0)[mIdx]; }
+  inline VT FrameRef::ab() const { return mArray->mABiv.data(0)[mIdx]; }
+
+  inline FrameRef& FrameRef::pos( const Pnt& p ){ mArray->mPos.set( mIdx, p ); return *this; }
+  inline FrameRef& FrameRef::rot( const Rot& r ){ mArray->mRot.set( mIdx, r ); return *this; }
+  inline FrameRef& FrameRef::scale( VT s ){ mArray->mScale.data(0)[mIdx] = s; return *this; }
+  inline FrameRef& FrameRef::dx( const Vec& v ){ mArray->mDVec.set( mIdx, v ); return *this; }
+  inline FrameRef& FrameRef::db( const Biv& b ){ mArray->mDBiv.set( mIdx, b ); return *this; }
+  inline FrameRef& FrameRef::ax( VT a ){ mArray->mAVec.data(0)[mIdx] = a; return *this; }
+  inline FrameRef& FrameRef::ab( VT a ){ mArray->mABiv.data(0)[mIdx] = a; return *this; }
+
+  inline Frame FrameRef::frame() const { return mArray->frame( mIdx ); }
+  inline FrameRef& FrameRef::operator = ( const Frame& f ){ mArray->set( mIdx, f ); return *this; }
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_cga3D_frameArray_INC  ----- */
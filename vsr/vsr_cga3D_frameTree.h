@@ -0,0 +1,210 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_cga3D_frameTree.h
+ *
+ *    Description:  a tree of motors (scene graph): world = world of parent * local,
+ *                  recomputed only below the nodes that changed
+ *
+ *                  FrameTree tree;
+ *                  int arm  = tree.add( base.mot() );            //a root
+ *                  int hand = tree.add( grip.mot(), arm );       //child of arm
+ *                  tree.local( arm, m );                          //marks arm's subtree
+ *                  tree.update();                                 //recomputes arm and hand
+ *                  Frame f = tree.frame( hand );
+ *
+ *                  Nodes live in flat arrays (parent, first child, next sibling) indexed
+ *                  by the order they were added, a parent before its children.  update()
+ *                  walks down from the changed nodes a level at a time, recomputing only
+ *                  them and what hangs below them.  The nodes of one level depend only on
+ *                  the level above, so under par::par (the default) a wide level is shared
+ *                  out among the pool's threads; either policy gives the same motors.
+ *
+ *                  Chains sit on top of a tree as runs of consecutive nodes, node k
+ *                  holding link(k-1) * joint(k):
+ *
+ *                  int a = tree.add( chainA );                    //root: base * joint(0)
+ *                  int t = tree.add( !chainA.joint(3).rot(), a + 3 );
+ *                  int b = tree.add( chainB, t );                 //chainB based on chainA[3]
+ *                  tree.pull( a, chainA ); tree.pull( b, chainB ); //new joint motors
+ *                  tree.update();
+ *                  tree.push( a, chainA ); tree.push( b, chainB ); //absolute frames
+ *
+ *                  which is how Bennett::linkAt ties two linkages together, kept up
+ *                  to date without refreshing the chain that did not move.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_cga3D_frameTree_INC
+#define  vsr_cga3D_frameTree_INC
+
+#include <algorithm>
+#include <vector>
+
+#include "vsr_cga3D_frame.h"
+#include "vsr_chain.h"
+#include "vsr_par.h"
+
+namespace vsr {
+
+  /*!
+   *  \brief  Hierarchy of relative motors, with absolute motors kept up to date lazily
+   */
+  class FrameTree {
+
+    vector<int> mParent;          ///< parent of each node (-1: a root)
+    vector<int> mDepth;           ///< level of each node (0: a root)
+    vector<int> mChild;           ///< first child of each node (-1: a leaf)
+    vector<int> mSibling;         ///< next child of the same parent (-1: the last)
+    vector<Mot> mLocal;           ///< relative to the parent
+    vector<Mot> mWorld;           ///< absolute (valid after update())
+    vector<char> mDirty;          ///< local motor set since the last update()
+    vector<unsigned> mMoved;      ///< update() that last recomputed the world motor
+    vector<int> mPending;         ///< dirty nodes, in the order they were marked
+    vector<int> mCur, mNext;      ///< nodes of the level being recomputed, and of the next
+    unsigned mTick;               ///< count of update()s
+
+    void visit( int i ){
+      int p = mParent[i];
+      mWorld[i] = p < 0 ? mLocal[i] : mWorld[p] * mLocal[i];
+      mMoved[i] = mTick;
+      mDirty[i] = 0;
+    }
+
+    void visit( const par::Sequential&, const vector<int>& level ){
+      for (int i : level) visit( i );
+    }
+
+    void visit( const par::Parallel& p, const vector<int>& level ){
+      if ( level.size() < MinParallel ) return visit( par::seq, level );
+      par::for_each_index( p, level.size(), [&]( size_t k ){ visit( level[k] ); } );
+    }
+
+    public:
+
+    /// Levels of fewer nodes than this are visited on the calling thread under par::par
+    static const size_t MinParallel = 256;
+
+    FrameTree() : mTick( 0 ) {}
+
+    int size() const { return mParent.size(); }
+
+    int parent( int i ) const { return mParent[i]; }
+    int depth( int i ) const { return mDepth[i]; }
+    int child( int i ) const { return mChild[i]; }      ///< first child (-1: none)
+    int sibling( int i ) const { return mSibling[i]; }  ///< next child of parent( i ) (-1: none)
+
+    /// True if some world motor is out of date
+    bool dirty() const { return !mPending.empty(); }
+
+    void reserve( int n ){
+      mParent.reserve( n ); mDepth.reserve( n ); mChild.reserve( n ); mSibling.reserve( n );
+      mLocal.reserve( n ); mWorld.reserve( n ); mDirty.reserve( n ); mMoved.reserve( n );
+    }
+
+    void clear(){
+      mParent.clear(); mDepth.clear(); mChild.clear(); mSibling.clear();
+      mLocal.clear(); mWorld.clear(); mDirty.clear(); mMoved.clear(); mPending.clear();
+    }
+
+    /// Add a node under parent (-1: a new root), returns its index
+    int add( const Mot& local = Mot( 1, 0, 0, 0, 0, 0, 0, 0 ), int parent = -1 ){
+      int i = size();
+      mParent.push_back( parent );
+      mDepth.push_back( parent < 0 ? 0 : mDepth[parent] + 1 );
+      mChild.push_back( -1 );
+      mSibling.push_back( parent < 0 ? -1 : mChild[parent] );
+      if ( parent >= 0 ) mChild[parent] = i;
+      mLocal.push_back( local );
+      mWorld.push_back( local );
+      mDirty.push_back( 1 );
+      mMoved.push_back( 0 );
+      mPending.push_back( i );
+      return i;
+    }
+
+    /// Motor relative to the parent
+    const Mot& local( int i ) const { return mLocal[i]; }
+    /// Set the motor relative to the parent: node i and all below it are out of date
+    void local( int i, const Mot& m ){
+      mLocal[i] = m;
+      if ( !mDirty[i] ){ mDirty[i] = 1; mPending.push_back( i ); }
+    }
+
+    /// Absolute motor, as of the last update()
+    const Mot& world( int i ) const { return mWorld[i]; }
+    /// Absolute frame, as of the last update()
+    Frame frame( int i ) const { return Frame( mWorld[i] ); }
+
+    /*!
+     *  Recompute the world motors of changed nodes and of all below them, a level at a
+     *  time from the highest changed node: each level is the children of the last one,
+     *  and the changed nodes at that depth not already among them.  Costs in proportion
+     *  to the nodes recomputed, not to the size of the tree.
+     */
+    template<class P>
+    void update( const P& policy ){
+      if ( mPending.empty() ) return;
+      ++mTick;
+      auto shallower = [&]( int a, int b ){ return mDepth[a] < mDepth[b]; };
+      if ( !std::is_sorted( mPending.begin(), mPending.end(), shallower ) )
+        std::stable_sort( mPending.begin(), mPending.end(), shallower );
+
+      size_t next = 0;
+      mCur.clear();
+      for (int d = mDepth[ mPending[0] ]; !mCur.empty() || next < mPending.size(); ++d){
+        if ( mCur.empty() ) d = mDepth[ mPending[next] ];
+        for (; next < mPending.size() && mDepth[ mPending[next] ] == d; ++next){
+          int i = mPending[next], p = mParent[i];
+          if ( p < 0 || mMoved[p] != mTick ) mCur.push_back( i );
+        }
+        visit( policy, mCur );
+        mNext.clear();
+        for (int i : mCur)
+          for (int c = mChild[i]; c >= 0; c = mSibling[c]) mNext.push_back( c );
+        mCur.swap( mNext );
+      }
+      mPending.clear();
+    }
+
+    void update(){ update( par::par ); }
+
+    /*-----------------------------------------------------------------------------
+     *  Chains: node first + k holds link(k-1) * joint(k) (a root's first node also
+     *  holds the chain's base frame; under a parent the parent is the base)
+     *-----------------------------------------------------------------------------*/
+
+    /// Add the joints of a chain as consecutive nodes, returns the first
+    int add( const Chain& c, int parent = -1 ){
+      int first = size();
+      for (int k = 0; k < c.num(); ++k)
+        add( Mot(), k == 0 ? parent : first + k - 1 );
+      pull( first, c );
+      return first;
+    }
+
+    /// Read a chain's joint and link motors into nodes first...; only those that differ are marked
+    void pull( int first, const Chain& c ){
+      for (int k = 0; k < c.num(); ++k){
+        Mot m = c.rel( k );
+        if ( k == 0 && mParent[first] < 0 ) m = c.baseFrame().mot() * m;
+        int i = first + k;
+        bool same = true;
+        for (int j = 0; j < Mot::Num && same; ++j) same = m[j] == mLocal[i][j];
+        if ( !same ) local( i, m );
+      }
+    }
+
+    /// Write the world motors of nodes first... into a chain's absolute frames
+    void push( int first, Chain& c ) const {
+      for (int k = 0; k < c.num(); ++k) c.frame( k ).mot( mWorld[first + k] );
+    }
+
+  };
+
+} // vsr::
+
+#endif   /* ----- #ifndef vsr_cga3D_frameTree_INC  ----- */
@@ -0,0 +1,329 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_cga3D_kernels.h
+ *
+ *    Description:  hand written SIMD kernels for the hottest products of CGA<5>
+ *
+ *                  Rot * Rot, Mot * Mot and Dll.sp( Mot ), and Gen::mot( Dll ) in
+ *                  closed form.  Pnt.sp( Mot ) and Pnt <= Pnt keep their instruction
+ *                  lists: products with no are not indexed by xor (see kernel::Xor),
+ *                  and neither a kernel for them nor a SIMD dot of five terms beat the
+ *                  lists in bench/xKernels.cpp.
+ *
+ *                  Included by vsr_products.h when VSR_KERNELS is defined (make
+ *                  KERNELS=1), which must then hold for every translation unit of a
+ *                  program.  Kernels use AVX-512F, AVX2 or SSE4.1, whichever is the
+ *                  widest enabled (-march=native); with none of them every product
+ *                  keeps its instruction list.  Every other pair, and every scalar type
+ *                  but double, always does.  bench/xKernels.cpp checks each kernel
+ *                  against its instruction list.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_cga3D_kernels_INC
+#define  vsr_cga3D_kernels_INC
+
+#include <math.h>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#define VSR_KERNELS_ON
+#include <immintrin.h>
+#endif
+
+#include "vsr_products.h"
+
+namespace vsr {
+
+namespace kernel {
+
+  typedef CGA<5>::M M;
+
+  typedef CGA<5>::Rot Rot;    // s, e12, e13, e23
+  typedef CGA<5>::Mot Mot;    // s, e12, e13, e23, e1ni, e2ni, e3ni, e123ni
+  typedef CGA<5>::Dll Dll;    // e12, e13, e23, e1ni, e2ni, e3ni
+
+  /// N coefficients padded to whole registers and aligned for aligned loads
+  template<int N>
+  struct alignas(64) Pad {
+    double val[ ( N + 7 ) & ~7 ];
+  };
+
+  /*!
+   *  Gen::mot in closed form: with B the bivector part of d (norm c) and n the unit
+   *  normal of B, the translation splits into (t.n) n and the rest, and
+   *  exp(d) = cos c + sin c B/c + ni ( (t.n) n cos c + (t - (t.n) n) sinc c + (t.n) sin c I ).
+   */
+  template<class R, class D>
+  R mot( const D& d ){
+    double w = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+    if ( w == 0 ) return R( 1, 0, 0, 0, d[3], d[4], d[5], 0 );
+
+    double c = sqrt( w );
+    double sc = sin( c ), cc = cos( c ), sinc = sc / c;
+    double n0 = d[2] / c, n1 = -d[1] / c, n2 = d[0] / c;
+    double tn = d[3] * n0 + d[4] * n1 + d[5] * n2;
+    double k = tn * ( cc - sinc );
+
+    return R( cc, d[0] * sinc, d[1] * sinc, d[2] * sinc,
+      d[3] * sinc + n0 * k, d[4] * sinc + n1 * k, d[5] * sinc + n2 * k, tn * sc );
+  }
+
+#ifdef VSR_KERNELS_ON
+
+  template<int X> struct QuadPerm;
+
+#if defined(__AVX2__)
+
+  /// four doubles in one ymm register
+  struct Quad {
+    __m256d v;
+
+    static Quad loadu( const double * p ){ Quad r; r.v = _mm256_loadu_pd( p ); return r; }
+    void storeu( double * p ) const { _mm256_storeu_pd( p, v ); }
+
+    static Quad set1( double s ){ Quad r; r.v = _mm256_set1_pd( s ); return r; }
+    static Quad set( double a, double b, double c, double d ){ Quad r; r.v = _mm256_setr_pd( a, b, c, d ); return r; }
+
+    /// lane k of the result is lane k ^ X of this
+    template<int X> Quad perm() const { return QuadPerm< X & 3 >::of( *this ); }
+
+    Quad operator * ( const Quad& b ) const { Quad r; r.v = _mm256_mul_pd( v, b.v ); return r; }
+    Quad operator + ( const Quad& b ) const { Quad r; r.v = _mm256_add_pd( v, b.v ); return r; }
+
+    /// this + a * b
+    Quad fma( const Quad& a, const Quad& b ) const {
+      Quad r;
+#ifdef __FMA__
+      r.v = _mm256_fmadd_pd( a.v, b.v, v );
+#else
+      r.v = _mm256_add_pd( v, _mm256_mul_pd( a.v, b.v ) );
+#endif
+      return r;
+    }
+  };
+
+  template<> struct QuadPerm<0>{ static Quad of( const Quad& q ){ return q; } };
+  template<> struct QuadPerm<1>{ static Quad of( const Quad& q ){ Quad r; r.v = _mm256_permute_pd( q.v, 0x5 ); return r; } };
+  template<> struct QuadPerm<2>{ static Quad of( const Quad& q ){ Quad r; r.v = _mm256_permute4x64_pd( q.v, 0x4E ); return r; } };
+  template<> struct QuadPerm<3>{ static Quad of( const Quad& q ){ Quad r; r.v = _mm256_permute4x64_pd( q.v, 0x1B ); return r; } };
+
+#else
+
+  /// four doubles in two xmm registers
+  struct Quad {
+    __m128d lo, hi;
+
+    static Quad loadu( const double * p ){ Quad r; r.lo = _mm_loadu_pd( p ); r.hi = _mm_loadu_pd( p + 2 ); return r; }
+    void storeu( double * p ) const { _mm_storeu_pd( p, lo ); _mm_storeu_pd( p + 2, hi ); }
+
+    static Quad set1( double s ){ Quad r; r.lo = r.hi = _mm_set1_pd( s ); return r; }
+    static Quad set( double a, double b, double c, double d ){ Quad r; r.lo = _mm_setr_pd( a, b ); r.hi = _mm_setr_pd( c, d ); return r; }
+
+    /// lane k of the result is lane k ^ X of this
+    template<int X> Quad perm() const { return QuadPerm< X & 3 >::of( *this ); }
+
+    Quad operator * ( const Quad& b ) const { Quad r; r.lo = _mm_mul_pd( lo, b.lo ); r.hi = _mm_mul_pd( hi, b.hi ); return r; }
+    Quad operator + ( const Quad& b ) const { Quad r; r.lo = _mm_add_pd( lo, b.lo ); r.hi = _mm_add_pd( hi, b.hi ); return r; }
+
+    /// this + a * b
+    Quad fma( const Quad& a, const Quad& b ) const { return *this + a * b; }
+  };
+
+  template<> struct QuadPerm<0>{ static Quad of( const Quad& q ){ return q; } };
+  template<> struct QuadPerm<1>{ static Quad of( const Quad& q ){ Quad r; r.lo = _mm_shuffle_pd( q.lo, q.lo, 1 ); r.hi = _mm_shuffle_pd( q.hi, q.hi, 1 ); return r; } };
+  template<> struct QuadPerm<2>{ static Quad of( const Quad& q ){ Quad r; r.lo = q.hi; r.hi = q.lo; return r; } };
+  template<> struct QuadPerm<3>{ static Quad of( const Quad& q ){ Quad r; r.lo = _mm_shuffle_pd( q.hi, q.hi, 1 ); r.hi = _mm_shuffle_pd( q.lo, q.lo, 1 ); return r; } };
+
+#endif
+
+#if defined(__AVX512F__)
+
+  /// eight doubles in one zmm register
+  struct Oct {
+    __m512d v;
+
+    static Oct loadu( const double * p ){ Oct r; r.v = _mm512_loadu_pd( p ); return r; }
+    void storeu( double * p ) const { _mm512_storeu_pd( p, v ); }
+
+    static Oct set1( double s ){ Oct r; r.v = _mm512_set1_pd( s ); return r; }
+    static Oct set( double a, double b, double c, double d, double e, double f, double g, double h ){
+      Oct r; r.v = _mm512_setr_pd( a, b, c, d, e, f, g, h ); return r;
+    }
+
+    /// lane k of the result is lane k ^ X of this
+    template<int X> Oct perm() const {
+      Oct r; r.v = _mm512_permutexvar_pd( _mm512_setr_epi64( X, 1 ^ X, 2 ^ X, 3 ^ X, 4 ^ X, 5 ^ X, 6 ^ X, 7 ^ X ), v ); return r;
+    }
+
+    Oct operator * ( const Oct& b ) const { Oct r; r.v = _mm512_mul_pd( v, b.v ); return r; }
+    Oct operator + ( const Oct& b ) const { Oct r; r.v = _mm512_add_pd( v, b.v ); return r; }
+
+    /// this + a * b
+    Oct fma( const Oct& a, const Oct& b ) const { Oct r; r.v = _mm512_fmadd_pd( a.v, b.v, v ); return r; }
+  };
+
+#else
+
+  /// eight doubles in two quads
+  struct Oct {
+    Quad lo, hi;
+
+    static Oct loadu( const double * p ){ Oct r; r.lo = Quad::loadu( p ); r.hi = Quad::loadu( p + 4 ); return r; }
+    void storeu( double * p ) const { lo.storeu( p ); hi.storeu( p + 4 ); }
+
+    static Oct set1( double s ){ Oct r; r.lo = r.hi = Quad::set1( s ); return r; }
+    static Oct set( double a, double b, double c, double d, double e, double f, double g, double h ){
+      Oct r; r.lo = Quad::set( a, b, c, d ); r.hi = Quad::set( e, f, g, h ); return r;
+    }
+
+    /// lane k of the result is lane k ^ X of this
+    template<int X> Oct perm() const {
+      Oct r; r.lo = ( X & 4 ? hi : lo ).template perm<X>(); r.hi = ( X & 4 ? lo : hi ).template perm<X>(); return r;
+    }
+
+    Oct operator * ( const Oct& b ) const { Oct r; r.lo = lo * b.lo; r.hi = hi * b.hi; return r; }
+    Oct operator + ( const Oct& b ) const { Oct r; r.lo = lo + b.lo; r.hi = hi + b.hi; return r; }
+
+    /// this + a * b
+    Oct fma( const Oct& a, const Oct& b ) const { Oct r; r.lo = lo.fma( a.lo, b.lo ); r.hi = hi.fma( a.hi, b.hi ); return r; }
+  };
+
+#endif
+
+  /// a register of the first four or all eight values
+  inline Quad lanes( const Quad *, double a, double b, double c, double d, double, double, double, double ){ return Quad::set( a, b, c, d ); }
+  inline Oct lanes( const Oct *, double a, double b, double c, double d, double e, double f, double g, double h ){ return Oct::set( a, b, c, d, e, f, g, h ); }
+
+  /*!
+   *  r = a * b for blade lists of 4 or 8 blades indexed as a group under xor: blade k of R
+   *  is blade i of A times blade i ^ k of B, for every i (as Rot and Mot are).  Each
+   *  coefficient of one side scales a signed permutation of the other, one fma per
+   *  register.  left() broadcasts a and permutes b, right() the converse, so that the
+   *  result of one product can stay in a register as either side of the next.  Signs
+   *  come from the Cayley table, terms with no nonzero sign are dropped, and two
+   *  accumulators halve the chain of fmas.  RevB reads b as ~b.
+   */
+  template<class A, class B, class R, bool RevB = false>
+  struct Xor;
+
+  template<TT ... AS, TT ... BS, TT ... RS, bool RevB>
+  struct Xor< MVT<VT, AS...>, MVT<VT, BS...>, MVT<VT, RS...>, RevB >{
+
+    typedef Cayley< MVT<VT, AS...>, MVT<VT, BS...>, M, true, cayley::GP > Table;
+
+    static const int N = sizeof...(RS);
+    typedef typename std::conditional< N == 8, Oct, Quad >::type V;
+
+    static constexpr TT BladeA[N] = { AS... };
+    static constexpr TT BladeB[N] = { BS... };
+    static constexpr TT BladeR[N] = { RS... };
+
+    /// coefficient of a[i] b[j] in r[i ^ j]
+    static constexpr double Sign( int i, int j ){
+      return i >= N || j >= N ? 0.0 :
+        Table::Coef( BladeA[i], BladeB[j], BladeR[i ^ j] ) * ( RevB && reverse( BladeB[j] ) ? -1.0 : 1.0 );
+    }
+    /// every product of blades lands on the blade its indices say
+    static constexpr bool Closed( int i = 0, int j = 0 ){
+      return i == N ? true : j == N ? Closed( i + 1, 0 ) :
+        ( BladeA[i] ^ BladeB[j] ) == BladeR[i ^ j] && Closed( i, j + 1 );
+    }
+
+    /// coefficient I of one side (a if Left) times the other, permuted by I, if bit I of Mask is set
+    template<int I, bool Left, int Mask>
+    struct Term {
+      static constexpr double S( int k ){ return !( Mask >> I & 1 ) ? 0.0 : Left ? Sign( I, I ^ k ) : Sign( I ^ k, I ); }
+      static constexpr double S0 = S(0), S1 = S(1), S2 = S(2), S3 = S(3), S4 = S(4), S5 = S(5), S6 = S(6), S7 = S(7);
+      static void add( V * r, double x, const V& y ){
+        if ( S0 != 0 || S1 != 0 || S2 != 0 || S3 != 0 || S4 != 0 || S5 != 0 || S6 != 0 || S7 != 0 )
+          r[I & 1] = r[I & 1].fma( V::set1( x ) * lanes( (const V*)0, S0, S1, S2, S3, S4, S5, S6, S7 ), y.template perm<I>() );
+      }
+    };
+
+    template<int I, bool Left, int Mask, bool Done = ( I == N )>
+    struct Terms {
+      static void add( V * r, const double * x, const V& y ){
+        Term< I, Left, Mask >::add( r, x[I], y );
+        Terms< I + 1, Left, Mask >::add( r, x, y );
+      }
+    };
+    template<int I, bool Left, int Mask>
+    struct Terms< I, Left, Mask, true >{
+      static void add( V *, const double *, const V& ){}
+    };
+
+    template<bool Left, int Mask>
+    static V run( const double * x, const V& y ){
+      static_assert( N == 4 || N == 8, "kernel::Xor takes lists of 4 or 8 blades" );
+      static_assert( Closed(), "kernel::Xor blade lists are not indexed by xor" );
+      V r[2] = { V::set1( 0 ), V::set1( 0 ) };
+      Terms< 0, Left, Mask >::add( r, x, y );
+      return r[0] + r[1];
+    }
+
+    /// a * b, a in memory (Mask: the coefficients in memory that may be nonzero)
+    template<int Mask = 0xFF>
+    static V left( const double * a, const V& b ){ return run<true, Mask>( a, b ); }
+    /// a * b, b in memory
+    template<int Mask = 0xFF>
+    static V right( const V& a, const double * b ){ return run<false, Mask>( b, a ); }
+
+    template<class TR, class TA, class TB>
+    static TR make( const TA& a, const TB& b ){
+      TR r;
+      left<>( a.val, V::loadu( b.val ) ).storeu( r.val );
+      return r;
+    }
+  };
+
+  template<TT ... AS, TT ... BS, TT ... RS, bool RevB>
+  constexpr TT Xor< MVT<VT, AS...>, MVT<VT, BS...>, MVT<VT, RS...>, RevB >::BladeA[];
+  template<TT ... AS, TT ... BS, TT ... RS, bool RevB>
+  constexpr TT Xor< MVT<VT, AS...>, MVT<VT, BS...>, MVT<VT, RS...>, RevB >::BladeB[];
+  template<TT ... AS, TT ... BS, TT ... RS, bool RevB>
+  constexpr TT Xor< MVT<VT, AS...>, MVT<VT, BS...>, MVT<VT, RS...>, RevB >::BladeR[];
+
+  /// Dll.sp( Mot ): the dual line as a motor (indices 1 to 6), then ( m * d ) * ~m
+  struct SpDll {
+    typedef Xor< Mot, Mot, Mot > First;
+    typedef Xor< Mot, Mot, Mot, true > Second;
+
+    template<class R, class A, class B>
+    static R make( const A& d, const B& m ){
+      Pad<8> x = {{ 0, d[0], d[1], d[2], d[3], d[4], d[5], 0 }}, u;
+      Second::template right<>( First::template right<0x7E>( Oct::loadu( m.val ), x.val ), m.val ).storeu( u.val );
+      return R( u.val[1], u.val[2], u.val[3], u.val[4], u.val[5], u.val[6] );
+    }
+  };
+
+#endif
+
+} //kernel::
+
+#ifdef VSR_KERNELS_ON
+
+template<>
+struct Kernel< cayley::GP, kernel::Rot, kernel::Rot, kernel::M, true > : kernel::Xor< kernel::Rot, kernel::Rot, kernel::Rot > {
+  static const bool On = true;
+};
+
+template<>
+struct Kernel< cayley::GP, kernel::Mot, kernel::Mot, kernel::M, true > : kernel::Xor< kernel::Mot, kernel::Mot, kernel::Mot > {
+  static const bool On = true;
+};
+
+template<>
+struct Kernel< cayley::SP, kernel::Dll, kernel::Mot, kernel::M, true > : kernel::SpDll {
+  static const bool On = true;
+};
+
+#endif
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_cga3D_kernels_INC  ----- */
@@ -114,14 +114,27 @@ struct  Spherical : public Joint {
      vector<Frame> mFrame;    ///< Absolute frames of Joints = prevFrame  * prevLink *  joint
 
     int mNum;
+
+    vector<Mot> mJointMot;   ///< Joint motors as of the last fk(), to find what changed since
+    vector<Mot> mLinkMot;    ///< Link motors as of the last fk()
+    Mot mBaseMot;            ///< Base motor as of the last fk()
+    int mKnown;              ///< Frames below this agree with the motors above
     
     void _init(){
       for (int i = 0; i < mNum; ++i){
         Vec v(0,1.0,0);
         mLink[i].pos() = Ro::null(v);
       }
+       mJointMot.resize( mNum );
+       mLinkMot.resize( mNum );
+       mKnown = 0;
        fk();
     }
+
+    static bool same(const Mot& a, const Mot& b){
+      for (int i = 0; i < Mot::Num; ++i) if ( a[i] != b[i] ) return false;
+      return true;
+    }
     
     public:
 
@@ -289,7 +302,7 @@ struct  Spherical : public Joint {
       Dll lin(const Pnt& p ) { return Op::dl( mFrame[mNum-1].pos() ^ p ^ Inf(1) ).runit() ; }
 
       /// relative transformation (lagrangian) at kth joint
-      Mot rel(int k){
+      Mot rel(int k) const {
          if (k==0) return mJoint[0].mot();
 
          return mLink[k-1].mot() * mJoint[k].mot();
@@ -298,20 +311,47 @@ struct  Spherical : public Joint {
       void calcBase(){
          Mot mot = mJoint[0].mot();
          mFrame[0].mot( mBaseFrame.mot() * mot  );
+         mKnown = 0;
       }
       
       /// Forward Kinematics: Absolute Concatenations of previous frame, previous link, and current joint
-      void fk() {  
-          Motor mot = mJoint[0].mot();
-          mFrame[0].mot( mBaseFrame.mot() * mot );
-          for (int i = 1; i < mNum; ++i){    
-            Mot rel =  mLink[i-1].mot() * mJoint[i].mot();//mLink[i-1].mot() * mJoint[i].mot();
-            mFrame[i].mot( mFrame[i-1].mot() * rel );// * mFrame[i-1].mot() );// mFrame[i-1].mot() * rel ) ;
+      void fk() { fkFrom( 0 ); }
+
+      /// Forward Kinematics from the lowest joint whose frame changed() (earlier frames are kept).
+      /// Frames written directly (frame(k), fabrik) are not seen: call fk() after those
+      void fkChanged() { fkFrom( changed() ); }
+
+      /// Lowest joint whose frame depends on a base, link or joint motor changed since the last fk() (num() if none)
+      int changed() const {
+        if ( mKnown == 0 || !same( mBaseFrame.mot(), mBaseMot ) ) return 0;
+        for (int i = 0; i < mKnown; ++i){
+          if ( !same( mJoint[i].mot(), mJointMot[i] ) ) return i;
+          if ( i > 0 && !same( mLink[i-1].mot(), mLinkMot[i-1] ) ) return i;
+        }
+        return mKnown;
+      }
+
+      /// Forward Kinematics from "begin" joint to the last, given the frames before begin
+      void fkFrom(int begin){
+          if ( begin >= mNum ) return;
+          if ( begin == 0 ){
+            mBaseMot = mBaseFrame.mot();
+            mJointMot[0] = mJoint[0].mot();
+            mFrame[0].mot( mBaseMot * mJointMot[0] );
+            begin = 1;
           }
+          for (int i = begin; i < mNum; ++i){    
+            mLinkMot[i-1] = mLink[i-1].mot();
+            mJointMot[i] = mJoint[i].mot();
+            Mot rel =  mLinkMot[i-1] * mJointMot[i];
+            mFrame[i].mot( mFrame[i-1].mot() * rel );
+          }
+          mKnown = mNum;
       }        
         
       /// Forward Kinematics: calculate forward to "end" joint
       void fk(int end){
+        mKnown = 0;
        
         Mot mot = mJoint[0].mot();
         mFrame[0].mot( mBaseFrame.mot() * mot  );
@@ -325,6 +365,7 @@ struct  Spherical : public Joint {
 
       /// Forward Kinematics: calculate forward from "begin" to "end" joint
       void fk(int begin, int end){
+        mKnown = 0;
               
         for (int i = begin; i < end; ++i){
           Mot m =  mFrame[i-1].mot()  * mLink[i-1].mot() * mJoint[i].mot();
@@ -355,9 +396,9 @@ struct  Spherical : public Joint {
                     Pnt tmpBase = base;
                     
                     //some objects
-                    static Dls dls; //surround
-                    static Dll dll; //line
-                    static Par par; //intersection of line ^ surround
+                    Dls dls; //surround
+                    Dll dll; //line
+                    Par par; //intersection of line ^ surround
                     
                     //forward reaching
                     for (int i = end; i < begin; ++i){
@@ -407,9 +448,9 @@ struct  Spherical : public Joint {
                     Pnt tmpGoal = goal;
                     Pnt tmpBase = base;
                     
-                    static Dls dls; //surround
-                    static Dll dll; //line
-                    static Par par; //intersection of line ^ surround
+                    Dls dls; //surround
+                    Dll dll; //line
+                    Par par; //intersection of line ^ surround
                     
                     //backward reaching
                     for (int i = end; i > begin; --i){
@@ -442,6 +483,8 @@ struct  Spherical : public Joint {
             /// Derive Joint Rotations from Current Positions
             void calcJoints(int start = 0){
 
+                mKnown = 0;
+
                 Vec t = mBaseFrame.y(); // Vec::y;
                 Rot R = mBaseFrame.rot(); // (1,0,0,0);
                 
@@ -0,0 +1,178 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_chain_batch.h
+ *
+ *    Description:  forward kinematics of one Chain under many joint configurations
+ *
+ *                  ChainBatch cb( chain.num(), n );
+ *                  cb.fk( chain, angles );       //angles[k][i]: joint k of configuration i
+ *                  Mot m = cb.frame( k, i );      //= chain.frame( k ).mot() for that configuration
+ *
+ *                  Configurations are laid out as structures of arrays (vsr_batch.h): the
+ *                  absolute motors of joint k over every configuration live in one
+ *                  NMotBatch<5>, and a block of Width configurations is carried through
+ *                  the chain at once, sharing the base and link motors broadcast into
+ *                  every lane.  Joints are given either as motors, joints[k][i] taking
+ *                  the place of chain.joint( k ).mot(), or as angles of revolute joints,
+ *                  turning chain.joint( k ) about its own z axis as Frame::rotXY does.
+ *
+ *                  Under par::par (the default) blocks of configurations are shared out
+ *                  among the pool's threads; each motor is the same under either policy,
+ *                  and agrees with Chain::fk() to rounding.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_chain_batch_INC
+#define  vsr_chain_batch_INC
+
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#include "vsr_chain.h"
+#include "vsr_batch.h"
+#include "vsr_par.h"
+
+namespace vsr {
+
+  /*!
+   *  \brief  Absolute motors of every joint of a chain, for each of many configurations
+   */
+  class ChainBatch {
+
+    public:
+
+    typedef NMotBatch<5> MotBatch;
+    typedef CGAMVBatch<5, CGA<5>::Sca> ScaBatch;
+    typedef MotBatch::PackElem PackMot;
+    typedef NRotBatch<5>::PackElem PackRot;
+    typedef MotBatch::Pack Pack;
+
+    static const int Width = MotBatch::Width;
+
+    private:
+
+    size_t mSize;
+    vector<MotBatch> mFrame;   ///< absolute motor of joint k, per configuration
+
+    /// Blocks per chunk: about par::ChunkBytes of output motors
+    size_t grain( const par::Parallel& p ) const {
+      size_t bytes = Width * sizeof(VT) * MotBatch::Num * ( mFrame.size() ? mFrame.size() : 1 );
+      if ( p.grain ) return ( p.grain + Width - 1 ) / Width;
+      return par::ChunkBytes > bytes ? par::ChunkBytes / bytes : 1;
+    }
+
+    template<class F>
+    void blocks( const par::Sequential&, size_t n, const F& f ){ f( 0, n ); }
+
+    template<class F>
+    void blocks( const par::Parallel& p, size_t n, const F& f ){ p.pool().run( n, grain( p ), f ); }
+
+    /// m over its rotor weight, in every lane (Frame::mot( m ) keeps m / m.rnorm())
+    static PackMot unit( const PackMot& m ){
+      Pack w = m[0] * m[0] + m[1] * m[1] + m[2] * m[2] + m[3] * m[3], s;
+      for (int l = 0; l < Width; ++l) s[l] = w[l] == 0 ? 1 : 1.0 / sqrt( w[l] );
+      PackMot r;
+      for (int k = 0; k < MotBatch::Num; ++k) r[k] = m[k] * s;
+      return r;
+    }
+
+    /// Carry blocks [b, e) through the chain: rel( k, j ) is link(k-1) * joint(k) of block j
+    template<class Rel>
+    void run( size_t b, size_t e, const PackMot& base, const Rel& rel ){
+      for (size_t j = b; j < e; ++j){
+        PackMot f = unit( base * rel( 0, j ) );
+        mFrame[0].store( j, f );
+        for (size_t k = 1; k < mFrame.size(); ++k){
+          f = unit( f * rel( k, j ) );
+          mFrame[k].store( j, f );
+        }
+      }
+    }
+
+    /// Joint turns go through the rotor kernel, Buf blocks at a time, into a buffer on the stack
+    void turnBlocks( size_t b, size_t e, const PackMot& base, const vector<PackMot>& rel, const vector<ScaBatch>& angles ){
+      static const size_t Buf = 8;
+      typedef NRotBatch<5> RotBatch;
+      alignas( 64 ) double buf[ RotBatch::Num ][ Buf * Width ];
+      alignas( 64 ) double zero[ Buf * Width ] = {};
+      double * out[ RotBatch::Num ];
+      for (int k = 0; k < RotBatch::Num; ++k) out[k] = buf[k];
+      PackMot f[ Buf ];
+
+      for (size_t c = b; c < e; c += Buf){
+        size_t ce = std::min( e, c + Buf );
+        for (int k = 0; k < num(); ++k){
+          //Gen::rot( Biv::xy * t ) = cos t - sin t e12
+          const double * in[ NBivBatch<5>::Num ] = { angles[k].data(0) + c * Width, zero, zero };
+          simd::kernels().rot[ simd::Full ]( in, out, ( ce - c ) * Width );
+          for (size_t j = c; j < ce; ++j){
+            PackRot r;
+            for (int l = 0; l < RotBatch::Num; ++l) r[l] = Pack::load( buf[l] + ( j - c ) * Width );
+            f[ j - c ] = unit( ( k == 0 ? base : f[ j - c ] ) * ( rel[k] * r ) );
+            mFrame[k].store( j, f[ j - c ] );
+          }
+        }
+      }
+    }
+
+    public:
+
+    ChainBatch( int joints = 0, size_t n = 0 ) { resize( joints, n ); }
+
+    /// Reallocate for n configurations of a chain of joints joints (contents are zeroed)
+    void resize( int joints, size_t n ){
+      mSize = n;
+      mFrame.resize( joints );
+      for (auto& f : mFrame) f.resize( n );
+    }
+
+    /// Number of configurations
+    size_t size() const { return mSize; }
+    /// Number of joints
+    int num() const { return mFrame.size(); }
+
+    /// Absolute motors of joint k, over every configuration
+    const MotBatch& frame( int k ) const { return mFrame[k]; }
+    /// Absolute motor of joint k in configuration i
+    Mot frame( int k, size_t i ) const { return mFrame[k][i]; }
+
+    /// Forward kinematics of chain c with joints[k][i] in place of c.joint( k ).mot() (each of size())
+    template<class P>
+    ChainBatch& fk( const P& policy, const Chain& c, const vector<MotBatch>& joints ){
+      vector<PackMot> link( num() );
+      for (int k = 1; k < num(); ++k) link[k] = lanes( c.link( k - 1 ).mot() );
+      PackMot base = lanes( c.baseFrame().mot() );
+      blocks( policy, mFrame.empty() ? 0 : mFrame[0].blocks(), [&]( size_t b, size_t e ){
+        run( b, e, base, [&]( int k, size_t j ) -> PackMot {
+          return k == 0 ? joints[0].block( j ) : link[k] * joints[k].block( j );
+        });
+      });
+      return *this;
+    }
+
+    /// Forward kinematics of chain c with each c.joint( k ) turned by angles[k][i] about its z axis
+    template<class P>
+    ChainBatch& fk( const P& policy, const Chain& c, const vector<ScaBatch>& angles ){
+      //link(k-1) * joint(k) is the same in every configuration: only the turn differs
+      vector<PackMot> rel( num() );
+      for (int k = 0; k < num(); ++k) rel[k] = lanes( c.rel( k ) );
+      PackMot base = lanes( c.baseFrame().mot() );
+      blocks( policy, mFrame.empty() ? 0 : mFrame[0].blocks(), [&]( size_t b, size_t e ){
+        turnBlocks( b, e, base, rel, angles );
+      });
+      return *this;
+    }
+
+    ChainBatch& fk( const Chain& c, const vector<MotBatch>& joints ){ return fk( par::par, c, joints ); }
+    ChainBatch& fk( const Chain& c, const vector<ScaBatch>& angles ){ return fk( par::par, c, angles ); }
+
+  };
+
+} // vsr::
+
+#endif   /* ----- #ifndef vsr_chain_batch_INC  ----- */
@@ -0,0 +1,342 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_chain_ik.h
+ *
+ *    Description:  damped least squares inverse kinematics of a Chain, with a screw
+ *                  Jacobian read off the dual lines of its joints
+ *
+ *                  ChainIK ik( chain );                 //every joint revolute about its z
+ *                  ik.revolute( 2, -PIOVERFOUR, PIOVERFOUR );
+ *                  ik.spherical( 0 );
+ *                  ChainIK::Result r = ik.solve( target );     //a Frame, Mot or Pnt
+ *                  r.iterations; r.residual; r.converged;
+ *
+ *                  Turning frame k about one of its axes by dt moves every frame after it
+ *                  by Gen::mot( -L * dt ), L the dual line of that axis (Frame::dlz etc.).
+ *                  Seen from the end frame those lines are the columns of the Jacobian,
+ *                  six rows each: three of rotation and three of the velocity of the end
+ *                  point.  The error is the rotor and the position of the target in the
+ *                  end frame, so with orientation weight 0 only the position is sought.
+ *
+ *                  Each step solves ( J J^T + mu ) y = e, six by six, and turns the
+ *                  joints by J^T y (Levenberg-Marquardt): mu shrinks after a step that
+ *                  lowers the residual and grows after one that does not (which is
+ *                  undone).  Revolute joints keep an angle in the units of Frame::rotXY
+ *                  and Revolute (half the turn) within their limits: a joint that would
+ *                  pass one stops there and the others are solved for again without it.
+ *                  Spherical joints turn about all three of their axes, unlimited.
+ *
+ *                  Solving again from where the last solve stopped (a warm start, the
+ *                  default) takes a step or two for a target that moved a little.  The
+ *                  cost of a step is that of fk() and of the six by n Jacobian.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_chain_ik_INC
+#define  vsr_chain_ik_INC
+
+#include <math.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "vsr_chain.h"
+
+namespace vsr {
+
+  /*!
+   *  \brief  Damped least squares (Levenberg-Marquardt) solver for the joints of a Chain
+   */
+  class ChainIK {
+
+    public:
+
+    enum Type { FIXED, REVOLUTE, SPHERICAL };
+
+    struct Result {
+      int iterations;      ///< steps taken (undone ones included)
+      VT residual;         ///< weighted error left: distance and angle (radians)
+      bool converged;      ///< residual within tol
+    };
+
+    int maxIter;           ///< steps per solve
+    VT tol;                ///< residual to stop at
+    VT posWeight;          ///< weight of the squared distance to the target
+    VT rotWeight;          ///< weight of the squared angle to the target (0: position only)
+    VT damping;            ///< mu of the first step of a solve
+    VT minDamping;         ///< least mu
+    VT maxStep;            ///< largest turn of one joint in one step
+
+    private:
+
+    Chain * mChain;
+    vector<Type> mType;
+    vector<Frame> mRest;   ///< joint( k ) of a revolute joint at angle 0
+    vector<VT> mAngle;     ///< angle of each revolute joint
+    vector<VT> mLo, mHi;   ///< limits of each revolute joint
+
+    vector<int> mJoint;    ///< joint of each column
+    vector<int> mAxis;     ///< axis of each column (0 x, 1 y, 2 z)
+    vector<char> mFree;    ///< column not stopped at a limit in this step
+    vector<VT> mJ;         ///< 6 x columns, row major
+    vector<VT> mStep;      ///< turn of each column
+    vector<VT> mSaveAngle; ///< angles before a step, to undo it
+    vector<Rot> mSaveRot;  ///< rotors of the spherical joints before a step
+
+    /// Dual lines of frame k's axes (Frame::dlx, dly, dlz)
+    static Dll line( const Frame& f, int axis ){
+      return axis == 0 ? f.dlx() : axis == 1 ? f.dly() : f.dlz();
+    }
+
+    /// Euclidean bivector turning about axis (Frame's local dlx, dly, dlz: e23, -e13, e12)
+    static Biv plane( int axis, VT t ){
+      return axis == 0 ? Biv( 0, 0, t ) : axis == 1 ? Biv( 0, -t, 0 ) : Biv( t, 0, 0 );
+    }
+
+    /// Columns of the joints up to end
+    void columns( int end ){
+      mJoint.clear(); mAxis.clear();
+      for (int k = 0; k <= end; ++k){
+        if ( mType[k] == REVOLUTE ){ mJoint.push_back( k ); mAxis.push_back( 2 ); }
+        else if ( mType[k] == SPHERICAL )
+          for (int a = 0; a < 3; ++a){ mJoint.push_back( k ); mAxis.push_back( a ); }
+      }
+      mJ.resize( 6 * mJoint.size() );
+      mStep.resize( mJoint.size() );
+      mFree.resize( mJoint.size() );
+    }
+
+    /// Weighted error of the end frame: target in it, as rotation (2 log) and position
+    void error( const Mot& target, int end, VT * e ) const {
+      Mot d = !mChain->frame( end ).mot() * target;
+      Biv b = Gen::log( Rot( d[0], d[1], d[2], d[3] ) );
+      Pnt v = Ro::null( 0, 0, 0 ).spin( d );
+      VT wr = 2 * sqrt( rotWeight ), wp = sqrt( posWeight );
+      for (int i = 0; i < 3; ++i){ e[i] = wr * b[i]; e[3 + i] = wp * v[i]; }
+    }
+
+    static VT norm( const VT * e ){
+      VT s = 0;
+      for (int i = 0; i < 6; ++i) s += e[i] * e[i];
+      return sqrt( s );
+    }
+
+    /// Jacobian, weighted as error(): column c is -L of its axis, seen from the end frame
+    void jacobian( int end ){
+      Mot inv = !mChain->frame( end ).mot();
+      VT wr = 2 * sqrt( rotWeight ), wp = -2 * sqrt( posWeight );
+      size_t n = mJoint.size();
+      for (size_t c = 0; c < n; ++c){
+        Dll l = line( mChain->frame( mJoint[c] ), mAxis[c] ).spin( inv );
+        for (int i = 0; i < 3; ++i){
+          mJ[ i * n + c ] = -wr * l[i];
+          mJ[ ( 3 + i ) * n + c ] = -wp * l[3 + i];
+        }
+      }
+    }
+
+    /// Step of the free columns for error e (of which the stopped columns' turns are taken out)
+    void solveStep( const VT * e, VT mu ){
+      size_t n = mJoint.size();
+      VT r[6];
+      for (int i = 0; i < 6; ++i){
+        r[i] = e[i];
+        for (size_t c = 0; c < n; ++c) if ( !mFree[c] ) r[i] -= mJ[ i * n + c ] * mStep[c];
+      }
+
+      //A = J J^T + mu over the free columns, then its Cholesky factor in place
+      VT A[6][6];
+      for (int i = 0; i < 6; ++i)
+        for (int j = 0; j <= i; ++j){
+          VT s = i == j ? mu : 0;
+          for (size_t c = 0; c < n; ++c) if ( mFree[c] ) s += mJ[ i * n + c ] * mJ[ j * n + c ];
+          A[i][j] = s;
+        }
+      for (int i = 0; i < 6; ++i){
+        for (int j = 0; j <= i; ++j){
+          VT s = A[i][j];
+          for (int k = 0; k < j; ++k) s -= A[i][k] * A[j][k];
+          A[i][j] = i == j ? sqrt( s > 0 ? s : 0 ) : ( A[j][j] > 0 ? s / A[j][j] : 0 );
+        }
+      }
+      VT y[6];
+      for (int i = 0; i < 6; ++i){
+        VT s = r[i];
+        for (int k = 0; k < i; ++k) s -= A[i][k] * y[k];
+        y[i] = A[i][i] > 0 ? s / A[i][i] : 0;
+      }
+      for (int i = 5; i >= 0; --i){
+        VT s = y[i];
+        for (int k = i + 1; k < 6; ++k) s -= A[k][i] * y[k];
+        y[i] = A[i][i] > 0 ? s / A[i][i] : 0;
+      }
+
+      //turns J^T y, no larger than maxStep
+      VT big = 0;
+      for (size_t c = 0; c < n; ++c){
+        if ( !mFree[c] ) continue;
+        VT s = 0;
+        for (int i = 0; i < 6; ++i) s += mJ[ i * n + c ] * y[i];
+        mStep[c] = s;
+        big = std::max( big, fabs( s ) );
+      }
+      if ( big > maxStep )
+        for (size_t c = 0; c < n; ++c) if ( mFree[c] ) mStep[c] *= maxStep / big;
+    }
+
+    /// Step within the limits: columns that would pass one stop at it, the rest are solved again
+    void limitedStep( const VT * e, VT mu ){
+      size_t n = mJoint.size();
+      std::fill( mFree.begin(), mFree.end(), 1 );
+      for (size_t pass = 0; pass <= n; ++pass){
+        solveStep( e, mu );
+        bool stopped = false;
+        for (size_t c = 0; c < n; ++c){
+          int k = mJoint[c];
+          if ( !mFree[c] || mType[k] != REVOLUTE ) continue;
+          VT t = mAngle[k] + mStep[c];
+          if ( t < mLo[k] || t > mHi[k] ){
+            mStep[c] = std::min( std::max( t, mLo[k] ), mHi[k] ) - mAngle[k];
+            mFree[c] = 0;
+            stopped = true;
+          }
+        }
+        if ( !stopped ) break;
+      }
+    }
+
+    /// Turn the joints by mStep, returns the first joint turned (num() if none)
+    int turn(){
+      int low = mChain->num();
+      for (size_t c = 0; c < mJoint.size(); ++c){
+        if ( mStep[c] == 0 ) continue;
+        int k = mJoint[c];
+        low = std::min( low, k );
+        if ( mType[k] == REVOLUTE ){
+          mAngle[k] += mStep[c];
+          mChain->joint( k ) = mRest[k].rotXY( mAngle[k] );
+        } else {
+          mChain->joint( k ).rot( mChain->joint( k ).rot() * Gen::rot( plane( mAxis[c], mStep[c] ) ) );
+        }
+      }
+      return low;
+    }
+
+    void save(){
+      mSaveAngle = mAngle;
+      mSaveRot.resize( mType.size() );
+      for (size_t k = 0; k < mType.size(); ++k)
+        if ( mType[k] == SPHERICAL ) mSaveRot[k] = mChain->joint( k ).rot();
+    }
+
+    void restore(){
+      for (size_t k = 0; k < mType.size(); ++k){
+        if ( mType[k] == REVOLUTE && mAngle[k] != mSaveAngle[k] ){
+          mAngle[k] = mSaveAngle[k];
+          mChain->joint( k ) = mRest[k].rotXY( mAngle[k] );
+        } else if ( mType[k] == SPHERICAL ) mChain->joint( k ).rot( mSaveRot[k] );
+      }
+    }
+
+    public:
+
+    /// Solver for chain c, every joint revolute about its z axis from where it is now (angle 0)
+    ChainIK( Chain& c ) :
+      maxIter( 32 ), tol( 1e-6 ), posWeight( 1 ), rotWeight( 1 ),
+      damping( 1e-2 ), minDamping( 1e-8 ), maxStep( .5 ),
+      mChain( &c )
+    {
+      VT inf = std::numeric_limits<VT>::infinity();
+      mType.assign( c.num(), REVOLUTE );
+      mAngle.assign( c.num(), 0 );
+      mLo.assign( c.num(), -inf );
+      mHi.assign( c.num(), inf );
+      mRest.resize( c.num() );
+      for (int k = 0; k < c.num(); ++k) mRest[k] = c.joint( k );
+    }
+
+    Chain& chain() { return *mChain; }
+    int num() const { return mType.size(); }
+    Type type( int k ) const { return mType[k]; }
+
+    /// Joint k turns about its z axis from where it is now, between lo and hi
+    ChainIK& revolute( int k, VT lo = -std::numeric_limits<VT>::infinity(), VT hi = std::numeric_limits<VT>::infinity() ){
+      mType[k] = REVOLUTE;
+      mRest[k] = mChain->joint( k );
+      mAngle[k] = 0;
+      mLo[k] = lo; mHi[k] = hi;
+      return *this;
+    }
+    /// Joint k turns about all of its axes
+    ChainIK& spherical( int k ){ mType[k] = SPHERICAL; return *this; }
+    /// Joint k does not move
+    ChainIK& fixed( int k ){ mType[k] = FIXED; return *this; }
+
+    /// Angle of revolute joint k
+    VT angle( int k ) const { return mAngle[k]; }
+    /// Set the angle of revolute joint k (clamped to its limits), e.g. to start a solve from
+    ChainIK& angle( int k, VT t ){
+      mAngle[k] = std::min( std::max( t, mLo[k] ), mHi[k] );
+      mChain->joint( k ) = mRest[k].rotXY( mAngle[k] );
+      return *this;
+    }
+
+    /// Bring frame end (default the last) to target, from the current joints
+    Result solve( const Mot& target, int end = -1 ){
+      if ( end < 0 ) end = mChain->num() - 1;
+      columns( end );
+      mChain->fkChanged();
+
+      Result res = { 0, 0, false };
+      VT e[6];
+      error( target, end, e );
+      res.residual = norm( e );
+      VT mu = damping;
+
+      while ( res.residual > tol && res.iterations < maxIter ){
+        ++res.iterations;
+        jacobian( end );
+        save();
+        limitedStep( e, mu );
+        int low = turn();
+        if ( low == mChain->num() ) break;
+        mChain->fkFrom( low );
+
+        VT e2[6];
+        error( target, end, e2 );
+        VT r = norm( e2 );
+        if ( r < res.residual ){
+          std::copy( e2, e2 + 6, e );
+          res.residual = r;
+          mu = std::max( mu * .5, minDamping );
+        } else {
+          restore();
+          mChain->fkFrom( low );
+          mu *= 4;
+        }
+      }
+      res.converged = res.residual <= tol;
+      return res;
+    }
+
+    Result solve( const Frame& target, int end = -1 ){ return solve( target.mot(), end ); }
+
+    /// Bring frame end to point p, whatever its orientation
+    Result solve( const Pnt& p, int end = -1 ){
+      VT w = rotWeight;
+      rotWeight = 0;
+      Pnt q = Ro::loc( p );
+      Result r = solve( Mot( Gen::trs( q[0], q[1], q[2] ) ), end );
+      rotWeight = w;
+      return r;
+    }
+
+  };
+
+} // vsr::
+
+#endif   /* ----- #ifndef vsr_chain_ik_INC  ----- */
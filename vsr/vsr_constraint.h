@@ -1,3 +1,5 @@
+#include <atomic>
+
 #include "vsr_generic_op.h"
 #include "vsr_set.h"
 
@@ -60,7 +62,7 @@ namespace vsr{
 	template<class T>
 	class Distance : public Constraint {
 
-    static int S_ID;
+    static std::atomic<int> S_ID;
 
     public:
 
@@ -69,8 +71,7 @@ namespace vsr{
 		Distance(T& a, T& b) : a(&a), b(&b), sqLength( Dist(a,b) ) {
       //  cout << sqLength << endl; 
         if (sqLength==0) { a.vprint(); b.vprint(); }
-        id = S_ID;
-        S_ID++;
+        id = S_ID++;
       }
 		
 		T * a; T * b;
@@ -93,7 +94,7 @@ namespace vsr{
 	};   
 
   template<class T>
-  int Distance<T> :: S_ID = 0;
+  std::atomic<int> Distance<T> :: S_ID( 0 );
 	
 	// template<typename T>
 	// struct Solver {
@@ -0,0 +1,102 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_dispatch.h
+ *
+ *    Description:  vectorized batch kernels chosen at run time by the cpu they run on
+ *
+ *                  src/vsr_simd_kernels.cpp is compiled once per instruction set
+ *                  (SSE2, AVX2 + FMA, AVX-512F) into libvsr.a.  The first call to
+ *                  simd::kernels() asks the cpu which it has and keeps the widest
+ *                  table; the environment variable VSR_SIMD=sse2|avx2|avx512 lowers
+ *                  that choice (e.g. to test every level on one machine), and
+ *                  simd::select() does the same from code.
+ *
+ *                  Kernels work on raw structure-of-arrays coefficients of CGA<5>
+ *                  doubles, any length (no padding needed):
+ *
+ *                    spPnt    points spun by one motor        (CGAMVBatch::sp)
+ *                    gpMot    element-wise motor products     (CGAMVBatch::gp)
+ *                    relax    one sweep of the Field stencil  (Field::diffuse, gsSolver)
+ *
+ *                    rot, mot, bst                 Gen::rot, Gen::mot, Gen::bst
+ *                    logRot, logMot, logBst        Gen::log of rotors, motors, boosts
+ *
+ *                  The exponentials and logarithms (see Gen:: in vsr_batch.h) take
+ *                  polynomials in place of libm, one table entry per Accuracy, and
+ *                  select rather than branch on singular arguments.
+ *
+ *                  Programs only see this header; nothing here depends on the flags
+ *                  they are built with.  Off x86 (RPI=1) the SSE2 table is the only
+ *                  one and is built for the native 16 byte vector unit.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_dispatch_INC
+#define  vsr_dispatch_INC
+
+#include <stddef.h>
+
+namespace vsr {
+
+namespace simd {
+
+  enum Level { SSE2 = 0, AVX2 = 1, AVX512 = 2 };
+
+  /// Relative error of the transcendental kernels: about 1e-4, 1e-7 (float), or a few ulp
+  enum Accuracy { Fast = 0, Single = 1, Full = 2 };
+
+  /// One instruction set's build of the kernels
+  struct Kernels {
+
+    Level level;
+    const char * name;
+    int width;           ///< doubles per vector
+
+    /// out = m * in * ~m for n points (in and out are 5 arrays of n, may alias)
+    void (*spPnt)( const double * m, const double * const * in, double * const * out, size_t n );
+
+    /// r = a * b for n motors (8 arrays of n each, r may alias a or b)
+    void (*gpMot)( const double * const * a, const double * const * b, double * const * r, size_t n );
+
+    /// r = f( a ) for n elements, e.g. mot[ Full ]( dll, mot, n ): a and r are arrays of coefficients
+    typedef void (*Map)( const double * const * a, double * const * r, size_t n );
+
+    Map rot[3];        ///< Biv to Rot
+    Map mot[3];        ///< Dll to Mot
+    Map bst[3];        ///< Par to Bst
+    Map logRot[3];     ///< Rot to Biv
+    Map logMot[3];     ///< Mot to Dll
+    Map logBst[3];     ///< Bst to Par
+
+    /*!
+     *  One sweep over the interior of a w x h x d grid of c doubles per cell (k fastest):
+     *  x = ( prev + a * (sum of the six neighbours of x) ) * s.  Each row along k is
+     *  relaxed as a whole, so its k neighbours are those of the previous sweep while
+     *  the i and j neighbours are those of this one.
+     */
+    void (*relax)( double * x, const double * prev, int w, int h, int d, int c, double a, double s );
+  };
+
+  /// Widest level this cpu runs
+  Level supported();
+
+  /// The kernels in use (chosen on first call)
+  const Kernels& kernels();
+
+  inline Level level(){ return kernels().level; }
+
+  /// Use level l, or the widest supported below it; returns the level now in use
+  Level select( Level l );
+
+  /// Kernels of level l (which must be supported), e.g. to compare levels
+  const Kernels& kernels( Level l );
+
+} // simd::
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_dispatch_INC  ----- */
@@ -0,0 +1,334 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_dyn.h
+ *
+ *    Description:  multivectors of an algebra chosen at run time
+ *
+ *                  DynAlgebra is built from a diagonal metric (as RMetric<P,Q> or the
+ *                  metric={...} table of lua/versor.lua) and, for conformal models, the
+ *                  split of the last two basis vectors e+, e- into no, ni (as
+ *                  vsr_split_met.h).  Its Cayley tables are filled once, with the same
+ *                  coefficient functions the compile time tables use (vsr_cayley.h):
+ *
+ *                    DynAlgebra cga( 4, 1, true );               // as CGA<5>
+ *                    DynMV r = cga.vec( 1, 0, 0 ) * cga.vec( 0, 1, 0 );
+ *                    DynMV q = x.sp( r );                        // r * x * ~r
+ *
+ *                  A DynMV holds all 2^n coefficients, indexed by blade bitmap.  A
+ *                  product costs nonzero(a) * 2^n multiply-adds, run over Lanes packs
+ *                  (vsr_simd.h), or nonzero(a) * nonzero(b) when b is sparse enough.
+ *                  Tables take 3 * 4^n coefficients (twice that if split), so this is
+ *                  meant for n up to about 10.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_dyn_INC
+#define  vsr_dyn_INC
+
+#include <vector>
+#include <cmath>
+#include <stdio.h>
+#include "vsr_cayley.h"
+#include "vsr_simd.h"
+
+namespace vsr {
+
+class DynMV;
+
+/*!
+ *  \brief  Cayley tables of a diagonal metric, optionally split into a null basis
+ *
+ *  For product kind K (cayley::GP, OP, IP), blade a[i] and result blade k:
+ *  Tab(K,0)[i*N+k] is the coefficient of a[i] * b[i^k] in r[k] and, if split,
+ *  Tab(K,1)[i*N+k] that of a[i] * b[i^k^S] (S toggles no and ni).
+ */
+class DynAlgebra {
+
+  int mDim;
+  int mNum;
+  bool mSplit;
+  TT mNeg;
+  TT mSwap;
+  std::vector<VT> mTab[3][2];
+  std::vector<VT> mRev, mInv;
+
+public:
+
+  /// Diagonal metric (1 or -1 per basis vector), the last two split into no, ni if split
+  explicit DynAlgebra( const std::vector<int>& metric, bool split = false ){ build( metric, split ); }
+
+  /// p positive and q negative basis vectors (as RMetric<P,Q>)
+  DynAlgebra( int p, int q, bool split = false ){
+    std::vector<int> m( p, 1 );
+    m.insert( m.end(), q, -1 );
+    build( m, split );
+  }
+
+  /// Conformal model of dim - 2 euclidean dimensions (as CGA<DIM>)
+  static DynAlgebra cga( int dim ){ return DynAlgebra( dim - 1, 1, true ); }
+  /// Euclidean space of dim dimensions (as EGA<DIM>)
+  static DynAlgebra ega( int dim ){ return DynAlgebra( dim, 0, false ); }
+
+  int dim() const { return mDim; }
+  /// number of blades (2^dim)
+  int size() const { return mNum; }
+  bool split() const { return mSplit; }
+  /// bitmap toggling no and ni (0 if not split)
+  TT swap() const { return mSwap; }
+  TT pss() const { return mNum - 1; }
+
+  const VT * tab( int kind, int c ) const { return mTab[kind][c].data(); }
+  /// sign of blade k under reversion and involution
+  VT rev( TT k ) const { return mRev[k]; }
+  VT inv( TT k ) const { return mInv[k]; }
+
+  /// r = a K b, all arrays of size() coefficients (r must not alias a or b)
+  inline void prod( int kind, const VT * a, const VT * b, VT * r ) const;
+
+  /// coefficient of blade x in the product of blades a and b
+  VT coef( int kind, TT a, TT b, TT x ) const {
+    return x == ( a ^ b ) ? mTab[kind][0][ a * mNum + x ] :
+      mSplit && x == ( a ^ b ^ mSwap ) ? mTab[kind][1][ a * mNum + x ] : 0;
+  }
+
+  /// zero multivector, one blade, vector
+  inline DynMV zero() const;
+  inline DynMV blade( TT x, VT v = 1 ) const;
+  template<class ... T>
+  DynMV vec( T ... v ) const;
+
+private:
+
+  void build( const std::vector<int>& metric, bool split ){
+    mDim = metric.size();
+    mNum = 1 << mDim;
+    mSplit = split && mDim > 1;
+    mNeg = 0;
+    for (int i = 0; i < mDim; ++i) if ( metric[i] < 0 ) mNeg |= 1 << i;
+    mSwap = mSplit ? ( sandwich::obit(mDim) | sandwich::ibit(mDim) ) : 0;
+
+    for (int kind = 0; kind < 3; ++kind)
+      for (int c = 0; c < ( mSplit ? 2 : 1 ); ++c){
+        std::vector<VT>& t = mTab[kind][c];
+        t.resize( mNum * mNum );
+        for (int i = 0; i < mNum; ++i)
+          for (int k = 0; k < mNum; ++k)
+            t[ i * mNum + k ] = cayley::coef( kind, i, i ^ k ^ ( c ? mSwap : 0 ), k, mDim, mNeg, mSplit );
+      }
+
+    mRev.resize( mNum ); mInv.resize( mNum );
+    for (int k = 0; k < mNum; ++k){
+      mRev[k] = ( grade(k) & 2 ) ? -1 : 1;
+      mInv[k] = ( grade(k) & 1 ) ? -1 : 1;
+    }
+  }
+};
+
+/*!
+ *  \brief  Multivector of a DynAlgebra: all coefficients, indexed by blade bitmap
+ *
+ *  The algebra must outlive its multivectors.  Products of multivectors of different
+ *  algebras are undefined.
+ */
+class DynMV {
+
+  const DynAlgebra * mAlg;
+  std::vector<VT> val;
+
+public:
+
+  DynMV() : mAlg(0) {}
+  explicit DynMV( const DynAlgebra& alg ) : mAlg(&alg), val( alg.size(), 0 ) {}
+
+  /// From a compile time multivector of the same algebra (blades as bitmaps)
+  template<class T, TT ... XS>
+  DynMV( const DynAlgebra& alg, const MVT<T, XS...>& m ) : mAlg(&alg), val( alg.size(), 0 ) { copyIn( m ); }
+
+  /// To a compile time multivector (e.g. Pnt), dropping other blades
+  template<class R>
+  R cast() const { return castTo( R() ); }
+
+  const DynAlgebra& algebra() const { return *mAlg; }
+  int size() const { return val.size(); }
+
+  VT operator[] ( TT x ) const { return val[x]; }
+  VT& operator[] ( TT x ) { return val[x]; }
+  const VT * data() const { return val.data(); }
+  VT * data() { return val.data(); }
+
+  /// number of nonzero coefficients
+  int nonzero() const {
+    int n = 0;
+    for (size_t k = 0; k < val.size(); ++k) n += val[k] != 0;
+    return n;
+  }
+
+  DynMV prod( int kind, const DynMV& b ) const {
+    DynMV r( *mAlg );
+    mAlg -> prod( kind, data(), b.data(), r.data() );
+    return r;
+  }
+
+  DynMV operator * ( const DynMV& b ) const { return prod( cayley::GP, b ); }
+  DynMV operator ^ ( const DynMV& b ) const { return prod( cayley::OP, b ); }
+  DynMV operator <= ( const DynMV& b ) const { return prod( cayley::IP, b ); }
+
+  DynMV operator + ( const DynMV& b ) const { DynMV r(*this); return r += b; }
+  DynMV operator - ( const DynMV& b ) const { DynMV r(*this); return r -= b; }
+  DynMV operator * ( VT s ) const { DynMV r(*this); return r *= s; }
+  DynMV operator / ( VT s ) const { DynMV r(*this); return r *= 1.0 / s; }
+  DynMV operator - () const { return *this * -1.0; }
+
+  DynMV& operator += ( const DynMV& b ){ for (size_t k = 0; k < val.size(); ++k) val[k] += b.val[k]; return *this; }
+  DynMV& operator -= ( const DynMV& b ){ for (size_t k = 0; k < val.size(); ++k) val[k] -= b.val[k]; return *this; }
+  DynMV& operator *= ( VT s ){ for (size_t k = 0; k < val.size(); ++k) val[k] *= s; return *this; }
+
+  /// Reverse
+  DynMV operator ~ () const {
+    DynMV r( *mAlg );
+    for (int k = 0; k < size(); ++k) r.val[k] = mAlg -> rev(k) * val[k];
+    return r;
+  }
+  DynMV involution() const {
+    DynMV r( *mAlg );
+    for (int k = 0; k < size(); ++k) r.val[k] = mAlg -> inv(k) * val[k];
+    return r;
+  }
+  DynMV conjugation() const {
+    DynMV r( *mAlg );
+    for (int k = 0; k < size(); ++k) r.val[k] = mAlg -> rev(k) * mAlg -> inv(k) * val[k];
+    return r;
+  }
+
+  /// Product with the pseudoscalar (one blade, so one pass over the coefficients)
+  DynMV dual() const { return pssProd( -1 ); }
+  DynMV undual() const { return pssProd( 1 ); }
+
+  /// Grade g part
+  DynMV grade( int g ) const {
+    DynMV r( *mAlg );
+    for (int k = 0; k < size(); ++k) if ( vsr::grade(k) == g ) r.val[k] = val[k];
+    return r;
+  }
+
+  /// Scalar part of a * a, a * ~a
+  VT wt() const { return ( *this * *this )[0]; }
+  VT rwt() const { return ( *this * ~(*this) )[0]; }
+  VT norm() const { VT a = rwt(); return a < 0 ? 0 : sqrt( a ); }
+  VT rnorm() const { VT a = rwt(); return a < 0 ? -sqrt( -a ) : sqrt( a ); }
+
+  DynMV unit() const { VT t = sqrt( fabs( wt() ) ); return t == 0 ? *this : *this / t; }
+
+  /// Inverse of a versor
+  DynMV operator ! () const { VT t = rwt(); return t == 0 ? ~(*this) : ~(*this) / t; }
+
+  /// b * a * ~b
+  DynMV sp( const DynMV& b ) const { return b * *this * ~b; }
+  /// b * a.involution() * ~b
+  DynMV re( const DynMV& b ) const { return b * involution() * ~b; }
+
+  void print() const {
+    printf("dyn\n");
+    for (int k = 0; k < size(); ++k) if ( val[k] != 0 ) printf("%s\t%f\n", estring(k).c_str(), val[k]);
+    printf("\n");
+  }
+
+private:
+
+  DynMV pssProd( VT s ) const {
+    const DynAlgebra& g = *mAlg;
+    DynMV r( g );
+    TT p = g.pss();
+    for (int k = 0; k < size(); ++k){
+      VT t = val[ k ^ p ] * g.coef( cayley::GP, k ^ p, p, k );
+      if ( g.split() ) t += val[ k ^ p ^ g.swap() ] * g.coef( cayley::GP, k ^ p ^ g.swap(), p, k );
+      r.val[k] = s * t;
+    }
+    return r;
+  }
+
+  template<class T, TT X, TT ... XS>
+  void copyIn( const MVT<T, X, XS...>& m ){
+    const TT blades[] = { X, XS... };
+    for (int i = 0; i <= (int)sizeof...(XS); ++i) val[ blades[i] ] = m[i];
+  }
+  template<class T>
+  void copyIn( const MVT<T>& ){}
+
+  template<class T, TT ... XS>
+  MVT<T, XS...> castTo( const MVT<T, XS...>& ) const {
+    return MVT<T, XS...>( val[XS]... );
+  }
+};
+
+inline DynMV operator * ( VT s, const DynMV& a ){ return a * s; }
+
+inline DynMV DynAlgebra::zero() const { return DynMV( *this ); }
+
+inline DynMV DynAlgebra::blade( TT x, VT v ) const { DynMV r( *this ); r[x] = v; return r; }
+
+template<class ... T>
+DynMV DynAlgebra::vec( T ... v ) const {
+  DynMV r( *this );
+  const VT c[] = { VT(v)... };
+  for (int i = 0; i < (int)sizeof...(T) && i < mDim; ++i) r[ 1 << i ] = c[i];
+  return r;
+}
+
+/*!
+ *  Dense kernel: for each nonzero a[i], r[k] += a[i] * T[i*N+k] * b[i^k] over Lanes of k.
+ *  Lanes of b are gathered by xor with the low bits of i (a permutation inside a block).
+ *  If b has fewer nonzeros than one block per row, pairs of nonzeros are multiplied
+ *  directly instead.
+ */
+inline void DynAlgebra::prod( int kind, const VT * a, const VT * b, VT * r ) const {
+
+  typedef Lanes<VT> Pack;
+  const int W = Pack::Width;
+  const int N = mNum;
+  const int C = mSplit ? 2 : 1;
+
+  for (int k = 0; k < N; ++k) r[k] = 0;
+
+  std::vector<TT> nb;
+  for (int j = 0; j < N; ++j) if ( b[j] != 0 ) nb.push_back( j );
+
+  if ( N < W || (int)nb.size() * W < N ){
+    for (int i = 0; i < N; ++i){
+      if ( a[i] == 0 ) continue;
+      for (size_t n = 0; n < nb.size(); ++n){
+        TT j = nb[n];
+        for (int c = 0; c < C; ++c){
+          TT k = i ^ j ^ ( c ? mSwap : 0 );
+          r[k] += a[i] * mTab[kind][c][ i * N + k ] * b[j];
+        }
+      }
+    }
+    return;
+  }
+
+  for (int i = 0; i < N; ++i){
+    if ( a[i] == 0 ) continue;
+    Pack ai( a[i] );
+    for (int c = 0; c < C; ++c){
+      const VT * t = &mTab[kind][c][ i * N ];
+      int x = i ^ ( c ? mSwap : 0 );
+      int lo = x & ( W - 1 );
+      for (int k = 0; k < N; k += W){
+        const VT * bb = b + ( ( x ^ k ) & ~( W - 1 ) );
+        Pack g;
+        for (int l = 0; l < W; ++l) g[l] = bb[ l ^ lo ];
+        Pack acc = Pack::load( r + k ) + ai * Pack::load( t + k ) * g;
+        acc.store( r + k );
+      }
+    }
+  }
+}
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_dyn_INC  ----- */
@@ -13,8 +13,12 @@
 //#include "vsr_frame.h"
 #include "vsr_cubicLattice.h" 
 #include "vsr_math.h" 
+#include "vsr_dispatch.h"
+#include "vsr_par.h"
 #include "gfx/gfx_data.h"
 
+#include <type_traits>
+
 namespace vsr{
 
     #define ITN \
@@ -285,23 +289,83 @@ namespace vsr{
     
     /*!Guass Siedel Relaxation Solver Using a Previous Field State */
     void gsSolver(const Field& prev){
+            gsSolver( par::seq, prev );
+    }
+
+    /*!Guass Siedel Relaxation Solver, sweeps shared out by policy (see relax) */
+    template<class P>
+    void gsSolver(const P& policy, const Field& prev){
             //Iterative Pressure Solver substracts pressure tensor out
             int it = 20;
             for (int m = 0; m < it; ++m){
-                BOUNDITER
-                    int ix = this->idx(i,j,k);
-                    T td = sumNbrs(ix);
-                    mData[ix] = (prev[ix] + td ) / 6.0;                            
-                BOUNDEND
-                
+                relax( policy, prev, 1.0, 1.0 / 6.0 );
                 boundaryConditions(0);
             }
     }
+
+    /*! One Sweep of mData = (prev + a * sumNbrs) * s Over the Interior
+        (doubles go through simd::kernels().relax, whose rows along k use the neighbours of the last sweep) */
+    void relax(const Field& prev, double a, double s){
+        relax( prev, a, s, std::integral_constant< bool, std::is_same< typename T::VT, double >::value && sizeof(T) == T::Num * sizeof(double) >() );
+    }
+
+    void relax(const Field& prev, double a, double s, std::true_type){
+        simd::kernels().relax( (double*)mData, (const double*)prev.mData, this->mWidth, this->mHeight, this->mDepth, T::Num, a, s );
+    }
+
+    void relax(const Field& prev, double a, double s, std::false_type){
+        BOUNDITER
+            int ix = this->idx(i,j,k);
+            T td = sumNbrs(ix);
+            td *= a;
+            mData[ix] = ( prev[ix] + td ) * s;
+        BOUNDEND
+    }
+
+    void relax(const par::Sequential&, const Field& prev, double a, double s){
+        relax( prev, a, s );
+    }
+
+    /*! One Sweep with planes in i shared out among threads: first the odd planes, then the even
+        ones (red-black), each reading its neighbour planes as left by the other half.  The
+        result does not depend on the number of threads, but differs from the in order sweep */
+    void relax(const par::Parallel& policy, const Field& prev, double a, double s){
+        std::integral_constant< bool, std::is_same< typename T::VT, double >::value && sizeof(T) == T::Num * sizeof(double) > tag;
+        for (int parity = 0; parity < 2; ++parity){
+            int num = ( this->mWidth - 1 - parity ) / 2;
+            par::for_each_index( policy, num, [&]( size_t n ){
+                relaxPlane( prev, a, s, 1 + parity + 2 * n, tag );
+            });
+        }
+    }
+
+    /// relax plane i of the interior only
+    void relaxPlane(const Field& prev, double a, double s, int i, std::true_type){
+        size_t off = (size_t)( i - 1 ) * this->mHeight * this->mDepth * T::Num;
+        simd::kernels().relax( (double*)mData + off, (const double*)prev.mData + off, 3, this->mHeight, this->mDepth, T::Num, a, s );
+    }
+
+    void relaxPlane(const Field& prev, double a, double s, int i, std::false_type){
+        for (int j = 1; j < this->mHeight-1; ++j){
+            for (int k = 1; k < this->mDepth-1; ++k){
+                int ix = this->idx(i,j,k);
+                T td = sumNbrs(ix);
+                td *= a;
+                mData[ix] = ( prev[ix] + td ) * s;
+            }
+        }
+    }
     
     /*! Backwards Diffusion Using a Previous Field State */
     void diffuse(const Field& prev, double diffRate, bool bounded, bool ref){
+            diffuse( par::seq, prev, diffRate, bounded, ref );
+    }
+
+    /*! Backwards Diffusion, unbounded sweeps shared out by policy (see relax) */
+    template<class P>
+    void diffuse(const P& policy, const Field& prev, double diffRate, bool bounded, bool ref){
 
-            static int it = 20;
+            const int it = 20;
 
                 double rate = diffRate * .001 * this->mNum;
                 if  (bounded) {
@@ -324,15 +388,8 @@ namespace vsr{
                     //unbounded so set bounds in loop
                     //iterate
                     for (int n = 0; n < it; ++n){
-                        //cout << "BOUNDED:";
-                        BOUNDITER
-                            int tdx = this->idx(i,j,k);
-                            T td = sumNbrs(tdx);
-                            //multiply by (rate )
-                            td *= rate;          
-                            //add to old value and divide new result by (1 + 6 * rate)
-                            mData[tdx] = ( prev[tdx] + td ) / (1 + 6*rate);                            
-                        BOUNDEND
+                        //add rate * neighbors to old value and divide new result by (1 + 6 * rate)
+                        relax( policy, prev, rate, 1.0 / (1 + 6*rate) );
                         
                         boundaryConditions(ref);
                     }
@@ -343,13 +400,23 @@ namespace vsr{
         /*! Backwards Advection Using a Previous Field State prev and Based on a Velocity Frame f */
         template<class B>
         void advect(const Field& prev, const Field<B>& f, double dt, bool ref){
+            advect( par::seq, prev, f, dt, ref );
+        }
+
+        /*! Backwards Advection, planes in i shared out by policy (same result) */
+        template<class P, class B>
+        void advect(const P& policy, const Field& prev, const Field<B>& f, double dt, bool ref){
                     
             double dt0 = dt;// * mWidth;
-            BOUNDITER
+            par::for_each_index( policy, std::max( this->mWidth - 2, 0 ), [&]( size_t n ){
+              int i = n + 1;
+              for (int j = 1; j < this->mHeight-1; ++j){
+              for (int k = 1; k < this->mDepth-1; ++k){
                 int tidx = this->idx(i,j,k);
                 auto p = this->mPoint[ tidx ] + f.euler3d( this->mPoint[tidx] ) * -dt0;// .trs( f.euler3d( mPoint[tidx] ) * -dt0 );//f[tidx] * -dt0 ); //Lattice Point 
                 mData[tidx] = prev.euler3d( p );
-            BOUNDEND
+              }}
+            });
             
             boundaryConditions(ref);
         }
@@ -359,11 +426,21 @@ namespace vsr{
      // Sets values of a scalar field to divergence of another Field b
      template <class B>
      Field& div(const Field<B>& f){
+        return div( par::seq, f );
+     }
+
+     // Divergence, planes in i shared out by policy (same result)
+     template <class P, class B>
+     Field& div(const P& policy, const Field<B>& f){
         //Sum Differences of each Vxl Face (= DIVERGENCE TENSOR)
-    BOUNDITER
+    par::for_each_index( policy, std::max( this->mWidth - 2, 0 ), [&]( size_t n ){
+      int i = n + 1;
+      for (int j = 1; j < this->mHeight-1; ++j){
+      for (int k = 1; k < this->mDepth-1; ++k){
             int ix = this->idx(i,j,k);
       mData[ix] = f.tensNbrsWt(ix) * ( -.5 ); //sca      
-    BOUNDEND   
+      }}
+    });
         boundaryConditions(0);
         return *this;
     }
@@ -388,8 +465,7 @@ namespace vsr{
 
         for (int i = 0; i < this->mFace.size(); ++i){
             int ix = this->mFace[i];
-            static Nbr n;
-            n = this->mNbr[ ix ];
+            const Nbr& n = this->mNbr[ ix ];
             int type = n.type;
             
             mData[ix] = T(0);
@@ -100,37 +100,37 @@ namespace Op{
   /// Dual of a Multivector in A Conformal Metric
   template<TT DIM, class A>  
   auto dl( const CGAMV<DIM,A>& a ) RETURNS (
-    a * NPss<DIM>(-1)
+    a.dual()
   ) 
 
   /// Undual of a Multivector in A Conformal Metric
   template<TT DIM, class A>  
   auto udl( const CGAMV<DIM,A>& a ) RETURNS (
-    a * NPss<DIM>(1)
+    a.undual()
   )
 
   /// Euclidean Dual of a Multivector in a Conformal Metric
   template<TT DIM, class A>  
   auto dle( const CGAMV<DIM,A>& a ) RETURNS (
-    a * NEucPss<DIM>(-1)
+    a.duale()
   )
    
   /// Euclidean Undual of a Multivector in a Conformal Metric
   template<TT DIM, class A>  
   auto udle( const CGAMV<DIM,A>& a ) RETURNS (
-    a * NEucPss<DIM>(1)
+    a.unduale()
   )
   
   /// Euclidean Dual of a Euclidean Multivector
   template<TT DIM, class A>  
   auto dle( const EGAMV<DIM, A>& a ) RETURNS (
-    a * ( NEPss< DIM >(-1) )
+    a.dual()
   ) 
 
   /// Euclidean Undual of a Euclidean Multivector
   template<TT DIM, class A>  
   auto udle( const EGAMV<DIM,A>& a ) RETURNS (   
-    a * ( NEPss< DIM >(1) )   
+    a.undual()   
   )
     
   template<class T> auto dual( const T& t ) RETURNS ( dl(t) )
@@ -231,7 +231,7 @@ namespace Euc{
 
           if (n <= 0) {
               if (t < 0) {
-                  printf("Returning identity - ROTOR LOG FOUND SINGULARITY: %f\n", t );
+          //        printf("Returning identity - ROTOR LOG FOUND SINGULARITY: %f\n", t );
                   return TBIV(PI);
               } else {
                   return TBIV(); 
@@ -437,7 +437,7 @@ namespace Euc{
 
           VT td = tp.wt(); 
 
-          if (td < 0) { norm =  sqrt( - td );  sn = -sin(norm) / norm; cn = cosh(norm); }
+          if (td < 0) { norm =  sqrt( - td );  sn = -sin(norm) / norm; cn = cos(norm); }
           else if (td > 0) { norm = sqrt(td); sn = -sinh(norm) / norm; cn = cosh(norm); }
           else if (td == 0) { norm = 0; sn = -1; cn = 1; }
 
@@ -657,7 +657,7 @@ namespace Euc{
     template<TT DIM, class T>
     constexpr CGAMV<DIM, typename CGA<DIM>::Pnt > 
     cen( const CGAMV<DIM, T>& s) {
-        return  ( s  / ( CGAMV<DIM, typename CGA<DIM>::Inf >(-1) <= s ) ).template cast< CGAMV<DIM, typename CGA<DIM>::Pnt > >();
+        return  s.template rgp< typename CGA<DIM>::Pnt >( !( CGAMV<DIM, typename CGA<DIM>::Inf >(-1) <= s ) );
     }
 
   /*!
@@ -722,14 +722,14 @@ namespace Euc{
     template<TT DIM>
     VT 
     dsize( const NPnt<DIM>& dls ){
-        return (dls * dls)[0];
+        return dls.wt();
     }
    
    /*! Squared distance between two points */ 
   template<TT DIM>
     VT 
     squaredDistance(const NPnt<DIM>& a, const NPnt<DIM>& b){
-        return ( (a <= b)[0] ) * -2.0;
+        return a.scalar(b) * -2.0;
     }
     template< class A> VT sqd( const A& a, const A& b) { return squaredDistance(a,b); }
 
@@ -752,7 +752,7 @@ namespace Euc{
         
       std::vector< NPnt<DIM> > pair;
           
-      VT r = sqrt( fabs( ( pp <= pp )[0] ) );
+      VT r = sqrt( fabs( pp.wt() ) );
           
       //dual line in 2d, dual plane in 3d
       auto d = NInf<DIM>(-1) <= pp;
@@ -763,10 +763,9 @@ namespace Euc{
       bstA += NSca<DIM>(r);
       bstB -= NSca<DIM>(r);
                   
-      NPnt<DIM> pA;
-      pA = ( bstA ) / d;
-      NPnt<DIM> pB;
-      pB = ( bstB ) / d;
+      auto di = !d;
+      NPnt<DIM> pA = bstA.template rgp< typename CGA<DIM>::Pnt >( di );
+      NPnt<DIM> pB = bstB.template rgp< typename CGA<DIM>::Pnt >( di );
                   
       pair.push_back(pA);
       pair.push_back(pB);
@@ -783,13 +782,13 @@ namespace Euc{
     NPnt<DIM> 
     split(const NPar<DIM>& pp, bool bFirst){
         
-        VT r = sqrt( fabs( ( pp <= pp )[0] ) );
+        VT r = sqrt( fabs( pp.wt() ) );
         
          auto d = NInf<DIM>(-1) <= pp;
         
         NBst<DIM> bst = pp + ( bFirst ? r : -r ); 
         
-        return ( ( bst ) / d ).template cast< NPnt<DIM> >();  
+        return bst.template rgp< typename CGA<DIM>::Pnt >( !d );  
 
     }  
 
@@ -12,6 +12,8 @@ replaces vsr_pointGroup.h
 #include "vsr_set.h" 
 #include "vsr_root.h"
 #include "vsr_generic_op.h"
+#include "vsr_outermorphism.h"
+#include "vsr_par.h"
 #include <vector>                 
  
 using std::vector;
@@ -90,15 +92,54 @@ struct Group {
     }
 
     /// Applies all operations on a vector of type T
+    /// (each operator is turned into a matrix once, see vsr_outermorphism.h)
     template<class T>
     vector<T> operator()(const vector<T>& p){
-      vector<T> res;
-      for (auto& i : p) {
-        auto tRes = (*this)(i);
-        for (auto& j : tRes){
-          res.push_back(j);
+      return (*this)( par::seq, p );
+    }
+
+    /// Applies all operations on a vector of type T, elements shared out by policy (e.g. par::par)
+    /// Results are in the same order as group(p)
+    template<class P, class T>
+    vector<T> operator()(const P& policy, const vector<T>& p){
+      typedef decltype(V()*V()) S;
+      typedef decltype(V()*Trs()) G;
+
+      vector< Outermorphism<V,T,true> > mo;
+      vector< Outermorphism<S,T> > ms;
+      vector< Outermorphism<G,T,true> > mg;
+      for (auto& i : ops) mo.push_back( reflection<T>( i.unit() ) );
+      for (auto& i : sops) ms.push_back( outermorphism<T>( i ) );
+      for (auto& i : gops) mg.push_back( reflection<T>( i ) );
+
+      //results per element
+      size_t num = 2 * mo.size() + ms.size() + mg.size() * ( mo.empty() ? 2 : 2 * mo.size() );
+
+      vector<T> res( p.size() * num );
+      par::for_each_index( policy, p.size(), [&]( size_t n ){
+        const T& i = p[n];
+        T * r = res.data() + n * num;
+        for (auto& m : mo){
+          T tp = m(i);
+          *r++ = tp;
+          *r++ = mo[0](tp);
         }
-      }    
+
+        for (auto& m : ms) *r++ = m(i);
+
+        for (auto& m : mg){
+          T tg = m(i);
+          if (mo.empty()) {
+            *r++ = tg;
+            *r++ = mg[0](tg);
+          }
+          for (auto& j : mo){
+            T tp = j(tg);
+            *r++ = tp;
+            *r++ = mo[0](tp);
+          }
+        }
+      });
       return res;
     }
 
@@ -197,31 +238,36 @@ struct SpaceGroup2D : PointGroup2D<V> {
 
     template<class T>
     vector<T> apply(const T& motif, int x, int y){
-      
-      auto tmp = (*this)(motif);  
-      vector<T> res;
-
-      for (auto& i : tmp ){
-        for (int j=-x/2.0;j<x/2.0;++j){
-          for (int k=-y/2.0;k<y/2.0;++k){
-            for (int m =0;m<mDiv;++m){
-              float t = (float)m/mDiv;
-              res.push_back( i.trs( vec(j,k) + vec(t,t) ) );
-            }
-          }
-        }
-      }
-      return res;
+      return apply( vector<T>(1, motif), x, y );
     }
 
     /// Apply to a vector of elements
     template<class T>
     vector<T> apply(const vector<T>& motif, int x, int y){
-      vector<T> res;
-      for (auto& i : motif){
-        vector<T> tRes = apply(i,x,y);
-        for (auto& j : tRes) res.push_back(j);
+      return apply( par::seq, motif, x, y );
+    }
+
+    /// Apply to a vector of elements, shared out by policy (e.g. par::par), in the same order
+    template<class P, class T>
+    vector<T> apply(const P& policy, const vector<T>& motif, int x, int y){
+
+      //lattice translations as matrices, computed once for all elements
+      vector< Outermorphism<Trs,T> > mt;
+      for (int j=-x/2.0;j<x/2.0;++j){
+        for (int k=-y/2.0;k<y/2.0;++k){
+          for (int m =0;m<mDiv;++m){
+            float t = (float)m/mDiv;
+            mt.push_back( outermorphism<T>( Trs( Gen::trs( vec(j,k) + vec(t,t) ) ) ) );
+          }
+        }
       }
+
+      vector<T> g = (*this)( policy, motif );
+      vector<T> res( g.size() * mt.size() );
+      par::for_each_index( policy, g.size(), [&]( size_t n ){
+        T * r = res.data() + n * mt.size();
+        for (auto& m : mt) *r++ = m( g[n] );
+      });
       return res;
     }
 
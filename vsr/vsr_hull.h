@@ -106,7 +106,7 @@ struct ConvexHull {
 
     initialFace(group);
     convexPass(group);
-    closeHoles();
+    closeHoles(group);
 
     return graph;
 
@@ -0,0 +1,113 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_jacobian.h
+ *
+ *    Description:  exact derivatives of sandwich products  b * a * ~b
+ *
+ *                  The fused instruction list of a sandwich (vsr_sandwich.h) is a sum
+ *                  of a[l] * W * b[i] * b[j] terms, so its partial derivatives are
+ *                  instruction lists too, written out at compile time:
+ *
+ *                    in a[l]:  sum of W * b[i] * b[j]        (the Outermorphism matrix)
+ *                    in b[i]:  sum of W * a[l] * b[j]        (and W * a[l] * b[i] in b[j])
+ *
+ *                  Jacobian<A,B> evaluates both for one a and b, in place of the
+ *                  Num + 1 products a finite difference needs:
+ *
+ *                    Jacobian<Pnt, Mot> J( p, mot );
+ *                    J.r            //p.sp( mot )
+ *                    J.da[k][l]     //derivative of r[k] in p[l]
+ *                    J.db[k][i]     //derivative of r[k] in mot[i]
+ *
+ *                  Solvers that update a motor by a small twist, mot <- Gen::mot( e ) * mot,
+ *                  want derivatives in the six coefficients of e instead.  left<Dll>()
+ *                  gives them from the same db (right<Dll>() for mot <- mot * Gen::mot( e )).
+ *                  Gen::mot( e ) is 1 + e to first order; Gen::rot and Gen::bst are 1 - e,
+ *                  so pass s = -1 for rotors and boosts.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_jacobian_INC
+#define  vsr_jacobian_INC
+
+#include "vsr_products.h"
+
+namespace vsr {
+
+/*!
+ *  \brief  Derivatives of r = b * a * ~b (or b * a.involution() * ~b if Invol) in a and in b
+ *
+ *  A is the element type (e.g. Pnt, Dll), B the versor type (e.g. Mot, Rot, Bst).
+ */
+template<class A, class B, bool Invol = false>
+struct Jacobian {
+
+  typedef typename A::VT VT;
+  typedef VersorMetric<B> Met;
+  typedef typename SandwichProd< A, B, typename Met::M, Met::Split, Invol >::Fused::DO DO;
+
+  static const int Rows = A::Num;
+  static const int Cols = B::Num;
+
+  A r;                   ///< b * a * ~b
+  B b;                   ///< the versor differentiated at
+  VT da[Rows][Rows];     ///< da[k][l]: derivative of r[k] in a[l]
+  VT db[Rows][Cols];     ///< db[k][i]: derivative of r[k] in b[i]
+
+  Jacobian(){}
+
+  Jacobian( const A& a, const B& v ){ set( a, v ); }
+
+  /// Recompute at a, v
+  Jacobian& set( const A& a, const B& v ){
+    b = v;
+    for (int k = 0; k < Rows; ++k){
+      for (int l = 0; l < Rows; ++l) da[k][l] = 0;
+      for (int i = 0; i < Cols; ++i) db[k][i] = 0;
+    }
+    SwMatrix<DO>::Exec( &da[0][0], Rows, b );
+    SwJacobian<DO>::Exec( &db[0][0], Cols, a, b );
+    //r is linear in a
+    for (int k = 0; k < Rows; ++k){
+      VT t = 0;
+      for (int l = 0; l < Rows; ++l) t += da[k][l] * a[l];
+      r[k] = t;
+    }
+    return *this;
+  }
+
+  /// t[k][m]: derivative of r[k] in e[m] where b <- ( 1 + s * e ) * b, e of type G
+  template<class G>
+  void left( VT (&t)[Rows][G::Num], VT s = 1 ) const { tangent<G, true>( t, s ); }
+
+  /// t[k][m]: derivative of r[k] in e[m] where b <- b * ( 1 + s * e ), e of type G
+  template<class G>
+  void right( VT (&t)[Rows][G::Num], VT s = 1 ) const { tangent<G, false>( t, s ); }
+
+  private:
+
+  template<class G, bool Left>
+  void tangent( VT (&t)[Rows][G::Num], VT s ) const {
+    for (int m = 0; m < G::Num; ++m){
+      G e; e[m] = s;
+      B d = Left ? B( e * b ) : B( b * e );
+      for (int k = 0; k < Rows; ++k){
+        VT x = 0;
+        for (int i = 0; i < Cols; ++i) x += db[k][i] * d[i];
+        t[k][m] = x;
+      }
+    }
+  }
+};
+
+/// Jacobian of a.sp( b ), e.g. jacobian( pnt, mot )
+template<class A, class B>
+Jacobian<A, B> jacobian( const A& a, const B& b ){ return Jacobian<A, B>( a, b ); }
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_jacobian_INC  ----- */
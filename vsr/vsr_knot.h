@@ -16,6 +16,7 @@
 #define Versor_vsr_knot_h
 
 #include "vsr_fiber.h"
+#include "vsr_par.h"
 
 namespace vsr {
 
@@ -93,6 +94,29 @@ struct TorusKnot  {
     }
   }
 
+  /// Calculate full orbit from point p, points and circles shared out by policy (e.g. par::par)
+  /// Point i is p boosted once by bst( amt * (i+1) ) instead of i+1 times by bst(),
+  /// so results differ from calc(p) by rounding
+  template<class Policy>
+  void calc( const Policy& policy, const Pnt& p){
+    int tnum = iter();
+    Par tpar = par() * amt;
+
+    size_t np = pnt.size();
+    pnt.resize( np + tnum );
+    par::for_each_index( policy, tnum, [&]( size_t i ){
+      pnt[np + i] = Ro::loc( p.sp( Gen::bst( tpar * ( i + 1.0 ) ) ) );
+    });
+
+    //Tube Neighborhood
+    size_t nc = cir.size();
+    cir.resize( nc + tnum );
+    par::for_each_index( policy, tnum, [&]( size_t i ){
+      int idx = i < tnum -1 ? i + 1 : 0;
+      cir[nc + i] = ( pnt[i] ^ pnt[idx] ).dual();
+    });
+  }
+
   //calculate full orbit from point p without renormalizing at each step (no tube)
   void calc0( const Pnt& p){
     pnt.clear();
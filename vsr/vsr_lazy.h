@@ -0,0 +1,284 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_lazy.h
+ *
+ *    Description:  opt-in expression templates for chained products
+ *
+ *                  lazy(a) wraps a multivector so that *, ^, <=, ~, ! and + build an
+ *                  expression tree instead of a typed intermediate per operator.  The
+ *                  tree is evaluated once, when its result type is known:
+ *
+ *                    Pnt q = ( lazy(b) * p * ~lazy(b) ).template cast<Pnt>();
+ *                    Rot r = ( lazy(m1) * m2 * m3 ).template cast<Rot>();
+ *                    Mot m = ( lazy(m1) * m2 * m3 ).eval();
+ *
+ *                  Evaluation runs from the result back to the leaves: each product
+ *                  asks its operands only for the blades that can reach the blades
+ *                  wanted of it, and generates only the instructions writing those
+ *                  blades (as RProd does for a single product).  A sandwich b * x * ~b
+ *                  of one versor b goes through SandwichProd.
+ *
+ *                  Leaves hold references, so evaluate in the statement that builds
+ *                  the expression (do not keep it in an auto variable).  The left
+ *                  operand of ^ and <= must be lazy; plain multivectors on the right
+ *                  (or on either side of * and +) are wrapped automatically.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_lazy_INC
+#define  vsr_lazy_INC
+
+#include <type_traits>
+#include "vsr_products.h"
+
+namespace vsr {
+
+/*-----------------------------------------------------------------------------
+ *  DEMAND: blades of A read by the instructions of table C writing blades R
+ *-----------------------------------------------------------------------------*/
+template<class C, class R>
+struct LazyUse;
+template<class C, class T, TT ... RS>
+struct LazyUse< C, MVT<T, RS...> >{
+  static constexpr bool A( int k ){ return cayley::any( C::ReadsA( k, RS )... ); }
+  static constexpr bool B( int k ){ return cayley::any( C::ReadsB( k, RS )... ); }
+};
+
+/// blades of A (from index K on) read by U (LazyUse), as an MVT
+template<class A, class U, bool Left, int K = 0>
+struct LazyPick{
+  typedef typename LazyPick< typename A::TAIL, U, Left, K+1 >::Type Tail;
+  typedef typename Maybe< Left ? U::A(K) : U::B(K),
+    typename Cat< MVT< typename A::VT, A::HEAD >, Tail >::Type,
+    Tail
+  >::Type Type;
+};
+template<class T, class U, bool Left, int K>
+struct LazyPick< MVT<T>, U, Left, K >{
+  typedef MVT<T> Type;
+};
+
+/// Algebra of leaf type V
+template<class V>
+struct LazyAlg{
+  typedef typename VersorMetric<V>::M M;
+  static const bool Split = VersorMetric<V>::Split;
+  template<class B> using BType = typename V::template BType<B>;
+};
+
+/*!
+ *  \brief  Base of all expression nodes (CRTP)
+ *
+ *  D::Type is the blade list of the full result, D::reduce<R>() evaluates the blades
+ *  of R only.
+ */
+template<class D>
+struct Lazy {
+
+  const D& self() const { return static_cast<const D&>(*this); }
+
+  /// evaluate only the blades of R (an MVT or a multivector type such as Pnt)
+  template<class R, class DD = D>
+  typename DD::Alg::template BType< decltype( swBase( *(const R*)0 ) ) > cast() const {
+    return self().template reduce< decltype( swBase( *(const R*)0 ) ) >();
+  }
+
+  /// evaluate all blades
+  template<class DD = D>
+  typename DD::Alg::template BType< typename DD::Type > eval() const {
+    return self().template reduce< typename DD::Type >();
+  }
+};
+
+template<class V> struct LazyLeaf;
+
+/// Leaves stay as they are, anything else is wrapped in a LazyLeaf
+template<class B, bool IsLazy = std::is_base_of< Lazy<B>, B >::value >
+struct LazyOf{
+  typedef B Type;
+  static const B& wrap( const B& b ){ return b; }
+};
+template<class B>
+struct LazyOf<B, false>{
+  typedef LazyLeaf<B> Type;
+  static Type wrap( const B& b ){ return Type( b ); }
+};
+
+/// A multivector, held by reference
+template<class V>
+struct LazyLeaf : Lazy< LazyLeaf<V> > {
+  typedef LazyAlg<V> Alg;
+  typedef decltype( swBase( *(const V*)0 ) ) Type;
+
+  const V& a;
+  explicit LazyLeaf( const V& v ) : a(v) {}
+
+  template<class R>
+  R reduce() const { return a.template cast<R>(); }
+};
+
+/// Reverse ~e (same blades, so the demand passes through)
+template<class E>
+struct LazyRev : Lazy< LazyRev<E> > {
+  typedef typename E::Alg Alg;
+  typedef typename E::Type Type;
+
+  E e;
+  explicit LazyRev( const E& x ) : e(x) {}
+
+  template<class R>
+  R reduce() const { return reverse( e.template reduce<R>() ); }
+
+  template<class T, TT ... XS>
+  static MVT<T, XS...> reverse( const MVT<T, XS...>& x ){ return Reverse< MVT<T, XS...> >::Type::template Make(x); }
+  template<class T>
+  static MVT<T> reverse( const MVT<T>& x ){ return x; }
+};
+
+/// Inverse !e (all of e is needed for its weight)
+template<class E>
+struct LazyInv : Lazy< LazyInv<E> > {
+  typedef typename E::Alg Alg;
+  typedef typename E::Type Type;
+
+  E e;
+  explicit LazyInv( const E& x ) : e(x) {}
+
+  template<class R>
+  R reduce() const {
+    Type x = e.template reduce<Type>();
+    Type tmp = Reverse<Type>::Type::template Make(x);
+    typename Type::VT v = ScalarProd< Type, Type, typename Alg::M, Alg::Split >().gp( x, tmp );
+    R r = tmp.template cast<R>();
+    if (v != 0) for (int i = 0; i < R::Num; ++i) r[i] /= v;
+    return r;
+  }
+};
+
+/// Sum l + r
+template<class L, class RT>
+struct LazySum : Lazy< LazySum<L,RT> > {
+  typedef typename L::Alg Alg;
+  typedef decltype( sum( typename L::Type(), typename RT::Type() ) ) Type;
+
+  L l; RT r;
+  LazySum( const L& a, const RT& b ) : l(a), r(b) {}
+
+  template<class R>
+  R reduce() const {
+    R x = l.template reduce<R>();
+    R y = r.template reduce<R>();
+    for (int i = 0; i < R::Num; ++i) x[i] += y[i];
+    return x;
+  }
+};
+
+/// b * x * ~b evaluated to the type of x goes through SandwichProd (if the same b)
+template<class N, class R>
+struct LazySandwich{
+  static const bool Use = false;
+};
+
+/// Product l K r (K one of cayley::GP, OP, IP)
+template<int K, class L, class RT>
+struct LazyProd : Lazy< LazyProd<K,L,RT> > {
+  typedef typename L::Alg Alg;
+  typedef typename Alg::M M;
+  typedef Cayley< typename L::Type, typename RT::Type, M, Alg::Split, K > Table;
+  typedef typename Table::Type Type;
+
+  /// blades of l and r read by the instructions writing the blades R of the result
+  template<class R>
+  struct Need{
+    typedef LazyUse< Table, R > U;
+    typedef typename LazyPick< typename L::Type, U, true >::Type Left;
+    typedef typename LazyPick< typename RT::Type, U, false >::Type Right;
+  };
+
+  L l; RT r;
+  LazyProd( const L& a, const RT& b ) : l(a), r(b) {}
+
+  template<class R>
+  R reduce() const { return reduce<R>( std::integral_constant< bool, LazySandwich<LazyProd,R>::Use >() ); }
+
+  template<class R>
+  R reduce( std::false_type ) const {
+    typedef typename Need<R>::Left A;
+    typedef typename Need<R>::Right B;
+    typedef Cayley< A, B, M, Alg::Split, K > C;
+    return C::template Do<R>::Type::template Make<R>( l.template reduce<A>(), r.template reduce<B>() );
+  }
+
+  template<class R>
+  R reduce( std::true_type ) const {
+    typedef LazySandwich<LazyProd,R> S;
+    return S::Same(*this) ? S::Exec(*this) : reduce<R>( std::false_type() );
+  }
+};
+
+template<class V, class X, class R>
+struct LazySandwich< LazyProd< cayley::GP, LazyProd< cayley::GP, LazyLeaf<V>, X >, LazyRev< LazyLeaf<V> > >, R >{
+  typedef LazyProd< cayley::GP, LazyProd< cayley::GP, LazyLeaf<V>, X >, LazyRev< LazyLeaf<V> > > N;
+  typedef LazyAlg<V> Alg;
+  typedef typename X::Type A;
+  typedef SandwichProd< A, V, typename Alg::M, Alg::Split > SP;
+
+  static const bool Use = std::is_same<R, A>::value && SP::UseFused;
+
+  static bool Same( const N& n ){ return &n.l.l.a == &n.r.e.a; }
+  static R Exec( const N& n ){ return SP().fused( n.l.r.template reduce<A>(), n.r.e.a ); }
+};
+
+template<class D>
+LazyRev<D> operator ~ ( const Lazy<D>& a ){ return LazyRev<D>( a.self() ); }
+
+template<class D>
+LazyInv<D> operator ! ( const Lazy<D>& a ){ return LazyInv<D>( a.self() ); }
+
+template<class D, class B>
+LazyProd< cayley::GP, D, typename LazyOf<B>::Type > operator * ( const Lazy<D>& a, const B& b ){
+  return LazyProd< cayley::GP, D, typename LazyOf<B>::Type >( a.self(), LazyOf<B>::wrap(b) );
+}
+template<TT DIM, class A, class E>
+LazyProd< cayley::GP, LazyLeaf< CGAMV<DIM,A> >, E > operator * ( const CGAMV<DIM,A>& a, const Lazy<E>& b ){
+  return LazyProd< cayley::GP, LazyLeaf< CGAMV<DIM,A> >, E >( LazyLeaf< CGAMV<DIM,A> >(a), b.self() );
+}
+template<TT DIM, class A, class E>
+LazyProd< cayley::GP, LazyLeaf< EGAMV<DIM,A> >, E > operator * ( const EGAMV<DIM,A>& a, const Lazy<E>& b ){
+  return LazyProd< cayley::GP, LazyLeaf< EGAMV<DIM,A> >, E >( LazyLeaf< EGAMV<DIM,A> >(a), b.self() );
+}
+
+template<class D, class B>
+LazyProd< cayley::OP, D, typename LazyOf<B>::Type > operator ^ ( const Lazy<D>& a, const B& b ){
+  return LazyProd< cayley::OP, D, typename LazyOf<B>::Type >( a.self(), LazyOf<B>::wrap(b) );
+}
+
+template<class D, class B>
+LazyProd< cayley::IP, D, typename LazyOf<B>::Type > operator <= ( const Lazy<D>& a, const B& b ){
+  return LazyProd< cayley::IP, D, typename LazyOf<B>::Type >( a.self(), LazyOf<B>::wrap(b) );
+}
+
+template<class D, class B>
+LazySum< D, typename LazyOf<B>::Type > operator + ( const Lazy<D>& a, const B& b ){
+  return LazySum< D, typename LazyOf<B>::Type >( a.self(), LazyOf<B>::wrap(b) );
+}
+template<TT DIM, class A, class E>
+LazySum< LazyLeaf< CGAMV<DIM,A> >, E > operator + ( const CGAMV<DIM,A>& a, const Lazy<E>& b ){
+  return LazySum< LazyLeaf< CGAMV<DIM,A> >, E >( LazyLeaf< CGAMV<DIM,A> >(a), b.self() );
+}
+template<TT DIM, class A, class E>
+LazySum< LazyLeaf< EGAMV<DIM,A> >, E > operator + ( const EGAMV<DIM,A>& a, const Lazy<E>& b ){
+  return LazySum< LazyLeaf< EGAMV<DIM,A> >, E >( LazyLeaf< EGAMV<DIM,A> >(a), b.self() );
+}
+
+/// Start a lazy expression at a
+template<class V>
+LazyLeaf<V> lazy( const V& a ){ return LazyLeaf<V>( a ); }
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_lazy_INC  ----- */
@@ -19,13 +19,19 @@ namespace vsr{
 template< typename ... XS >
 struct XList{ 
   template<class A, class B>
-  static constexpr VT Exec(const A& a, const B& b){ return 0; }  
+  static constexpr typename A::VT Exec(const A& a, const B& b){ return 0; }  
   static void print() { printf("\n"); }   
+
+  static constexpr int Num = 0;
   
   template<class R, class A, class B>
   static constexpr R Make(const A& a, const B& b){ // changed from MV<>() to R
     return R();//R(X::Exec(a,b), XS::Exec(a,b)...);//changed from MV<>() to R
   }
+  template<class A>
+  static constexpr A Make(const A& a){ return A(); }
+  template<class B, class A>
+  static constexpr B Cast(const A& a){ return B(); }
 };                                                     
 
 template< typename X, typename ... XS >
@@ -33,7 +39,7 @@ struct XList<X,XS...>{
   typedef X HEAD;
   typedef XList<XS...> TAIL;
   template<class A, class B>
-  static constexpr VT Exec(const A& a, const B& b){
+  static constexpr typename A::VT Exec(const A& a, const B& b){
     return X::Exec(a,b) + TAIL::Exec(a,b);
   }                                  
   // template<class A>
@@ -61,6 +67,32 @@ struct XList<X,XS...>{
   static constexpr int Num = sizeof...(XS)+1;
 };
 
+/// number of leaf instructions in a (possibly nested) instruction list
+template<class X>
+struct InstCount{
+  static const int Val = 1;
+};
+template<>
+struct InstCount< XList<> >{
+  static const int Val = 0;
+};
+template<class X, class ... XS>
+struct InstCount< XList<X, XS...> >{
+  static const int Val = InstCount<X>::Val + InstCount< XList<XS...> >::Val;
+};
+
+/// number of nonempty lists in a list of instruction lists (blades written)
+template<class X>
+struct FilledCount;
+template<>
+struct FilledCount< XList<> >{
+  static const int Val = 0;
+};
+template<class X, class ... XS>
+struct FilledCount< XList<X, XS...> >{
+  static const int Val = ( InstCount<X>::Val > 0 ? 1 : 0 ) + FilledCount< XList<XS...> >::Val;
+};
+
 template<class ... XS, class ... YS>
 constexpr XList<XS..., YS...> cat(const XList< XS ... >& , const XList< YS ... >&) {
   return XList<XS..., YS...>();
@@ -110,15 +142,15 @@ struct XCat< XList<XS...>, XList<YS...> > {
 /*-----------------------------------------------------------------------------
  *  REDUCTION OF INSTRUCTION LIST TO RETURN TYPE : Note lazy sorts
  *-----------------------------------------------------------------------------*/
-template<class X>
+template<class X, class T = VT>
 struct Reduce{ 
-  typedef typename Reduce<typename X::TAIL>::Type M;
+  typedef typename Reduce<typename X::TAIL, T>::Type M;
   using Type = typename Insert< X::HEAD::Res, M >::Type;
 };                
 
-template<>
-struct Reduce<XList<> >{
-  typedef MV<> Type;
+template<class T>
+struct Reduce<XList<>, T >{
+  typedef MVT<T> Type;
 };  
 
 /*-----------------------------------------------------------------------------
@@ -169,8 +201,8 @@ struct Index{
   typedef typename XCat< XList< One > , typename Index < I, typename R::TAIL >::Type  >::Type Type;
 
 };
-template< class I>    
-struct Index< I, MV<> > {  
+template< class I, class T>    
+struct Index< I, MVT<T> > {  
    typedef XList<> Type;
 };
  
@@ -37,8 +37,13 @@ struct Space{
 };
   
 
-template<TT ... XS>
-struct MV{ 
+/*-----------------------------------------------------------------------------
+ *  MULTIVECTOR of blades XS... with coefficients of scalar type T
+ *  (MV<XS...> below is the default double precision alias)
+ *-----------------------------------------------------------------------------*/
+template<class T, TT ... XS>
+struct MVT{ 
+  typedef T VT;
   static const int Num = 0;
   static void print(){ printf("\n");} 
   static void bprint(){ printf("\n");} 
@@ -46,9 +51,10 @@ struct MV{
 };   
 
 
-template<TT X, TT ... XS>
-struct MV<X, XS...>{  
+template<class T, TT X, TT ... XS>
+struct MVT<T, X, XS...>{  
   
+  typedef T VT;
   static const int Num = sizeof...(XS) +1;  
   VT val[Num];
   
@@ -56,36 +62,36 @@ struct MV<X, XS...>{
   array_type& begin() const { return val; } 
   
   static const TT HEAD = X;
-  typedef MV<XS...> TAIL;  
+  typedef MVT<T, XS...> TAIL;  
   
   
   template<typename...Args>     
-  constexpr explicit MV(Args...v) : val{ static_cast<VT>(v)...} {}    
+  constexpr explicit MVT(Args...v) : val{ static_cast<VT>(v)...} {}    
     
-  template<class A> A cast() const;   
-  template<class A> A copy() const; 
+  template<class A> constexpr A cast() const;   
+  template<class A> constexpr A copy() const; 
   
   // template<TT N> 
   // A sub() const; 
   
   template<typename A>
-  MV& operator = ( const A& a) {
-    *this = a.template cast< MV<X,XS...> >(); 
+  MVT& operator = ( const A& a) {
+    *this = a.template cast< MVT<T,X,XS...> >(); 
     return *this;
   }
   
-  template<TT IDX> VT get() const;
+  template<TT IDX> constexpr VT get() const;
   template<TT IDX> VT& get(); 
   
-  template<TT IDX> MV& set(VT v);
+  template<TT IDX> MVT& set(VT v);
   
-  MV& reset(VT v = 0.0){
+  MVT& reset(VT v = 0.0){
     std::fill( &(val[0]), &(val[0]) + Num, v); 
     return *this;
   }
   
-  MV conjugation() const;
-  MV involution() const; 
+  constexpr MVT conjugation() const;
+  constexpr MVT involution() const; 
    
   constexpr VT operator[] (int idx) const{
     return val[idx]; 
@@ -94,7 +100,7 @@ struct MV<X, XS...>{
     return val[idx]; 
   }  
 
-    bool operator == (const MV& mv) const{
+    bool operator == (const MVT& mv) const{
     for (int i = 0; i < Num; ++i) {
       if (val[i] != mv[i]) return false;
     }
@@ -108,11 +114,25 @@ struct MV<X, XS...>{
 
    
 }; 
+
+template<TT ... XS> using MV = MVT<VT, XS...>;
+
+
+/*-----------------------------------------------------------------------------
+ *  REBIND blades of A to scalar type T
+ *-----------------------------------------------------------------------------*/
+template<class A, class T>
+struct Rebind;
+
+template<class T, class S, TT ... XS>
+struct Rebind< MVT<S, XS...>, T >{
+  typedef MVT<T, XS...> Type;
+};
  
 
-template<TT ... XS, TT ... YS>
-constexpr MV<XS...,YS...> cat ( const MV<XS...>&, const MV<YS...>&){  
-  return     MV<XS...,YS...>() ;
+template<class T, TT ... XS, TT ... YS>
+constexpr MVT<T,XS...,YS...> cat ( const MVT<T,XS...>&, const MVT<T,YS...>&){  
+  return     MVT<T,XS...,YS...>() ;
 }  
 
 template<class A, class B>
@@ -120,9 +140,9 @@ struct Cat{
   typedef MV<> Type;
 };
 
-template<TT ... XS, TT ... YS>
-struct Cat< MV<XS...>, MV<YS...> > {
-  typedef  MV<XS..., YS...> Type; 
+template<class T, TT ... XS, TT ... YS>
+struct Cat< MVT<T,XS...>, MVT<T,YS...> > {
+  typedef  MVT<T,XS..., YS...> Type; 
 }; 
 
 //sort as you add in . . .
@@ -145,12 +165,12 @@ struct Cat< MV<XS...>, MV<YS...> > {
  *-----------------------------------------------------------------------------*/
 template<int S,class B>
 struct Take{
-  using Type = typename Cat< MV<B::HEAD>, typename Take<S-1,typename B::TAIL>::Type>::Type;
+  using Type = typename Cat< MVT<typename B::VT, B::HEAD>, typename Take<S-1,typename B::TAIL>::Type>::Type;
 };
 
 template<class B>
 struct Take<0,B>{
-  using Type = MV<>;
+  using Type = MVT<typename B::VT>;
 };
 
 
@@ -235,8 +255,8 @@ struct InsertIdxOf{
   }
 };
 
-template<int A>
-struct InsertIdxOf<A, MV<>> {
+template<int A, class T>
+struct InsertIdxOf<A, MVT<T>> {
   static constexpr int Call(int c = 0){
       return c;
   }
@@ -251,7 +271,7 @@ struct InsertImpl<false>{
   using Result = 
     typename Cat< 
       typename Take<S, B>::Type,
-      typename Cat<MV<A>, typename Remove<S,B>::Type>::Type
+      typename Cat<MVT<typename B::VT, A>, typename Remove<S,B>::Type>::Type
     >::Type;
 };
 
@@ -278,8 +298,8 @@ struct ICat{
   typedef typename Insert< A::HEAD, B>::Type One;                        
   typedef typename ICat < typename A::TAIL, One  >::Type Type;
 };
-template<class B>
-struct ICat< MV<>, B>{
+template<class T, class B>
+struct ICat< MVT<T>, B>{
   typedef B Type;
 };
 
@@ -290,15 +310,15 @@ struct NotType{
   static const int IS = find( B::HEAD, A() );
   typedef typename Cat< 
     typename Maybe< IS == -1,
-      MV< B::HEAD > , 
-      MV<>
+      MVT< typename A::VT, B::HEAD > , 
+      MVT< typename A::VT >
     >::Type,
       typename NotType< A, typename B::TAIL >::Type 
   >::Type Type;  
 };  
-template<class A>
-struct NotType< A, MV<> >{
-  typedef MV<> Type;  
+template<class A, class T>
+struct NotType< A, MVT<T> >{
+  typedef MVT<typename A::VT> Type;  
 };
 
 template<class M, int AB, int SF>  
@@ -365,8 +385,8 @@ struct Exists{
   static constexpr bool Call() { return M::HEAD == N ? true : Exists<N, typename M::TAIL>::Call(); }  
 };
 
-template<TT N>
-struct Exists< N, MV<> >{  
+template<TT N, class T>
+struct Exists< N, MVT<T> >{  
   static constexpr bool Call() { return false; }
 };
 
@@ -383,35 +403,35 @@ struct Exists< N, MV<> >{
 /* } */
 
 
-template<TT...XS> MV<XS...> 
-sum( const MV<XS...> & a, const MV<XS...>& b) {
-  MV<XS...> c;
-  for (int i = 0; i < MV<XS...>::Num; ++i) c[i] = a[i] + b[i];
+template<class T, TT...XS> MVT<T,XS...> 
+sum( const MVT<T,XS...> & a, const MVT<T,XS...>& b) {
+  MVT<T,XS...> c;
+  for (int i = 0; i < MVT<T,XS...>::Num; ++i) c[i] = a[i] + b[i];
   return c;
 } 
-template<TT...XS> MV<XS...> 
-diff( const MV<XS...> & a, const MV<XS...>& b) {
-  MV<XS...> c;
-  for (int i = 0; i < MV<XS...>::Num; ++i) c[i] = a[i] - b[i];
+template<class T, TT...XS> MVT<T,XS...> 
+diff( const MVT<T,XS...> & a, const MVT<T,XS...>& b) {
+  MVT<T,XS...> c;
+  for (int i = 0; i < MVT<T,XS...>::Num; ++i) c[i] = a[i] - b[i];
   return c;
 }
-template<TT...XS, TT...YS> 
-typename ICat< typename NotType< MV<XS...>, MV<YS...> >::Type, MV<XS...> >::Type 
-sum( const MV<XS...> & a, const MV<YS...>& b) {
-  typedef typename ICat< typename NotType< MV<XS...>, MV<YS...> >::Type, MV<XS...> >::Type Ret; 
+template<class T, class S, TT...XS, TT...YS> 
+typename ICat< typename NotType< MVT<T,XS...>, MVT<S,YS...> >::Type, MVT<T,XS...> >::Type 
+sum( const MVT<T,XS...> & a, const MVT<S,YS...>& b) {
+  typedef typename ICat< typename NotType< MVT<T,XS...>, MVT<S,YS...> >::Type, MVT<T,XS...> >::Type Ret; 
   return sum( a.template cast<Ret>() ,  b.template cast<Ret>() );
 } 
-template<TT...XS, TT...YS> 
-typename ICat< typename NotType< MV<XS...>, MV<YS...> >::Type, MV<XS...> >::Type 
-diff( const MV<XS...> & a, const MV<YS...>& b) {
-  typedef typename ICat< typename NotType< MV<XS...>, MV<YS...> >::Type, MV<XS...> >::Type Ret;
+template<class T, class S, TT...XS, TT...YS> 
+typename ICat< typename NotType< MVT<T,XS...>, MVT<S,YS...> >::Type, MVT<T,XS...> >::Type 
+diff( const MVT<T,XS...> & a, const MVT<S,YS...>& b) {
+  typedef typename ICat< typename NotType< MVT<T,XS...>, MVT<S,YS...> >::Type, MVT<T,XS...> >::Type Ret;
   return diff( a.template cast<Ret>() ,  b.template cast<Ret>() );
 }
 
-template<TT ... XS>
-typename ICat< typename NotType< MV<0>, MV<XS...> >::Type, MV<0> >::Type 
-sumv( VT a, const  MV<XS...>& b) {
-  typedef typename ICat< typename NotType< MV<0>,  MV<XS...> >::Type, MV<0> >::Type Ret;
+template<class S, class T, TT ... XS>
+typename ICat< typename NotType< MVT<T,0>, MVT<T,XS...> >::Type, MVT<T,0> >::Type 
+sumv( S a, const  MVT<T,XS...>& b) {
+  typedef typename ICat< typename NotType< MVT<T,0>,  MVT<T,XS...> >::Type, MVT<T,0> >::Type Ret;
   return sum( Ret(a) , b.template cast<Ret>() );
 }
 
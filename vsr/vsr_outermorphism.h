@@ -0,0 +1,144 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_outermorphism.h
+ *
+ *    Description:  linear action of a versor on one element type, cached as a matrix
+ *
+ *                  x -> b * x * ~b is linear in x, so for a fixed versor b and a fixed
+ *                  type A it is a Num x Num matrix (5x5 for a Pnt, 6x6 for a Dll).
+ *                  Its entries are the b[i]*b[j] sums of the fused sandwich product
+ *                  (vsr_sandwich.h), computed once in the constructor.  Each
+ *                  application is then one small matrix-vector product:
+ *
+ *                    Outermorphism<Mot, Pnt> m( mot );
+ *                    Pnt q = m( p );
+ *                    vector<Pnt> moved = m( points );
+ *
+ *                  Reflections (b * x.involution() * ~b) use Outermorphism<V, A, true>.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_outermorphism_INC
+#define  vsr_outermorphism_INC
+
+#include <vector>
+#include "vsr_batch.h"
+
+namespace vsr {
+
+/*!
+ *  \brief  Matrix of x -> b * x * ~b (or b * x.involution() * ~b if Invol) on type A
+ *
+ *  V is the versor type (e.g. Mot, Rot, Bst, Tsd), A the element type (e.g. Pnt, Dll).
+ *  val[k][l] is the coefficient of a[l] in the k-th coefficient of the result.
+ */
+template<class V, class A, bool Invol = false>
+struct Outermorphism {
+
+  typedef typename A::VT VT;
+  typedef VersorMetric<V> Met;
+  typedef typename SandwichProd< A, V, typename Met::M, Met::Split, Invol >::Fused::DO DO;
+
+  static const int Num = A::Num;
+
+  VT val[Num][Num];
+
+  /// Identity
+  Outermorphism(){
+    for (int k = 0; k < Num; ++k)
+      for (int l = 0; l < Num; ++l) val[k][l] = ( k == l );
+  }
+
+  /// Matrix of versor b
+  explicit Outermorphism( const V& b ){ set(b); }
+
+  /// Recompute for versor b
+  Outermorphism& set( const V& b ){
+    for (int k = 0; k < Num; ++k)
+      for (int l = 0; l < Num; ++l) val[k][l] = 0;
+    SwMatrix<DO>::Exec( &val[0][0], Num, b );
+    return *this;
+  }
+
+  VT * operator[] ( int k ) { return val[k]; }
+  const VT * operator[] ( int k ) const { return val[k]; }
+
+  /// Apply to one element
+  A operator()( const A& a ) const {
+    A r;
+    for (int k = 0; k < Num; ++k){
+      VT t = 0;
+      for (int l = 0; l < Num; ++l) t += val[k][l] * a[l];
+      r[k] = t;
+    }
+    return r;
+  }
+
+  /// Apply to n elements of in, writing to out (which may equal in)
+  void operator()( const A * in, A * out, size_t n ) const {
+    for (size_t i = 0; i < n; ++i) out[i] = (*this)( in[i] );
+  }
+
+  /// Apply to a vector of elements
+  std::vector<A> operator()( const std::vector<A>& in ) const {
+    std::vector<A> out( in.size() );
+    (*this)( in.data(), out.data(), in.size() );
+    return out;
+  }
+
+  /// Apply to a structure of arrays of elements (out must have the same size as in)
+  template<class AT>
+  void operator()( const MVBatch<AT>& in, MVBatch<AT>& out ) const {
+    typedef typename MVBatch<AT>::Pack Pack;
+    Pack m[Num][Num];
+    for (int k = 0; k < Num; ++k)
+      for (int l = 0; l < Num; ++l) m[k][l] = Pack( val[k][l] );
+    for (size_t j = 0; j < in.blocks(); ++j){
+      auto a = in.load(j);
+      decltype(a) r;
+      for (int k = 0; k < Num; ++k){
+        Pack t = m[k][0] * a[0];
+        for (int l = 1; l < Num; ++l) t += m[k][l] * a[l];
+        r[k] = t;
+      }
+      out.store( j, r );
+    }
+  }
+
+  /// Apply to a batch of conformal elements
+  template<TT DIM, class AT>
+  CGAMVBatch<DIM, AT> operator()( const CGAMVBatch<DIM, AT>& in ) const {
+    CGAMVBatch<DIM, AT> out( in.size() );
+    (*this)( in, out );
+    return out;
+  }
+
+  /// Composition: (a * b)(x) == a( b(x) )
+  template<class W, bool I>
+  Outermorphism operator * ( const Outermorphism<W, A, I>& b ) const {
+    Outermorphism r;
+    for (int k = 0; k < Num; ++k)
+      for (int l = 0; l < Num; ++l){
+        VT t = 0;
+        for (int m = 0; m < Num; ++m) t += val[k][m] * b.val[m][l];
+        r.val[k][l] = t;
+      }
+    return r;
+  }
+};
+
+/// Outermorphism of versor b on type A, e.g. outermorphism<Pnt>( mot )
+template<class A, class V>
+Outermorphism<V, A> outermorphism( const V& b ){ return Outermorphism<V, A>( b ); }
+
+/// Reflection matrix of versor b on type A, e.g. reflection<Pnt>( dlp )
+template<class A, class V>
+Outermorphism<V, A, true> reflection( const V& b ){ return Outermorphism<V, A, true>( b ); }
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_outermorphism_INC  ----- */
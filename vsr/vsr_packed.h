@@ -0,0 +1,252 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_packed.h
+ *
+ *    Description:  compact storage of rotors, motors and frames
+ *
+ *                  A unit rotor needs only three of its four coefficients and a motor
+ *                  is a rotor and a translation vector, m = Gen::trs( t ) * r.  The
+ *                  codes below keep just those, at float or 16 bit precision:
+ *
+ *                    code      bytes   of           largest error
+ *                    RotF        16    Rot (32)     6e-8
+ *                    Rot16        8    Rot (32)     3.3e-5 in a coefficient, 7e-5 radians
+ *                    MotF        28    Mot (64)     as RotF, and 6e-8 |t| in translation
+ *                    Mot16       14    Mot (64)     as Rot16, and step / 2 in translation
+ *                    FrameF      32    Frame        as MotF, and 6e-8 scale
+ *                    Frame16     20    Frame        as Mot16, and 6e-8 scale
+ *
+ *                  Rot16 is "smallest three": the largest coefficient is dropped (after
+ *                  a sign change making it positive, the same rotation) and rebuilt from
+ *                  the others, which all lie within 1/sqrt(2).  Mot16 rounds translations
+ *                  to multiples of step, up to 32767 of them each way.  Decoded rotors
+ *                  have unit norm to rounding.
+ *
+ *                  PackedArray<Code> stores a sequence and decodes elements as they are read:
+ *
+ *                    PackedArray<Mot16> cache( mots );       //step fitted to the largest translation
+ *                    Mot m = cache[ i ];
+ *                    cache.decode( i, n, out );              //n at once, into Mot * or NMotBatch<5>
+ *
+ *                  Frames keep position, orientation and scale, not their velocities.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_packed_INC
+#define  vsr_packed_INC
+
+#include <stdint.h>
+#include <math.h>
+#include <vector>
+
+#include "vsr_cga3D_frame.h"
+#include "vsr_batch.h"
+
+namespace vsr {
+
+/// Rotor as four floats
+struct RotF {
+
+  typedef Rot Type;
+
+  float q[4];
+
+  void encode( const Rot& r, double = 0 ){ for (int i = 0; i < 4; ++i) q[i] = r[i]; }
+  Rot decode( double = 0 ) const { return Rot( q[0], q[1], q[2], q[3] ); }
+
+  static double reach( const Rot& ){ return 0; }
+};
+
+/// Unit rotor as its three smallest coefficients at 16 bits
+struct Rot16 {
+
+  typedef Rot Type;
+
+  uint16_t q[3];     ///< the other coefficients, in order
+  uint16_t k;        ///< index of the dropped (largest) coefficient
+
+  /// -1/sqrt(2) ... 1/sqrt(2) to 0 ... 65535
+  static uint16_t quant( double x ){
+    double u = ( x * 1.4142135623730951 + 1 ) * 32767.5 + .5;
+    return u < 0 ? 0 : u > 65535 ? 65535 : (uint16_t)u;
+  }
+  static double unquant( uint16_t u ){
+    return ( u / 32767.5 - 1 ) * 0.70710678118654752;
+  }
+
+  void encode( const Rot& r, double = 0 ){
+    k = 0;
+    for (int i = 1; i < 4; ++i) if ( fabs( r[i] ) > fabs( r[k] ) ) k = i;
+    double s = r[k] < 0 ? -1 : 1;
+    for (int i = 0, j = 0; i < 4; ++i) if ( i != k ) q[j++] = quant( s * r[i] );
+  }
+
+  Rot decode( double = 0 ) const {
+    Rot r;
+    double t = 1;
+    for (int i = 0, j = 0; i < 4; ++i){
+      if ( i == k ) continue;
+      r[i] = unquant( q[j++] );
+      t -= r[i] * r[i];
+    }
+    r[k] = t > 0 ? sqrt( t ) : 0;
+    return r;
+  }
+
+  static double reach( const Rot& ){ return 0; }
+};
+
+/// Translation of unit motor m = Gen::trs( t ) * r, where r is m's rotor part
+inline Vec translation( const Mot& m ){
+  Drv d( m * Rot( m[0], -m[1], -m[2], -m[3] ) );
+  return Vec( d[0], d[1], d[2] ) * -2;
+}
+
+/// Unit motor as a RotF and three float coordinates of translation
+struct MotF {
+
+  typedef Mot Type;
+
+  RotF r;
+  float t[3];
+
+  void encode( const Mot& m, double = 0 ){
+    r.encode( Rot( m ) );
+    Vec v = translation( m );
+    for (int i = 0; i < 3; ++i) t[i] = v[i];
+  }
+  Mot decode( double = 0 ) const { return Gen::trs( t[0], t[1], t[2] ) * r.decode(); }
+
+  static double reach( const Mot& ){ return 0; }
+};
+
+/// Unit motor as a Rot16 and translation in 16 bit multiples of step
+struct Mot16 {
+
+  typedef Mot Type;
+
+  Rot16 r;
+  int16_t t[3];
+
+  static int16_t quant( double x, double step ){
+    double u = x / step;
+    u = u < 0 ? u - .5 : u + .5;
+    return u < -32767 ? -32767 : u > 32767 ? 32767 : (int16_t)u;
+  }
+
+  void encode( const Mot& m, double step ){
+    r.encode( Rot( m ) );
+    Vec v = translation( m );
+    for (int i = 0; i < 3; ++i) t[i] = quant( v[i], step );
+  }
+  Mot decode( double step ) const { return Gen::trs( t[0] * step, t[1] * step, t[2] * step ) * r.decode(); }
+
+  /// Largest translation coordinate of m, to fit step
+  static double reach( const Mot& m ){
+    Vec v = translation( m );
+    return fmax( fabs( v[0] ), fmax( fabs( v[1] ), fabs( v[2] ) ) );
+  }
+};
+
+/// Position, orientation and scale of a Frame, through motor code C
+template<class C>
+struct FrameCode {
+
+  typedef Frame Type;
+
+  C m;
+  float s;
+
+  void encode( const Frame& f, double step ){ m.encode( f.mot(), step ); s = f.scale(); }
+  Frame decode( double step ) const {
+    Mot x = m.decode( step );
+    return Frame( translation( x ), Rot( x ), s );
+  }
+
+  static double reach( const Frame& f ){ return C::reach( f.mot() ); }
+};
+
+typedef FrameCode<MotF> FrameF;
+typedef FrameCode<Mot16> Frame16;
+
+
+/*!
+ *  \brief  Array of codes C (RotF, Rot16, MotF, Mot16, FrameF, Frame16) decoded on access
+ *
+ *  step is the translation quantum of Mot16 and Frame16, ignored by the others.
+ */
+template<class C>
+class PackedArray {
+
+  public:
+
+  typedef typename C::Type Type;
+
+  private:
+
+  vector<C> mCode;
+  double mStep;
+
+  public:
+
+  explicit PackedArray( size_t n = 0, double step = 1.0 / 1024 ) : mCode( n ), mStep( step ) {}
+
+  /// Encode a, with step fitted to its largest translation
+  explicit PackedArray( const vector<Type>& a ) : mStep( fit( a.data(), a.size() ) ) { assign( a.data(), a.size() ); }
+
+  PackedArray( const vector<Type>& a, double step ) : mStep( step ) { assign( a.data(), a.size() ); }
+
+  /// Smallest step reaching every translation of n elements of a
+  static double fit( const Type * a, size_t n ){
+    double r = 0;
+    for (size_t i = 0; i < n; ++i) r = fmax( r, C::reach( a[i] ) );
+    return r > 0 ? r / 32767 : 1.0 / 1024;
+  }
+
+  size_t size() const { return mCode.size(); }
+  size_t bytes() const { return mCode.size() * sizeof(C); }
+  double step() const { return mStep; }
+
+  void resize( size_t n ){ mCode.resize( n ); }
+
+  /// Replace contents with n elements of a (step unchanged)
+  void assign( const Type * a, size_t n ){ mCode.resize( n ); encode( a, n, 0 ); }
+
+  Type operator [] ( size_t i ) const { return mCode[i].decode( mStep ); }
+
+  void set( size_t i, const Type& a ){ mCode[i].encode( a, mStep ); }
+
+  void push_back( const Type& a ){ mCode.push_back( C() ); mCode.back().encode( a, mStep ); }
+
+  C * data() { return mCode.data(); }
+  const C * data() const { return mCode.data(); }
+
+  /// Encode n elements of a into codes i ... i+n-1
+  void encode( const Type * a, size_t n, size_t i ){
+    C * c = mCode.data() + i;
+    for (size_t j = 0; j < n; ++j) c[j].encode( a[j], mStep );
+  }
+
+  /// Decode codes i ... i+n-1 into r
+  void decode( size_t i, size_t n, Type * r ) const {
+    const C * c = mCode.data() + i;
+    for (size_t j = 0; j < n; ++j) r[j] = c[j].decode( mStep );
+  }
+
+  /// Decode codes i ... i+r.size()-1 into batch r (e.g. NMotBatch<5>)
+  template<TT DIM, class B>
+  void decode( size_t i, CGAMVBatch<DIM,B>& r ) const {
+    const C * c = mCode.data() + i;
+    for (size_t j = 0; j < r.size(); ++j) r.set( j, c[j].decode( mStep ) );
+  }
+
+  vector<Type> decode() const { vector<Type> r( size() ); decode( 0, size(), r.data() ); return r; }
+};
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_packed_INC  ----- */
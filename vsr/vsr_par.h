@@ -0,0 +1,293 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_par.h
+ *
+ *    Description:  work stealing thread pool and parallel loops over multivectors
+ *
+ *                  par::transform( begin, end, out, mot );        //out[i] = begin[i].sp( mot )
+ *                  par::transform( begin, end, out, f );          //out[i] = f( begin[i] )
+ *                  par::for_each_index( n, f );                    //f( i ) for 0 <= i < n
+ *                  auto s = par::reduce( begin, end, Vec(), std::plus<Vec>() );
+ *
+ *                  Each takes an execution policy first, par::seq or par::par (the
+ *                  default), e.g. par::transform( par::seq, ... ).  Algorithms of the
+ *                  library that can split their work take one too:
+ *
+ *                    group( par::par, motifs );   sg.apply( par::par, motifs, x, y );
+ *                    field.advect( par::par, ... );   knot.calc( par::par, p );
+ *
+ *                  Loops are cut into chunks of about ChunkBytes of elements (so fewer
+ *                  motors than points per chunk), or of Parallel::grain elements.  The
+ *                  calling thread works through chunks too, so loops may nest.
+ *                  reduce() combines one partial result per chunk, in order: it returns
+ *                  the same bits whatever the number of threads or the policy.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_par_INC
+#define  vsr_par_INC
+
+#include <stddef.h>
+#include <algorithm>
+#include <type_traits>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include "vsr_products.h"
+
+namespace vsr {
+
+namespace par {
+
+  /*!
+   *  \brief  Work stealing thread pool
+   *
+   *  Each worker runs tasks from the back of its own queue and, when that is empty,
+   *  steals from the front of the others'.  Threads outside the pool queue tasks
+   *  round robin, and run them too while they wait (see run()).
+   */
+  class Pool {
+
+    public:
+
+    typedef std::function<void()> Task;
+
+    /// n workers besides the threads that submit (default: one per other core)
+    explicit Pool( int n = std::thread::hardware_concurrency() - 1 ) : mStop( false ), mQueued( 0 ), mNext( 0 ) {
+      if ( n < 0 ) n = 0;
+      for (int i = 0; i <= n; ++i) mQueue.emplace_back( new Queue );
+      for (int i = 0; i < n; ++i) mThread.emplace_back( [this, i](){ work( i ); } );
+    }
+
+    ~Pool(){
+      mStop = true;
+      { std::lock_guard<std::mutex> lk( mSleep ); }
+      mWake.notify_all();
+      for (auto& t : mThread) t.join();
+    }
+
+    /// Threads working on a loop: the workers and the caller
+    int size() const { return mThread.size() + 1; }
+
+    void submit( Task t ){
+      Local& l = local();
+      size_t q = l.pool == this ? l.index : mNext++ % mQueue.size();
+      {
+        std::lock_guard<std::mutex> lk( mQueue[q]->m );
+        mQueue[q]->q.push_back( std::move( t ) );
+      }
+      ++mQueued;
+      { std::lock_guard<std::mutex> lk( mSleep ); }
+      mWake.notify_one();
+    }
+
+    /// Run one queued task, own queue first; false if there was none
+    bool runOne(){
+      Local& l = local();
+      size_t n = mQueue.size();
+      size_t self = l.pool == this ? l.index : n - 1;
+      Task t;
+      for (size_t k = 0; k < n && !t; ++k){
+        Queue& q = *mQueue[ ( self + k ) % n ];
+        std::lock_guard<std::mutex> lk( q.m );
+        if ( q.q.empty() ) continue;
+        if ( k == 0 ){ t = std::move( q.q.back() ); q.q.pop_back(); }
+        else { t = std::move( q.q.front() ); q.q.pop_front(); }
+      }
+      if ( !t ) return false;
+      --mQueued;
+      t();
+      return true;
+    }
+
+    /*!
+     *  f( begin, end ) for each chunk [ c * g, min( n, (c+1) * g ) ) of 0 ... n, returning
+     *  when all are done.  Chunks are claimed in order by the caller and by up to size()-1
+     *  tasks; the first exception thrown by f is rethrown here once every chunk has run.
+     */
+    template<class F>
+    void run( size_t n, size_t g, const F& f ){
+      if ( g < 1 ) g = 1;
+      size_t num = ( n + g - 1 ) / g;
+      if ( num < 2 || size() < 2 ){
+        for (size_t c = 0; c < num; ++c) f( c * g, std::min( n, ( c + 1 ) * g ) );
+        return;
+      }
+
+      //tasks still queued after run() returns find no chunk left and never touch f
+      std::shared_ptr<Loop> s = std::make_shared<Loop>( num );
+      const F * pf = &f;
+      Task body = [s, pf, n, g](){
+        size_t c;
+        while ( ( c = s->next++ ) < s->num ){
+          try { (*pf)( c * g, std::min( n, ( c + 1 ) * g ) ); }
+          catch (...) { std::lock_guard<std::mutex> lk( s->m ); if ( !s->err ) s->err = std::current_exception(); }
+          ++s->done;
+        }
+      };
+
+      size_t helpers = std::min( num - 1, (size_t)size() - 1 );
+      for (size_t k = 0; k < helpers; ++k) submit( body );
+      body();
+      while ( s->done < num ) if ( !runOne() ) std::this_thread::yield();
+      if ( s->err ) std::rethrow_exception( s->err );
+    }
+
+    private:
+
+    struct Queue {
+      std::mutex m;
+      std::deque<Task> q;
+    };
+
+    struct Loop {
+      std::atomic<size_t> next, done;
+      size_t num;
+      std::mutex m;
+      std::exception_ptr err;
+      explicit Loop( size_t n ) : next( 0 ), done( 0 ), num( n ) {}
+    };
+
+    /// Pool and queue of the calling thread (none outside workers)
+    struct Local { const Pool * pool; size_t index; };
+    static Local& local(){ static thread_local Local l = { nullptr, 0 }; return l; }
+
+    void work( int i ){
+      local() = Local{ this, (size_t)i };
+      while ( !mStop ){
+        if ( runOne() ) continue;
+        std::unique_lock<std::mutex> lk( mSleep );
+        mWake.wait( lk, [this](){ return mStop || mQueued > 0; } );
+      }
+    }
+
+    std::vector< std::unique_ptr<Queue> > mQueue;    ///< one per worker, the last for other threads
+    std::vector< std::thread > mThread;
+    std::atomic<bool> mStop;
+    std::atomic<int> mQueued;
+    std::atomic<size_t> mNext;
+    std::mutex mSleep;
+    std::condition_variable mWake;
+  };
+
+  /// The pool parallel loops use unless given another (built on first use)
+  inline Pool& pool(){ static Pool p; return p; }
+
+  /// Bytes of elements per chunk, when the policy does not set a grain
+  static const size_t ChunkBytes = 8192;
+
+  /// Execution policies
+  struct Sequential {};
+  struct Parallel {
+    size_t grain;    ///< elements per chunk (0: ChunkBytes worth)
+    Pool * on;       ///< pool to run on (0: pool())
+    Pool& pool() const { return on ? *on : par::pool(); }
+  };
+
+  constexpr Sequential seq = {};
+  constexpr Parallel par = { 0, nullptr };
+
+  /// Elements of T per chunk under p
+  template<class T>
+  size_t grain( const Parallel& p ){
+    return p.grain ? p.grain : sizeof(T) < ChunkBytes ? ChunkBytes / sizeof(T) : 1;
+  }
+
+  /*-----------------------------------------------------------------------------
+   *  f( i ) for 0 <= i < n.  Without a grain, about 8 chunks per thread.
+   *-----------------------------------------------------------------------------*/
+  template<class F>
+  void for_each_index( const Sequential&, size_t n, F f ){
+    for (size_t i = 0; i < n; ++i) f( i );
+  }
+
+  template<class F>
+  void for_each_index( const Parallel& p, size_t n, F f ){
+    Pool& pl = p.pool();
+    size_t g = p.grain ? p.grain : n / ( 8 * pl.size() ) + 1;
+    pl.run( n, g, [&f]( size_t b, size_t e ){ for (size_t i = b; i < e; ++i) f( i ); } );
+  }
+
+  template<class F>
+  void for_each_index( size_t n, F f ){ for_each_index( par, n, f ); }
+
+  /*-----------------------------------------------------------------------------
+   *  out[i] = f( first[i] ), or first[i].sp( f ) for a versor f (random access iterators)
+   *-----------------------------------------------------------------------------*/
+  template<class F, class T>
+  auto apply( const F& f, const T& a ) -> decltype( f( a ) ) { return f( a ); }
+
+  template<TT DIM, class B, class T>
+  auto apply( const CGAMV<DIM,B>& v, const T& a ) -> decltype( a.sp( v ) ) { return a.sp( v ); }
+
+  template<class I, class O, class F>
+  O transform( const Sequential&, I first, I last, O out, const F& f ){
+    for (; first != last; ++first, ++out) *out = apply( f, *first );
+    return out;
+  }
+
+  template<class I, class O, class F>
+  O transform( const Parallel& p, I first, I last, O out, const F& f ){
+    typedef typename std::decay< decltype( *first ) >::type T;
+    size_t n = last - first;
+    p.pool().run( n, grain<T>( p ), [&]( size_t b, size_t e ){
+      for (size_t i = b; i < e; ++i) out[i] = apply( f, first[i] );
+    });
+    return out + n;
+  }
+
+  template<class I, class O, class F>
+  O transform( I first, I last, O out, const F& f ){ return transform( par, first, last, out, f ); }
+
+  /*-----------------------------------------------------------------------------
+   *  init op r0 op r1 ..., where rc is the fold of chunk c (grain<T>( par ) elements
+   *  by default): the same association, so the same result, under either policy
+   *-----------------------------------------------------------------------------*/
+  template<class I, class T, class Op>
+  T reduce( const Parallel& p, I first, I last, T init, Op op ){
+    typedef typename std::decay< decltype( *first ) >::type E;
+    size_t n = last - first, g = grain<E>( p );
+    size_t num = ( n + g - 1 ) / g;
+    std::vector<T> part( num );
+    p.pool().run( n, g, [&]( size_t b, size_t e ){
+      T r = first[b];
+      for (size_t i = b + 1; i < e; ++i) r = op( r, first[i] );
+      part[ b / g ] = r;
+    });
+    for (size_t c = 0; c < num; ++c) init = op( init, part[c] );
+    return init;
+  }
+
+  template<class I, class T, class Op>
+  T reduce( const Sequential&, I first, I last, T init, Op op ){
+    Parallel p = { par.grain, nullptr };
+    typedef typename std::decay< decltype( *first ) >::type E;
+    size_t n = last - first, g = grain<E>( p );
+    for (size_t b = 0; b < n; b += g){
+      size_t e = std::min( n, b + g );
+      T r = first[b];
+      for (size_t i = b + 1; i < e; ++i) r = op( r, first[i] );
+      init = op( init, r );
+    }
+    return init;
+  }
+
+  template<class I, class T, class Op>
+  T reduce( I first, I last, T init, Op op ){ return reduce( par, first, last, init, op ); }
+
+} // par::
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_par_INC  ----- */
@@ -17,167 +17,12 @@
 #include "vsr_instructions.h"  
 #include "vsr_split_met.h"
 #include "vsr_versions.h" 
+#include "vsr_sandwich.h"
+#include "vsr_cayley.h"
 
 namespace vsr{
 
 
-template<class S, int idxA, int idxB>
-struct SplitInstructions{  
-  typedef Instruct< (S::HEAD::SIGN < 0), S::HEAD::BIT, idxA, idxB> I;
-  typedef typename XCat< XList<I>, typename SplitInstructions< typename S::TAIL, idxA, idxB >::Type >::Type Type; 
-};                                                                                                                     
-
-template<int idxA, int idxB>  
-struct SplitInstructions<XList<>, idxA, idxB> {  
-  typedef XList<> Type;
-};
-
-template<TT A, class B, class Metric, int idxA, int idxB>  
-struct SubCGP{
-  
-  typedef typename SplitProd< A, B::HEAD, Metric>::Type Split;  
-  typedef typename SplitInstructions< Split, idxA, idxB >::Type XL;   
-  typedef typename XCat< XL, typename SubCGP<A, typename B::TAIL, Metric, idxA, idxB+1>::Type >::Type Type; 
-};
-template<TT A, class Metric, int idxA, int idxB>  
-struct SubCGP<A, MV<>, Metric, idxA, idxB >{
-  typedef XList<> Type;
-};
-
-template<class A, class B, class Metric, int idxA=0, int idxB=0>  
-struct CGP{
-  typedef typename XCat< typename SubCGP<A::HEAD,B, Metric, idxA,idxB>::Type, typename CGP<typename A::TAIL, B, Metric, idxA+1,idxB>::Type >::Type Type; 
-};
-template<class B, class Metric, int idxA, int idxB>  
-struct CGP<MV<>,B, Metric, idxA,idxB> {
-  typedef XList<> Type; 
-};
-
-template<TT A, class B, class Metric, int idxA, int idxB>  
-struct SubCOP{        
-  
-  typedef typename SplitOProd< A, B::HEAD, Metric>::Type Split;
-  
-  typedef typename SplitInstructions< Split, idxA, idxB >::Type XL;
-   
-  typedef typename XCat< XL, typename SubCOP<A, typename B::TAIL, Metric, idxA, idxB+1>::Type >::Type Type;
-};
-template<TT A, class Metric, int idxA, int idxB>  
-struct SubCOP<A, MV<>, Metric, idxA, idxB >{
-  typedef XList<> Type;
-};
-
-template<class A, class B, class Metric, int idxA=0, int idxB=0>  
-struct COP{
-  typedef typename XCat< typename SubCOP<A::HEAD,B, Metric, idxA,idxB>::Type, typename COP<typename A::TAIL, B, Metric, idxA+1,idxB>::Type >::Type Type; 
-};
-template<class B, class Metric,  int idxA, int idxB>  
-struct COP<MV<>,B, Metric,idxA,idxB> {
-  typedef XList<> Type; 
-};
-                               
-
-
-template<TT A, class B, class Metric, int idxA, int idxB>  
-struct SubCIP{ 
-  typedef typename SplitIProd< A, B::HEAD, Metric>::Type Split;
-  
-  typedef typename SplitInstructions< Split, idxA, idxB >::Type XL;
-   
-  typedef typename XCat< XL, typename SubCIP<A, typename B::TAIL, Metric, idxA, idxB+1>::Type >::Type Type;
-};
-template<TT A, class Metric, int idxA, int idxB>  
-struct SubCIP<A, MV<>, Metric, idxA, idxB >{
-  typedef XList<> Type;
-};
-
-template<class A, class B, class Metric, int idxA=0, int idxB=0>  
-struct CIP{
-  typedef typename XCat< typename SubCIP<A::HEAD,B, Metric, idxA,idxB>::Type, typename CIP<typename A::TAIL, B, Metric, idxA+1,idxB>::Type >::Type Type; 
-};
-template<class B, class Metric,  int idxA, int idxB>  
-struct CIP<MV<>,B, Metric, idxA,idxB> {
-  typedef XList<> Type; 
-}; 
-
- 
-/////////////////////////////
-// DIAGONAL METRIC USED   ///   
-/////////////////////////////
-///////////////////////////// 
-                             
-/////////////////////////////
-/////////////////////////////
-/////////////////////////////
-/////////////////////////////
-
-
-template<TT A, class B, class Metric, int idxA, int idxB>  
-struct SubMGP{
-  static const bool BFlip = MSign< Metric, A & B::HEAD, signFlip(A , B::HEAD) ? -1 : 1 >::Val == -1;  
-  typedef typename XCat< XList< Inst< BFlip, A, B::HEAD, idxA, idxB> >, typename SubMGP<A, typename B::TAIL, Metric, idxA, idxB+1>::Type >::Type Type; 
-};
-template<TT A, class Metric, int idxA, int idxB>  
-struct SubMGP<A, MV<>, Metric, idxA, idxB >{
-  typedef XList<> Type;
-};
-
-template<class A, class B, class Metric, int idxA=0, int idxB=0>  
-struct MGP{
-  typedef typename XCat< typename SubMGP<A::HEAD,B, Metric, idxA,idxB>::Type, typename MGP<typename A::TAIL, B, Metric, idxA+1,idxB>::Type >::Type Type; 
-};
-template<class B, class Metric, int idxA, int idxB>  
-struct MGP<MV<>,B, Metric, idxA,idxB> {
-  typedef XList<> Type; 
-}; 
-
-template<TT A, class B, class Metric, int idxA, int idxB>  
-struct SubMOP{
-  static const bool BFlip = MSign< Metric, A & B::HEAD, signFlip(A , B::HEAD) ? -1 : 1 >::Val == -1;    
-  typedef Inst< BFlip, A, B::HEAD, idxA, idxB> INST;
-  typedef typename Maybe< INST::OP, XList< INST >, XList<> >::Type ELEM;
-  typedef typename XCat< ELEM, typename SubMOP<A, typename B::TAIL, Metric, idxA, idxB+1>::Type >::Type Type; 
-};
-template<TT A, class Metric, int idxA, int idxB>  
-struct SubMOP<A, MV<>, Metric, idxA, idxB >{
-  typedef XList<> Type;
-};
-
-template<class A, class B, class Metric, int idxA=0, int idxB=0>  
-struct MOP{
-  typedef typename XCat< typename SubMOP<A::HEAD,B, Metric, idxA,idxB>::Type, typename MOP<typename A::TAIL, B, Metric, idxA+1,idxB>::Type >::Type Type; 
-};
-template<class B, class Metric, int idxA, int idxB>  
-struct MOP<MV<>,B, Metric,idxA,idxB> {
-  typedef XList<> Type; 
-};
-
-template<TT A, class B,  class Metric, int idxA, int idxB>  
-struct SubMIP{ 
-  static const bool BFlip = MSign< Metric, A & B::HEAD, signFlip(A , B::HEAD) ? -1 : 1 >::Val == -1; 
-  typedef Inst< BFlip, A, B::HEAD, idxA, idxB> INST;
-  typedef typename Maybe< INST::IP, XList< INST >, XList<> >::Type ELEM;
-  typedef typename XCat< ELEM, typename SubMIP<A, typename B::TAIL, Metric, idxA, idxB+1>::Type >::Type Type; 
-};
-template<TT A, class Metric, int idxA, int idxB>  
-struct SubMIP<A, MV<>, Metric, idxA, idxB >{
-  typedef XList<> Type;
-};
-
-template<class A, class B, class Metric, int idxA=0, int idxB=0>  
-struct MIP{
-  typedef typename XCat< typename SubMIP<A::HEAD,B, Metric, idxA,idxB>::Type, typename MIP<typename A::TAIL, B, Metric, idxA+1,idxB>::Type >::Type Type; 
-};
-template<class B, class Metric,  int idxA, int idxB>  
-struct MIP<MV<>,B, Metric, idxA,idxB> {
-  typedef XList<> Type; 
-};
-                                                                           
-/////////////////////////////
-///////////////////////////// 
-                             
-/////////////////////////////
-/////////////////////////////
 /////////////////////////////
 /////////////////////////////
 //EUCLIDEAN 
@@ -190,8 +35,8 @@ struct SubEGP{
   //static const int Met = MSign< MV<1,1,1,1,-1>, A::BIT & B::HEAD::BIT, signFlip(A::BIT , B::HEAD::BIT) ? -1 : 1 >::Val;  
   typedef typename XCat< XList< Inst<signFlip( A, B::HEAD ), A, B::HEAD, idxA, idxB> >, typename SubEGP<A, typename B::TAIL, idxA, idxB+1>::Type >::Type Type; 
 };
-template<TT A, int idxA, int idxB>  
-struct SubEGP<A, MV<>, idxA, idxB >{
+template<TT A, int idxA, int idxB, class T>  
+struct SubEGP<A, MVT<T>, idxA, idxB >{
   typedef XList<> Type;
 };
 
@@ -199,8 +44,8 @@ template<class A, class B, int idxA=0, int idxB=0>
 struct EGP{
   typedef typename XCat< typename SubEGP<A::HEAD,B, idxA,idxB>::Type, typename EGP<typename A::TAIL, B, idxA+1,idxB>::Type >::Type Type; 
 };
-template<class B, int idxA, int idxB>  
-struct EGP<MV<>,B, idxA,idxB> {
+template<class B, int idxA, int idxB, class T>  
+struct EGP<MVT<T>,B, idxA,idxB> {
   typedef XList<> Type; 
 }; 
 template<TT A, class B, int idxA, int idxB>  
@@ -209,8 +54,8 @@ struct SubEOP{
   typedef typename Maybe< INST::OP, XList< INST >, XList<> >::Type ELEM;
   typedef typename XCat< ELEM, typename SubEOP<A, typename B::TAIL, idxA, idxB+1>::Type >::Type Type; 
 };
-template<TT A, int idxA, int idxB>  
-struct SubEOP<A, MV<>, idxA, idxB >{
+template<TT A, int idxA, int idxB, class T>  
+struct SubEOP<A, MVT<T>, idxA, idxB >{
   typedef XList<> Type;
 };
 
@@ -218,8 +63,8 @@ template<class A, class B, int idxA=0, int idxB=0>
 struct EOP{
   typedef typename XCat< typename SubEOP<A::HEAD,B, idxA,idxB>::Type, typename EOP<typename A::TAIL, B, idxA+1,idxB>::Type >::Type Type; 
 };
-template<class B, int idxA, int idxB>  
-struct EOP<MV<>,B, idxA,idxB> {
+template<class B, int idxA, int idxB, class T>  
+struct EOP<MVT<T>,B, idxA,idxB> {
   typedef XList<> Type; 
 };
 
@@ -229,8 +74,8 @@ struct SubEIP{
   typedef typename Maybe< INST::IP, XList< INST >, XList<> >::Type ELEM;
   typedef typename XCat< ELEM, typename SubEIP<A, typename B::TAIL, idxA, idxB+1>::Type >::Type Type; 
 };
-template<TT A, int idxA, int idxB>  
-struct SubEIP<A, MV<>, idxA, idxB >{
+template<TT A, int idxA, int idxB, class T>  
+struct SubEIP<A, MVT<T>, idxA, idxB >{
   typedef XList<> Type;
 };
 
@@ -238,8 +83,8 @@ template<class A, class B, int idxA=0, int idxB=0>
 struct EIP{
   typedef typename XCat< typename SubEIP<A::HEAD,B, idxA,idxB>::Type, typename EIP<typename A::TAIL, B, idxA+1,idxB>::Type >::Type Type; 
 };
-template<class B, int idxA, int idxB>  
-struct EIP<MV<>,B, idxA,idxB> {
+template<class B, int idxA, int idxB, class T>  
+struct EIP<MVT<T>,B, idxA,idxB> {
   typedef XList<> Type; 
 };
 
@@ -249,88 +94,113 @@ struct EIP<MV<>,B, idxA,idxB> {
 ///////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////  
 
+/*!
+ *  Cost of instruction list DO (one list per output blade) of a product of NA by NB
+ *  blades: Muls multiplications, Adds additions, Blades output blades written, and
+ *  Density the fraction of the NA * NB pairs of coefficients that are multiplied.
+ */
+template<class DO, int NA, int NB>
+struct ProdCost{
+  static const int Muls = InstCount<DO>::Val;
+  static const int Blades = FilledCount<DO>::Val;
+  static const int Adds = Muls - Blades;
+  static const int Flops = Muls + Adds;
+  static constexpr double Density = NA * NB == 0 ? 0.0 : (double)Muls / ( NA * NB );
+};
+
+/*!
+ *  Hand written kernel for product Kind (cayley::GP, OP, IP, or cayley::SP for the
+ *  sandwich b * a * ~b) of the blade lists of A and B.  On is false unless specialized
+ *  (vsr_cga3D_kernels.h, with VSR_KERNELS defined), in which case Prod, OProd, IProd and
+ *  SandwichProd call K::template make<R>( a, b ) in place of their instruction lists.
+ */
+template<int Kind, class A, class B, class Metric, bool SplitIt>
+struct Kernel : Kernel< Kind, decltype( swBase( *(const A*)0 ) ), decltype( swBase( *(const B*)0 ) ), Metric, SplitIt > {};
+
+template<int Kind, class T, TT ... AS, class S, TT ... BS, class Metric, bool SplitIt>
+struct Kernel< Kind, MVT<T, AS...>, MVT<S, BS...>, Metric, SplitIt >{
+  static const bool On = false;
+};
+
+//calls the kernel K if it is on, the instruction list DO if not
+template<bool On>
+struct KernelPick{
+  template<class K, class DO, class R, class A, class B>
+  static constexpr R make( const A& a, const B& b ){ return DO::template Make<R>( a, b ); }
+};
+template<>
+struct KernelPick<true>{
+  template<class K, class DO, class R, class A, class B>
+  static R make( const A& a, const B& b ){ return K::template make<R>( a, b ); }
+};
+
 template<class A, class B, class Metric, bool SplitIt>
 struct Prod{
   
-  typedef  typename MGP<A,B,Metric>::Type InstList;  
+  typedef Cayley< A, B, Metric, SplitIt, cayley::GP > Table;
   
-  typedef typename Reduce<InstList>::Type Type; 
+  typedef typename Table::Type Type; 
   
-  typedef typename Index< InstList, Type>::Type DO;
+  typedef typename Table::template Do<Type>::Type DO;
+  typedef ProdCost< DO, A::Num, B::Num > Cost;
+  typedef Kernel< cayley::GP, A, B, Metric, SplitIt > K;
   
   constexpr Type gp(const A& a, const B& b) const{
-    return DO::template Make<Type>(a, b);
+    return KernelPick< K::On >::template make< K, DO, Type >(a, b);
   }
 };
 
-template<class A, class B, class Metric>
-struct Prod<A,B,Metric,true>{
-   
-  typedef  typename CGP<A,B,Metric>::Type InstList;  
-  
-  typedef typename Reduce<InstList>::Type Type; 
-  
-  typedef typename Index< InstList, Type>::Type DO;
-  
-  constexpr Type gp(const A& a, const B& b) const{
-    return DO::template Make<Type>(a, b);
-  }   
+/*!
+ *  Product P (a Prod or EProd) of A by a single unit blade scaled by S (+1 or -1), such as
+ *  the pseudoscalar of a dual: a signed permutation of the coefficients of a
+ */
+template<class P>
+struct BladeProd{
+
+  typedef typename P::Type Type;
+  template<int S> using DO = typename BladePerm< typename P::DO, ( S < 0 ) >::Type;
+
+  template<int S, class A>
+  static constexpr Type gp(const A& a){
+    return DO<S>::template Cast<Type>( a );
+  }
+  /// same, written into r (which must not alias a)
+  template<int S, class A, class R>
+  static void gp(const A& a, R& r){
+    Store< DO<S> >::Exec( r, a );
+  }
 };
 
 template<class A, class B, class Metric, bool SplitIt>
 struct OProd{
   
-  typedef  typename MOP<A,B,Metric>::Type InstList;  
+  typedef Cayley< A, B, Metric, SplitIt, cayley::OP > Table;
   
-  typedef typename Reduce<InstList>::Type Type; 
+  typedef typename Table::Type Type; 
   
-  typedef typename Index< InstList, Type>::Type DO;
+  typedef typename Table::template Do<Type>::Type DO;
+  typedef ProdCost< DO, A::Num, B::Num > Cost;
+  typedef Kernel< cayley::OP, A, B, Metric, SplitIt > K;
   
   constexpr Type op(const A& a, const B& b) const{
-    return DO::template Make<Type>(a, b);
+    return KernelPick< K::On >::template make< K, DO, Type >(a, b);
   }
 };
 
-template<class A, class B, class Metric>
-struct OProd<A,B,Metric,true>{
-   
-  typedef  typename COP<A,B,Metric>::Type InstList;  
-  
-  typedef typename Reduce<InstList>::Type Type; 
-  
-  typedef typename Index< InstList, Type>::Type DO;
-  
-  constexpr Type op(const A& a, const B& b) const{
-    return DO::template Make<Type>(a, b);
-  }   
-};
-
 template<class A, class B, class Metric, bool SplitIt>
 struct IProd{
   
-  typedef  typename MIP<A,B,Metric>::Type InstList;  
+  typedef Cayley< A, B, Metric, SplitIt, cayley::IP > Table;
   
-  typedef typename Reduce<InstList>::Type Type; 
+  typedef typename Table::Type Type; 
   
-  typedef typename Index< InstList, Type>::Type DO;
+  typedef typename Table::template Do<Type>::Type DO;
+  typedef ProdCost< DO, A::Num, B::Num > Cost;
+  typedef Kernel< cayley::IP, A, B, Metric, SplitIt > K;
   
   constexpr Type ip(const A& a, const B& b) const{
-    return DO::template Make<Type>(a, b);
+    return KernelPick< K::On >::template make< K, DO, Type >(a, b);
   }
-};
-
-template<class A, class B, class Metric>
-struct IProd<A,B,Metric,true>{
-   
-  typedef  typename CIP<A,B,Metric>::Type InstList;  
-  
-  typedef typename Reduce<InstList>::Type Type; 
-  
-  typedef typename Index< InstList, Type>::Type DO;
-  
-  constexpr Type ip(const A& a, const B& b) const{
-    return DO::template Make<Type>(a, b);
-  }   
 }; 
 
 
@@ -340,9 +210,10 @@ struct EProd{
    
   typedef  typename EGP<A,B>::Type InstList;  
   
-  typedef typename Reduce<InstList>::Type Type; 
+  typedef typename Reduce<InstList, typename A::VT>::Type Type; 
   
   typedef typename Index< InstList, Type>::Type DO;
+  typedef ProdCost< DO, A::Num, B::Num > Cost;
   
   constexpr Type gp(const A& a, const B& b) const{
     return DO::template Make<Type>(a, b);
@@ -353,9 +224,10 @@ template<class A, class B>
 struct EOProd{
 
   typedef typename EOP<A,B>::Type  InstList;   
-  typedef typename Reduce<InstList>::Type Type; 
+  typedef typename Reduce<InstList, typename A::VT>::Type Type; 
   
   typedef typename Index< InstList, Type>::Type DO;
+  typedef ProdCost< DO, A::Num, B::Num > Cost;
   
   constexpr Type op(const A& a, const B& b) const{
     return DO::template Make<Type>(a, b);
@@ -365,9 +237,10 @@ template<class A, class B>
 struct EIProd{
 
   typedef typename EIP<A,B>::Type  InstList;   
-  typedef typename Reduce<InstList>::Type Type; 
+  typedef typename Reduce<InstList, typename A::VT>::Type Type; 
   
   typedef typename Index< InstList, Type>::Type DO;
+  typedef ProdCost< DO, A::Num, B::Num > Cost;
   
   constexpr Type ip(const A& a, const B& b) const{
     return DO::template Make<Type>(a, b);
@@ -378,26 +251,151 @@ struct EIProd{
 //Reduced Product input a and b and known return type r (i.e. for spinors)
 template<class A, class B, class R, class Metric, bool SplitIt>
 struct RProd{
-  typedef typename MGP<A,B,Metric>::Type AB; //A*B Type
   
-  //Instructions for (type A*B) 
-  typedef typename Index< AB, R>::Type DO; 
+  //Instructions for (type A*B) writing the blades of R
+  typedef typename Cayley< A, B, Metric, SplitIt, cayley::GP >::template Do<R>::Type DO; 
+  typedef ProdCost< DO, A::Num, B::Num > Cost;
      
   constexpr R gp(const A& a, const B& b) const{
     return DO::template Make<R>(a, b);
   }
 }; 
 
-//Reduced Product input a and b and known return type r
-template<class A, class B, class R, class Metric>
-struct RProd<A, B, R, Metric, true>   {
-  typedef typename CGP<A,B,Metric>::Type AB; //A*B Type
-  
-  //Instructions for (type A*B) 
-  typedef typename Index< AB, R>::Type DO; 
-     
-  constexpr R gp(const A& a, const B& b) const{
-    return DO::template Make<R>(a, b);
+/*-----------------------------------------------------------------------------
+ *  GRADE SELECTION: blades of A whose grade g has bit (1<<g) set in Grades
+ *-----------------------------------------------------------------------------*/
+template<class A, int Grades>
+struct GradeSel{
+  typedef typename GradeSel< typename A::TAIL, Grades >::Type Tail;
+  typedef typename Maybe< ( ( Grades >> grade(A::HEAD) ) & 1 ) != 0,
+    typename Cat< MVT< typename A::VT, A::HEAD >, Tail >::Type,
+    Tail
+  >::Type Type;
+};
+template<class T, int Grades>
+struct GradeSel< MVT<T>, Grades >{
+  typedef MVT<T> Type;
+};
+
+/// Bitmask of a single grade (for GradeSel and GradeProd)
+constexpr int gradeMask( int g ){ return 1 << g; }
+
+//Product of a and b restricted to the grades in bitmask Grades: only the instructions
+//that write to those blades are generated
+template<class A, class B, class Metric, bool SplitIt, int Grades>
+struct GradeProd{
+  typedef typename GradeSel< typename Prod<A,B,Metric,SplitIt>::Type, Grades >::Type Type;
+  typedef RProd<A,B,Type,Metric,SplitIt> R;
+  typedef typename R::DO DO;
+  typedef typename R::Cost Cost;
+
+  constexpr Type gp(const A& a, const B& b) const{
+    return R().gp(a, b);
+  }
+};
+
+//Scalar part of a * b (equal to the scalar part of a <= b)
+template<class A, class B, class Metric, bool SplitIt>
+struct ScalarProd{
+  typedef MVT< typename A::VT, 0 > Type;
+  typedef RProd<A,B,Type,Metric,SplitIt> R;
+  typedef typename R::DO DO;
+  typedef typename R::Cost Cost;
+
+  constexpr typename A::VT gp(const A& a, const B& b) const{
+    return R().gp(a, b).val[0];
+  }
+};
+
+//selects the cheaper sandwich evaluation at compile time (or the kernel, if there is one)
+template<bool Fused, bool Kern = false>
+struct SandwichPick{
+  template<class S, class A, class B>
+  static constexpr A sp( const S& s, const A& a, const B& b ){ return s.staged( a, b ); }
+};
+template<>
+struct SandwichPick<true, false>{
+  template<class S, class A, class B>
+  static constexpr A sp( const S& s, const A& a, const B& b ){ return s.fused( a, b ); }
+};
+template<bool Fused>
+struct SandwichPick<Fused, true>{
+  template<class S, class A, class B>
+  static A sp( const S& s, const A& a, const B& b ){ return S::K::template make<A>( a, b ); }
+};
+
+/*!
+ *  \brief Sandwich product b * a * ~b (or b * a.involution() * ~b if Invol), returning type A
+ *
+ *  Two instruction lists are built: the fused bilinear form in b (see vsr_sandwich.h)
+ *  and the staged product (b * a) * ~b reduced to A.  sp() uses whichever needs fewer
+ *  multiplications per call (staged for versors of more than sandwich::MaxFused blades,
+ *  without counting); fused() always uses the bilinear form, which is the one to call
+ *  in loops over many a with the same b (its b[i]*b[j] sums are loop invariant).
+ */
+template<class A, class B, class Metric, bool SplitIt, bool Invol = false>
+struct SandwichProd{
+
+  typedef SandwichMetric< Metric, SplitIt > Cfg;
+
+  typedef decltype( swBase( *(const A*)0 ) ) AT;
+  typedef decltype( swBase( *(const B*)0 ) ) BT;
+
+  /// fused instructions (a member class, so only built where fused() is used)
+  struct Fused{
+    typedef typename SwIndex< A, A, BT, Cfg, Invol >::Type DO;
+  };
+
+  /// staged instructions
+  typedef Prod< B, A, Metric, SplitIt > First;
+  typedef RProd< typename First::Type, B, A, Metric, SplitIt > Second;
+
+  /// multiplications of each path (fused counts every b[i]*b[j] pair once)
+  static const int FusedCost = SwCount< AT, BT, Cfg >::Val + B::Num * (B::Num + 1) / 2;
+  static const int StagedCost = First::Cost::Muls + Second::Cost::Muls;
+
+  /// additions of each path
+  static const int FusedAdds = SwCount< AT, BT, Cfg >::Adds;
+  static const int StagedAdds = First::Cost::Adds + Second::Cost::Adds;
+
+  /// the fused path is only counted for versors of up to sandwich::MaxFused blades
+  template<bool Count, int = 0>
+  struct Pick{
+    static const bool Fused = FusedCost <= StagedCost;
+    static const int Muls = Fused ? FusedCost : StagedCost;
+    static const int Adds = Fused ? FusedAdds : StagedAdds;
+  };
+  template<int Z>
+  struct Pick<false, Z>{
+    static const bool Fused = false;
+    static const int Muls = StagedCost;
+    static const int Adds = StagedAdds;
+  };
+  typedef Pick< ( B::Num <= sandwich::MaxFused ) > Picked;
+
+  static const bool UseFused = Picked::Fused;
+
+  /// cost of sp(), as ProdCost
+  struct Cost{
+    static const int Muls = Picked::Muls;
+    static const int Adds = Picked::Adds;
+    static const int Blades = Second::Cost::Blades;
+    static const int Flops = Muls + Adds;
+  };
+
+  constexpr A fused( const A& a, const B& b ) const {
+    return Fused::DO::template Make<A>( a, b );
+  }
+
+  constexpr A staged( const A& a, const B& b ) const {
+    return Second().gp( First().gp( b, Invol ? Involute<A>::Type::template Make(a) : a ), Reverse<B>::Type::template Make(b) );
+  }
+
+  /// hand written kernel, if any (none for reflections)
+  typedef Kernel< Invol ? -1 : cayley::SP, A, B, Metric, SplitIt > K;
+
+  constexpr A sp( const A& a, const B& b ) const {
+    return SandwichPick< UseFused, K::On >::sp( *this, a, b );
   }
 };
 
@@ -442,16 +440,52 @@ template<class M, class A, class B>
 CA cip(const A& a, const B& b) RETURNS(
   ( IProd<A,B,M,true>().ip(a, b) )
 ) 
-//spin a by b, return a
+//scalar part of a * b, conformal
+template<class M, class A, class B>
+constexpr typename A::VT csca(const A& a, const B& b) {
+  return ScalarProd< A, B, M, true >().gp( a, b );
+}
+//scalar part of a * b, diagonal metric M
+template<class M, class A, class B>
+constexpr typename A::VT msca(const A& a, const B& b) {
+  return ScalarProd< A, B, M, false >().gp( a, b );
+}
+//product of a and b reduced to the blades of R
+template<class R, class M, class A, class B>
+constexpr R crgp(const A& a, const B& b) {
+  return RProd< A, B, R, M, true >().gp( a, b );
+}
+template<class R, class M, class A, class B>
+constexpr R mrgp(const A& a, const B& b) {
+  return RProd< A, B, R, M, false >().gp( a, b );
+}
+
+//spin a by b, return a (fused, see vsr_sandwich.h)
 template<class M, class A, class B>
 constexpr A csp(const A& a, const B& b) {
-  return RProd< typename Prod<B,A,M,true>::Type, B, A, M, true>().gp( cgp<M>(b, a),   Reverse< B >::Type::template Make(b) );
+  return SandwichProd< A, B, M, true >().sp( a, b );
 }
 
 //reflect a by b, return a
 template<class M, class A, class B>
 constexpr A cre(const A& a, const B& b) {
-  return RProd< typename Prod<B,A,M,true>::Type, B, A, M, true>().gp( cgp<M>(b, a.involution()),   Reverse< B >::Type::template Make(b) );
+  return SandwichProd< A, B, M, true, true >().sp( a, b );
+}
+
+//spin and reflect in a diagonal metric M
+template<class M, class A, class B>
+constexpr A msp(const A& a, const B& b) {
+  return SandwichProd< A, B, M, false >().sp( a, b );
+}
+template<class M, class A, class B>
+constexpr A mre(const A& a, const B& b) {
+  return SandwichProd< A, B, M, false, true >().sp( a, b );
+}
+
+//scalar part of b * ~b in a diagonal metric M
+template<class M, class B>
+constexpr typename B::VT mwt(const B& b) {
+  return msca<M>( b, Reverse< B >::Type::template Make(b) );
 }
                      
                 
@@ -552,6 +586,7 @@ struct CGAMV : public A {
   
   
   typedef A Type;
+  typedef typename A::VT VT;
     
   typedef typename RMetric<DIM-1,1>::Type M;
 
@@ -569,7 +604,7 @@ struct CGAMV : public A {
   
   //other 
   template< class B >
-  CGAMV<DIM, typename Prod<A, typename CGAMV<DIM,B>::Type, M, true>::Type> 
+  constexpr CGAMV<DIM, typename Prod<A, typename CGAMV<DIM,B>::Type, M, true>::Type> 
   operator * (const CGAMV<DIM, B>& b) const {
     return CGAMV<DIM, typename Prod<A, typename CGAMV<DIM,  B>::Type, M, true>::Type>( cgp<M>( *this, b ) );
   }      
@@ -586,7 +621,7 @@ struct CGAMV : public A {
   // } 
   //other
   template<class B>
-  CGAMV<DIM, typename OProd<A, typename B::Type, M, true>::Type> 
+  constexpr CGAMV<DIM, typename OProd<A, typename B::Type, M, true>::Type> 
   operator ^ (const B& b) const {
     return CGAMV<DIM, typename OProd<A, typename B::Type, M, true>::Type>( cop<M>( *this, b ) );
   }
@@ -597,7 +632,7 @@ struct CGAMV : public A {
   // } 
     //other
   template<class B>
-  CGAMV<DIM, typename IProd<A, typename B::Type, M, true>::Type> 
+  constexpr CGAMV<DIM, typename IProd<A, typename B::Type, M, true>::Type> 
   operator <= (const B& b) const {
     return CGAMV<DIM, typename IProd<A, typename B::Type, M, true>::Type>( cip<M>( *this, b ) );
   } 
@@ -615,26 +650,44 @@ struct CGAMV : public A {
   }
   
    
-  CGAMV<DIM, typename Prod<A, typename CGA<DIM>::Pss, M, true>::Type > 
+  typedef BladeProd< Prod<A, typename CGA<DIM>::Pss, M, true> > PssProd;
+  typedef BladeProd< Prod<A, typename CGA<DIM>::EucPss, M, true> > EucPssProd;
+
+  //products by Pss(-1), Pss(1), EucPss(-1), EucPss(1): signed permutations of the coefficients
+  constexpr CGAMV<DIM, typename PssProd::Type > 
   dual() const{
-    return  CGAMV<DIM, typename Prod<A, typename CGA<DIM>::Pss, M, true>::Type >( cgp<M>( *this,  typename CGA<DIM>::Pss(-1) )  );
+    return  CGAMV<DIM, typename PssProd::Type >( PssProd::template gp<-1>( *this ) );
   } 
-  CGAMV<DIM, typename Prod<A, typename CGA<DIM>::Pss, M, true>::Type > 
+  constexpr CGAMV<DIM, typename PssProd::Type > 
   undual() const{
-    return  CGAMV<DIM, typename Prod<A, typename CGA<DIM>::Pss, M, true>::Type >( cgp<M>( *this,  typename CGA<DIM>::Pss(1) )  );
+    return  CGAMV<DIM, typename PssProd::Type >( PssProd::template gp<1>( *this ) );
   }  
   
-  CGAMV<DIM, typename Prod<A, typename CGA<DIM>::EucPss, M, true>::Type > 
+  constexpr CGAMV<DIM, typename EucPssProd::Type > 
   duale() const{
-    return  CGAMV<DIM, typename Prod<A, typename CGA<DIM>::EucPss, M, true>::Type >( cgp<M>( *this,  typename CGA<DIM>::EucPss(-1) )  );
+    return  CGAMV<DIM, typename EucPssProd::Type >( EucPssProd::template gp<-1>( *this ) );
   } 
-  CGAMV<DIM, typename Prod<A, typename CGA<DIM>::EucPss, M, true>::Type > 
+  constexpr CGAMV<DIM, typename EucPssProd::Type > 
   unduale() const{
-    return  CGAMV<DIM, typename Prod<A, typename CGA<DIM>::EucPss, M, true>::Type >( cgp<M>( *this,  typename CGA<DIM>::EucPss(1) )  );
+    return  CGAMV<DIM, typename EucPssProd::Type >( EucPssProd::template gp<1>( *this ) );
   }  
+
+  /// dual (undual) written into r, e.g. preallocated storage
+  void dualize( CGAMV<DIM, typename PssProd::Type >& r ) const { PssProd::template gp<-1>( *this, r ); }
+  void undualize( CGAMV<DIM, typename PssProd::Type >& r ) const { PssProd::template gp<1>( *this, r ); }
+
+  /// reverse (involute) this in place
+  CGAMV& reverseInPlace(){
+    Flips< typename Reverse< A >::Type >::each( [this]( int k ){ this->val[k] = -this->val[k]; } );
+    return *this;
+  }
+  CGAMV& involuteInPlace(){
+    Flips< typename Involute< A >::Type >::each( [this]( int k ){ this->val[k] = -this->val[k]; } );
+    return *this;
+  }
    
   
-  CGAMV operator ~() const{
+  constexpr CGAMV operator ~() const{
     return Reverse< A >::Type::template Make(*this) ;
   }
   
@@ -645,15 +698,22 @@ struct CGAMV : public A {
     (  *this * !b )
   )   
   
-  CGAMV conj() const { return this -> conjugation(); }
-  CGAMV inv() const { return this -> involution(); } 
+  constexpr CGAMV conj() const { return this -> conjugation(); }
+  constexpr CGAMV inv() const { return this -> involution(); } 
   
-  VT wt() const{ return (*this <= *this)[0]; }
-  VT rwt() const{ return (*this <= ~(*this))[0]; }
+  /// scalar part of *this * b, without computing the other grades
+  template<class B>
+  constexpr VT scalar( const B& b ) const { return csca<M>(*this, b); }
+  /// product with b reduced to the blades of R (instead of a full product and a cast)
+  template<class R, class B>
+  constexpr BType<R> rgp( const B& b ) const { return crgp<R,M>(*this, b); }
+
+  constexpr VT wt() const{ return csca<M>(*this, *this); }
+  constexpr VT rwt() const{ return csca<M>(*this, ~(*this)); }
   VT norm() const { VT a = rwt(); if(a<0) return 0; return sqrt( a ); } 
   VT rnorm() const{ VT a = rwt(); if(a<0) return -sqrt( -a ); return sqrt( a );  }  
   
-  CGAMV unit() const { VT t = sqrt( fabs( (*this <= *this)[0] ) ); if (t == 0) return A(); return *this / t; }
+  CGAMV unit() const { VT t = sqrt( fabs( wt() ) ); if (t == 0) return A(); return *this / t; }
   CGAMV runit() const { VT t = rnorm(); if (t == 0) return  A(); return *this / t; }
     CGAMV tunit() const {    VT t = norm(); if (t == 0) return A(); return *this / t; }  
 
@@ -663,10 +723,10 @@ struct CGAMV : public A {
 
   //test reduced instruction more efficient
   template<typename B>
-  CGAMV sp( const B& b) const { return csp<M>(*this, b); } 
+  constexpr CGAMV sp( const B& b) const { return csp<M>(*this, b); } 
 
   template<typename B>
-  CGAMV spin( const B& b) const { return sp(b); }// (b * (*this) * ~b).template cast<A>(); }
+  constexpr CGAMV spin( const B& b) const { return sp(b); }// (b * (*this) * ~b).template cast<A>(); }
   
   
   //reflection over a VERSOR
@@ -674,33 +734,26 @@ struct CGAMV : public A {
   CGAMV re0( const B& b) const { return (b * (*this).inv() * !b).template cast<A>(); }  
   
   template<typename B>
-  CGAMV re( const B& b) const { return cre<M>(*this, b); } 
+  constexpr CGAMV re( const B& b) const { return cre<M>(*this, b); } 
 
   template<typename B>
-  CGAMV reflect( const B& b) const { return re(b); }// (b * (*this).inv() * !b).template cast<A>(); } 
+  constexpr CGAMV reflect( const B& b) const { return re(b); }// (b * (*this).inv() * !b).template cast<A>(); } 
 
   //refelction over an ODD SUBSPACE = NO involution
   template<typename B>
   CGAMV sre(const B& b) const { return ( b * (*this) * !b).template cast<A>(); }
                                                                                     
   
-  CGAMV operator + (const CGAMV& a) const {  
-     // printf("sum same\n");
-    CGAMV tmp;
-    for (int i = 0; i < A::Num; ++i) tmp[i] = (*this)[i] + a[i];
-    return tmp;
+  constexpr CGAMV operator + (const CGAMV& a) const {  
+    return Each< A, InstSum >::Type::template Make<CGAMV>( *this, a );
   }  
   
-  CGAMV operator - (const CGAMV& a) const {
-    CGAMV tmp;
-    for (int i = 0; i < A::Num; ++i) tmp[i] = (*this)[i] - a[i];
-    return tmp;
+  constexpr CGAMV operator - (const CGAMV& a) const {
+    return Each< A, InstDiff >::Type::template Make<CGAMV>( *this, a );
   }
    
-  CGAMV operator -() const{
-    CGAMV tmp = *this;
-    for (int i = 0; i < A::Num; ++i){ tmp[i] = -tmp[i]; }
-    return tmp;
+  constexpr CGAMV operator -() const{
+    return Each< A, InstScale >::Type::template Make<CGAMV>( *this, VT(-1) );
   }  
   
   CGAMV& operator -=(const CGAMV& b){ 
@@ -712,10 +765,8 @@ struct CGAMV : public A {
     return *this;
   }  
   
-  CGAMV operator / (VT f) const{   
-    CGAMV tmp = *this;
-    for (int i = 0; i < A::Num; ++i){ tmp[i] /= f; }
-    return tmp;
+  constexpr CGAMV operator / (VT f) const{   
+    return Each< A, InstQuot >::Type::template Make<CGAMV>( *this, f );
   }
   
   CGAMV& operator /= (VT f){
@@ -723,10 +774,8 @@ struct CGAMV : public A {
     return *this;
   }
     
-  CGAMV operator * (VT f) const {
-    CGAMV tmp = *this;
-    for (int i = 0; i < A::Num; ++i){ tmp[i] *= f; }
-    return tmp;
+  constexpr CGAMV operator * (VT f) const {
+    return Each< A, InstScale >::Type::template Make<CGAMV>( *this, f );
   }
   CGAMV& operator *= (VT f){
     for (int i = 0; i < A::Num; ++i){ (*this)[i] *= f; }
@@ -745,7 +794,8 @@ struct CGAMV : public A {
     return sum(*this, b); 
   }                       
   
-   static CGAMV x, y, z, xy, xz, yz;   
+   /// unit basis blades, constant (built at compile time)
+   static const CGAMV x, y, z, xy, xz, yz;   
 
    //IMPLEMENTATION OF METHODS BELOW ARE IN vsr_generic_op.h and vsr_cga3D_op.h
    //NOTE NEED TO BE MADE CONST!!
@@ -803,6 +853,13 @@ struct CGAMV : public A {
   template<typename T>
   CGAMV boost( const T& ) const;
  
+  /// cost of the products with T (see ProdCost), e.g. Pnt::GPCost<Mot>::Flops
+  template<typename T> using GPCost = typename Prod< A, T, typename Mode::M, true >::Cost;
+  template<typename T> using OPCost = typename OProd< A, T, typename Mode::M, true >::Cost;
+  template<typename T> using IPCost = typename IProd< A, T, typename Mode::M, true >::Cost;
+  /// cost of the sandwich by versor T
+  template<typename T> using SPCost = typename SandwichProd< A, T, typename Mode::M, true >::Cost;
+
   template<typename T>
   static void PrintGP(){
     Prod< A, T, typename Mode::M, true>::DO::print(); 
@@ -824,16 +881,16 @@ struct CGAMV : public A {
   // }   
 };
 
-template<TT DIM, class A> CGAMV<DIM,A> CGAMV<DIM,A>::x = A().A::template set<1>(1);
-template<TT DIM, class A> CGAMV<DIM,A> CGAMV<DIM,A>::y =  A().A::template set<2>(1);  
-template<TT DIM, class A> CGAMV<DIM,A> CGAMV<DIM,A>::z =  A().A::template set<4>(1);  
-template<TT DIM, class A> CGAMV<DIM,A> CGAMV<DIM,A>::xy = A().A::template set<3>(1);  
-template<TT DIM, class A> CGAMV<DIM,A> CGAMV<DIM,A>::xz = A().A::template set<5>(1);  
-template<TT DIM, class A> CGAMV<DIM,A> CGAMV<DIM,A>::yz = A().A::template set<6>(1);  
+template<TT DIM, class A> constexpr CGAMV<DIM,A> CGAMV<DIM,A>::x = basis<A,1>();
+template<TT DIM, class A> constexpr CGAMV<DIM,A> CGAMV<DIM,A>::y = basis<A,2>();  
+template<TT DIM, class A> constexpr CGAMV<DIM,A> CGAMV<DIM,A>::z = basis<A,4>();  
+template<TT DIM, class A> constexpr CGAMV<DIM,A> CGAMV<DIM,A>::xy = basis<A,3>();  
+template<TT DIM, class A> constexpr CGAMV<DIM,A> CGAMV<DIM,A>::xz = basis<A,5>();  
+template<TT DIM, class A> constexpr CGAMV<DIM,A> CGAMV<DIM,A>::yz = basis<A,6>();  
 
 template<TT DIM, class A> CGAMV<DIM,A> CGAMV<DIM,A>::operator !() const {    
   CGAMV tmp = ~(*this); 
-  VT v = ((*this) * tmp)[0];    
+  VT v = csca<M>(*this, tmp);    
   return (v==0) ? tmp : tmp / v;
 }  
 
@@ -843,6 +900,7 @@ template<class M, class A>
 struct MGAMV : public A {  
  
     typedef A Type;
+  typedef typename A::VT VT;
   //static const int DIM = M::Num;
   
   template< class ... Args >
@@ -866,11 +924,11 @@ struct MGAMV : public A {
   }  
    
   MGAMV<M, typename Prod<A, typename MGA<M>::Pss, M, false>::Type > dual(){
-    return  MGAMV<M, typename Prod<A, typename MGA<M>::Pss, M, false>::Type >( mgp<M>( *this,  typename MGA<M>::Pss(-1) )  );
+    return  MGAMV<M, typename Prod<A, typename MGA<M>::Pss, M, false>::Type >( BladeProd< Prod<A, typename MGA<M>::Pss, M, false> >::template gp<-1>( *this )  );
   }  
   
   MGAMV<M, typename Prod<A, typename MGA<M>::Pss, M, false>::Type > undual(){
-    return  MGAMV<M, typename Prod<A, typename MGA<M>::Pss, M, false>::Type >( mgp<M>( *this,  typename MGA<M>::Pss(1) )  );
+    return  MGAMV<M, typename Prod<A, typename MGA<M>::Pss, M, false>::Type >( BladeProd< Prod<A, typename MGA<M>::Pss, M, false> >::template gp<1>( *this )  );
   }  
   
   MGAMV operator ~() const{
@@ -887,28 +945,35 @@ struct MGAMV : public A {
   MGAMV conj() const { return this -> conjugation(); }
   MGAMV inv() const { return this -> involution(); } 
   
-  VT wt() const{ return (*this <= *this)[0]; }
-  VT rwt() const{ return (*this <= ~(*this))[0]; }
+  /// scalar part of *this * b, without computing the other grades
+  template<class B>
+  VT scalar( const B& b ) const { return msca<M>(*this, b); }
+  /// product with b reduced to the blades of R (instead of a full product and a cast)
+  template<class R, class B>
+  MGAMV<M,R> rgp( const B& b ) const { return mrgp<R,M>(*this, b); }
+
+  VT wt() const{ return msca<M>(*this, *this); }
+  VT rwt() const{ return msca<M>(*this, ~(*this)); }
   VT norm() const { VT a = rwt(); if(a<0) return 0; return sqrt( a ); } 
   VT rnorm() const{ VT a = rwt(); if(a<0) return -sqrt( -a ); return sqrt( a );  }  
   
-  MGAMV unit() const { VT t = sqrt( fabs( (*this <= *this)[0] ) ); if (t == 0) return A(); return *this / t; }
+  MGAMV unit() const { VT t = sqrt( fabs( wt() ) ); if (t == 0) return A(); return *this / t; }
   MGAMV runit() const { VT t = rnorm(); if (t == 0) return  A(); return *this / t; }
     MGAMV tunit() const {    VT t = norm(); if (t == 0) return A(); return *this / t; }  
 
   template<typename B>
-  MGAMV sp( const B& b) const { return (b * (*this) * ~b).template cast<A>(); } 
+  MGAMV sp( const B& b) const { return msp<M>(*this, b); } 
   template<typename B>
-  MGAMV spin( const B& b) const { return (b * (*this) * ~b).template cast<A>(); }
+  MGAMV spin( const B& b) const { return sp(b); }
   
   //test reduced instruction (more efficent) 
   template<typename B>
   MGAMV sptest( const B& b) const { return csp<M>(*this, b); }
    
   template<typename B>
-  MGAMV re( const B& b) const { return (b * (*this).inv() * !b).template cast<A>(); }  
+  MGAMV re( const B& b) const { VT v = mwt<M>(b); MGAMV r = mre<M>(*this, b); return (v==0) ? r : r / v; }  
   template<typename B>
-  MGAMV reflect( const B& b) const { return (b * (*this).inv() * !b).template cast<A>(); } 
+  MGAMV reflect( const B& b) const { return re(b); } 
                                                                                     
   
   MGAMV operator + (const MGAMV& a) const {  
@@ -980,6 +1045,8 @@ struct EGAMV : public A {
   template< class B > using BType = EGAMV<DIM, B >;
     typedef EGA<DIM>  Mode;
     typedef A Type;
+    typedef typename A::VT VT;
+    typedef typename RMetric<DIM,0>::Type M;
 
   template< class ... Args >
   constexpr EGAMV(Args...v) : A(v...) {}  
@@ -991,30 +1058,30 @@ struct EGAMV : public A {
   constexpr EGAMV(const EGAMV<BDIM, B>& b) : A( b.template cast<A>() ) {}
    
   template<class B>
-  EGAMV<DIM, typename EProd<A, typename B::Type>::Type> 
+  constexpr EGAMV<DIM, typename EProd<A, typename B::Type>::Type> 
   operator * (const B& b) const {
     return EGAMV<DIM, typename EProd<A, typename B::Type>::Type>( egp( *this, b ) );
   }     
 
   template<class B>
-  EGAMV<DIM, typename EOProd<A, typename B::Type>::Type> 
+  constexpr EGAMV<DIM, typename EOProd<A, typename B::Type>::Type> 
   operator ^ (const B& b) const {
     return EGAMV<DIM, typename EOProd<A, typename B::Type>::Type>( eop( *this, b ) );
   }
  
   template<class B>
-  EGAMV<DIM, typename EIProd<A, typename B::Type>::Type> 
+  constexpr EGAMV<DIM, typename EIProd<A, typename B::Type>::Type> 
   operator <= (const B& b) const {
     return EGAMV<DIM, typename EIProd<A, typename B::Type>::Type>( eip( *this, b ) );
   } 
   
-  EGAMV operator ~() const {
+  constexpr EGAMV operator ~() const {
     return Reverse< A >::Type::template Make(*this) ;
   }
   
   EGAMV operator !() const {    
     EGAMV tmp = ~(*this); 
-    VT v = ((*this) * tmp)[0];    
+    VT v = msca<M>(*this, tmp);    
     return (v==0) ? tmp : tmp / v;
   }
   
@@ -1023,23 +1090,30 @@ struct EGAMV : public A {
     (  *this * !b )
   )
   
-  EGAMV conj() const { return this -> conjugation(); }
-  EGAMV inv() const { return this -> involution(); }
+  constexpr EGAMV conj() const { return this -> conjugation(); }
+  constexpr EGAMV inv() const { return this -> involution(); }
   
   template<typename B>
-  EGAMV sp( const B& b) const { return (b * (*this) * ~b).template cast<A>(); }  
+  constexpr EGAMV sp( const B& b) const { return msp<M>(*this, b); }  
   
   template<typename B>
-  EGAMV re( const B& b) const { return (b * (*this).inv() * !b).template cast<A>(); } 
+  EGAMV re( const B& b) const { VT v = mwt<M>(b); EGAMV r = mre<M>(*this, b); return (v==0) ? r : r / v; } 
   
   template<typename B>
   EGAMV reflect( const B& b ) const { return re(b); }
    
-  VT wt() const{ return (*this <= *this)[0]; }
-  VT rwt() const{ return (*this <= ~(*this))[0]; }
+  /// scalar part of *this * b, without computing the other grades
+  template<class B>
+  constexpr VT scalar( const B& b ) const { return msca<M>(*this, b); }
+  /// product with b reduced to the blades of R (instead of a full product and a cast)
+  template<class R, class B>
+  constexpr BType<R> rgp( const B& b ) const { return mrgp<R,M>(*this, b); }
+
+  constexpr VT wt() const{ return msca<M>(*this, *this); }
+  constexpr VT rwt() const{ return msca<M>(*this, ~(*this)); }
   VT norm() const { VT a = rwt(); if(a<0) return 0; return sqrt( a ); } 
   VT rnorm() const{ VT a = rwt(); if(a<0) return -sqrt( -a ); return sqrt( a );  }  
-  EGAMV unit() const { VT t = sqrt( fabs( (*this <= *this)[0] ) ); if (t == 0) return A(); return *this / t; }
+  EGAMV unit() const { VT t = sqrt( fabs( wt() ) ); if (t == 0) return A(); return *this / t; }
   EGAMV runit() const { VT t = rnorm(); if (t == 0) return  A(); return *this / t; }
     EGAMV tunit() const {    VT t = norm(); if (t == 0) return A(); return *this / t; }  
 
@@ -1048,22 +1122,16 @@ struct EGAMV : public A {
     return sum(*this,b);
   }   
   
-  EGAMV operator + (const EGAMV& a) const {
-    EGAMV tmp;
-    for (int i = 0; i < A::Num; ++i) tmp[i] = (*this)[i] + a[i];
-    return tmp;
+  constexpr EGAMV operator + (const EGAMV& a) const {
+    return Each< A, InstSum >::Type::template Make<EGAMV>( *this, a );
   }  
   
-  EGAMV operator - (const EGAMV& a) const {
-    EGAMV tmp;
-    for (int i = 0; i < A::Num; ++i) tmp[i] = (*this)[i] - a[i];
-    return tmp;
+  constexpr EGAMV operator - (const EGAMV& a) const {
+    return Each< A, InstDiff >::Type::template Make<EGAMV>( *this, a );
   }
    
-  EGAMV operator -() const{
-    EGAMV tmp = *this;
-    for (int i = 0; i < A::Num; ++i){ tmp[i] = -tmp[i]; }
-    return tmp;
+  constexpr EGAMV operator -() const{
+    return Each< A, InstScale >::Type::template Make<EGAMV>( *this, VT(-1) );
   }  
   
   EGAMV& operator -=(const EGAMV& b){ 
@@ -1075,10 +1143,8 @@ struct EGAMV : public A {
     return *this;
   }  
   
-  EGAMV operator / (VT f) const{   
-    EGAMV tmp = *this;
-    for (int i = 0; i < A::Num; ++i){ tmp[i] /= f; }
-    return tmp;
+  constexpr EGAMV operator / (VT f) const{   
+    return Each< A, InstQuot >::Type::template Make<EGAMV>( *this, f );
   }
   
   EGAMV& operator /= (VT f){
@@ -1086,10 +1152,8 @@ struct EGAMV : public A {
     return *this;
   }
     
-  EGAMV operator * (VT f) const {
-    EGAMV tmp = *this;
-    for (int i = 0; i < A::Num; ++i){ tmp[i] *= f; }
-    return tmp;
+  constexpr EGAMV operator * (VT f) const {
+    return Each< A, InstScale >::Type::template Make<EGAMV>( *this, f );
   }
   EGAMV& operator *= (VT f){
     for (int i = 0; i < A::Num; ++i){ (*this)[i] *= f; }
@@ -1101,14 +1165,15 @@ struct EGAMV : public A {
     return sumv(a, *this); 
   }   
   
-  static EGAMV x, y, z, xy, xz, yz;  
+  /// unit basis blades, constant (built at compile time)
+  static const EGAMV x, y, z, xy, xz, yz;  
   
   auto dual() const -> EGAMV< DIM, typename EProd< A, typename EGA<DIM>::Pss>::Type > { 
-    return egp( *this , typename EGA<DIM>::Pss( -1 ) );
+    return BladeProd< EProd< A, typename EGA<DIM>::Pss > >::template gp<-1>( *this );
   }        
   
   auto undual() const -> EGAMV< DIM, typename EProd< A, typename EGA<DIM>::Pss>::Type> {  
-    return egp( *this , typename EGA<DIM>::Pss ( 1 ) );
+    return BladeProd< EProd< A, typename EGA<DIM>::Pss > >::template gp<1>( *this );
   }
   
   
@@ -1123,61 +1188,85 @@ struct EGAMV : public A {
 };   
 
 
-template<TT DIM, class A> EGAMV<DIM,A> EGAMV<DIM,A>::x = A(). A::template set<1>(1);
-template<TT DIM, class A> EGAMV<DIM,A> EGAMV<DIM,A>::y =  A().A::template set<2>(1);  
-template<TT DIM, class A> EGAMV<DIM,A> EGAMV<DIM,A>::z =  A().A::template set<4>(1);  
-template<TT DIM, class A> EGAMV<DIM,A> EGAMV<DIM,A>::xy = A().A::template set<3>(1);  
-template<TT DIM, class A> EGAMV<DIM,A> EGAMV<DIM,A>::xz = A().A::template set<5>(1);  
-template<TT DIM, class A> EGAMV<DIM,A> EGAMV<DIM,A>::yz = A().A::template set<6>(1);
+template<TT DIM, class A> constexpr EGAMV<DIM,A> EGAMV<DIM,A>::x = basis<A,1>();
+template<TT DIM, class A> constexpr EGAMV<DIM,A> EGAMV<DIM,A>::y = basis<A,2>();  
+template<TT DIM, class A> constexpr EGAMV<DIM,A> EGAMV<DIM,A>::z = basis<A,4>();  
+template<TT DIM, class A> constexpr EGAMV<DIM,A> EGAMV<DIM,A>::xy = basis<A,3>();  
+template<TT DIM, class A> constexpr EGAMV<DIM,A> EGAMV<DIM,A>::xz = basis<A,5>();  
+template<TT DIM, class A> constexpr EGAMV<DIM,A> EGAMV<DIM,A>::yz = basis<A,6>();
          
 
+/// Diagonal metric of the algebra of versor type V, and whether it is split (conformal)
+template<class V>
+struct VersorMetric;
+
+template<TT DIM, class A>
+struct VersorMetric< CGAMV<DIM, A> >{
+  typedef typename RMetric<DIM-1,1>::Type M;
+  static const bool Split = true;
+};
+template<TT DIM, class A>
+struct VersorMetric< EGAMV<DIM, A> >{
+  typedef typename RMetric<DIM,0>::Type M;
+  static const bool Split = false;
+};
+template<class MT, class A>
+struct VersorMetric< MGAMV<MT, A> >{
+  typedef MT M;
+  static const bool Split = false;
+};
+
 //EUCLIDEAN CANDIDATES
-template<TT N> using NESca = EGAMV<N, typename EGA<N>::Sca>;   
-template<TT N> using NEVec = EGAMV<N, typename EGA<N>::Vec>; 
-template<TT N> using NEBiv = EGAMV<N, typename EGA<N>::Biv>; 
-template<TT N> using NETri = EGAMV<N, typename EGA<N>::Tri>; 
-template<TT N> using NEPss = EGAMV<N, typename EGA<N>::Pss>; 
-template<TT N> using NERot = EGAMV<N, typename EGA<N>::Rot>; 
+template<TT N, class T = VT> using NESca = EGAMV<N, typename Rebind<typename EGA<N>::Sca, T>::Type>;   
+template<TT N, class T = VT> using NEVec = EGAMV<N, typename Rebind<typename EGA<N>::Vec, T>::Type>; 
+template<TT N, class T = VT> using NEBiv = EGAMV<N, typename Rebind<typename EGA<N>::Biv, T>::Type>; 
+template<TT N, class T = VT> using NETri = EGAMV<N, typename Rebind<typename EGA<N>::Tri, T>::Type>; 
+template<TT N, class T = VT> using NEPss = EGAMV<N, typename Rebind<typename EGA<N>::Pss, T>::Type>; 
+template<TT N, class T = VT> using NERot = EGAMV<N, typename Rebind<typename EGA<N>::Rot, T>::Type>; 
 template<TT N, TT ... NN> using NEe   = EGAMV<N, typename EGA<N>::template e<NN...> >;   
 
 //N-Dimensional Conformal Candidates  
 //e.g. Ne<5,3> = e3 in 3D conformal                      
-template<TT N, TT E> using Ne  =  CGAMV<N,typename CGA<N>::template e<E> >; 
-template<TT N> using NSca     = CGAMV<N, typename CGA<N>::Sca>;   
-template<TT N> using NVec     = CGAMV<N, typename CGA<N>::Vec>; 
-template<TT N> using NVec2D   = CGAMV<N, typename CGA<N>::Vec2D>;  
-template<TT N> using NBiv     = CGAMV<N, typename CGA<N>::Biv>; 
-template<TT N> using NTri     = CGAMV<N, typename CGA<N>::Tri>; 
-template<TT N> using NRot     = CGAMV<N, typename CGA<N>::Rot>;
-template<TT N> using NOri     = CGAMV<N, typename CGA<N>::Ori>;  
-template<TT N> using NInf     = CGAMV<N, typename CGA<N>::Inf>;  
-template<TT N> using NMnk     = CGAMV<N, typename CGA<N>::Mnk>;  
-template<TT N> using NPss     = CGAMV<N, typename CGA<N>::Pss>;
-template<TT N> using NEucPss   = CGAMV<N, typename CGA<N>::EucPss>; 
-template<TT N> using NPnt      = CGAMV<N, typename CGA<N>::Pnt>;  
-template<TT N> using NDls      = CGAMV<N, typename CGA<N>::Pnt>; 
-template<TT N> using NPar      = CGAMV<N, typename CGA<N>::Par>;  
-template<TT N> using NCir      = CGAMV<N, typename CGA<N>::Cir>;  
-template<TT N> using NSph      = CGAMV<N, typename CGA<N>::Sph>;  
-template<TT N> using NDrv      = CGAMV<N, typename CGA<N>::Drv>;  
-template<TT N> using NTnv      = CGAMV<N, typename CGA<N>::Tnv>;  
-template<TT N> using NDrb      = CGAMV<N, typename CGA<N>::Drb>;  
-template<TT N> using NTnb      = CGAMV<N, typename CGA<N>::Tnb>;  
-template<TT N> using NDrt      = CGAMV<N, typename CGA<N>::Drt>;  
-template<TT N> using NTnt      = CGAMV<N, typename CGA<N>::Tnt>; 
-template<TT N> using NDll      = CGAMV<N, typename CGA<N>::Dll>;  
-template<TT N> using NLin      = CGAMV<N, typename CGA<N>::Lin>;  
-template<TT N> using NFlp      = CGAMV<N, typename CGA<N>::Flp>;  
-template<TT N> using NPln      = CGAMV<N, typename CGA<N>::Pln>; 
-template<TT N> using NDlp      = CGAMV<N, typename CGA<N>::Dlp>;   
-template<TT N> using NTrs      = CGAMV<N, typename CGA<N>::Trs>;  
-template<TT N> using NMot      = CGAMV<N, typename CGA<N>::Mot>;  
-template<TT N> using NTrv      = CGAMV<N, typename CGA<N>::Trv>;  
-template<TT N> using NBst      = CGAMV<N, typename CGA<N>::Bst>; 
-template<TT N> using NDil      = CGAMV<N, typename CGA<N>::Dil>;
-template<TT N> using NTsd      = CGAMV<N, typename CGA<N>::Tsd>;
+template<TT N, TT E, class T = VT> using Ne  =  CGAMV<N, typename Rebind<typename CGA<N>::template e<E>, T>::Type >; 
+template<TT N, class T = VT> using NSca     = CGAMV<N, typename Rebind<typename CGA<N>::Sca, T>::Type>;   
+template<TT N, class T = VT> using NVec     = CGAMV<N, typename Rebind<typename CGA<N>::Vec, T>::Type>; 
+template<TT N, class T = VT> using NVec2D   = CGAMV<N, typename Rebind<typename CGA<N>::Vec2D, T>::Type>;  
+template<TT N, class T = VT> using NBiv     = CGAMV<N, typename Rebind<typename CGA<N>::Biv, T>::Type>; 
+template<TT N, class T = VT> using NTri     = CGAMV<N, typename Rebind<typename CGA<N>::Tri, T>::Type>; 
+template<TT N, class T = VT> using NRot     = CGAMV<N, typename Rebind<typename CGA<N>::Rot, T>::Type>;
+template<TT N, class T = VT> using NOri     = CGAMV<N, typename Rebind<typename CGA<N>::Ori, T>::Type>;  
+template<TT N, class T = VT> using NInf     = CGAMV<N, typename Rebind<typename CGA<N>::Inf, T>::Type>;  
+template<TT N, class T = VT> using NMnk     = CGAMV<N, typename Rebind<typename CGA<N>::Mnk, T>::Type>;  
+template<TT N, class T = VT> using NPss     = CGAMV<N, typename Rebind<typename CGA<N>::Pss, T>::Type>;
+template<TT N, class T = VT> using NEucPss   = CGAMV<N, typename Rebind<typename CGA<N>::EucPss, T>::Type>; 
+template<TT N, class T = VT> using NPnt      = CGAMV<N, typename Rebind<typename CGA<N>::Pnt, T>::Type>;  
+template<TT N, class T = VT> using NDls      = CGAMV<N, typename Rebind<typename CGA<N>::Pnt, T>::Type>; 
+template<TT N, class T = VT> using NPar      = CGAMV<N, typename Rebind<typename CGA<N>::Par, T>::Type>;  
+template<TT N, class T = VT> using NCir      = CGAMV<N, typename Rebind<typename CGA<N>::Cir, T>::Type>;  
+template<TT N, class T = VT> using NSph      = CGAMV<N, typename Rebind<typename CGA<N>::Sph, T>::Type>;  
+template<TT N, class T = VT> using NDrv      = CGAMV<N, typename Rebind<typename CGA<N>::Drv, T>::Type>;  
+template<TT N, class T = VT> using NTnv      = CGAMV<N, typename Rebind<typename CGA<N>::Tnv, T>::Type>;  
+template<TT N, class T = VT> using NDrb      = CGAMV<N, typename Rebind<typename CGA<N>::Drb, T>::Type>;  
+template<TT N, class T = VT> using NTnb      = CGAMV<N, typename Rebind<typename CGA<N>::Tnb, T>::Type>;  
+template<TT N, class T = VT> using NDrt      = CGAMV<N, typename Rebind<typename CGA<N>::Drt, T>::Type>;  
+template<TT N, class T = VT> using NTnt      = CGAMV<N, typename Rebind<typename CGA<N>::Tnt, T>::Type>; 
+template<TT N, class T = VT> using NDll      = CGAMV<N, typename Rebind<typename CGA<N>::Dll, T>::Type>;  
+template<TT N, class T = VT> using NLin      = CGAMV<N, typename Rebind<typename CGA<N>::Lin, T>::Type>;  
+template<TT N, class T = VT> using NFlp      = CGAMV<N, typename Rebind<typename CGA<N>::Flp, T>::Type>;  
+template<TT N, class T = VT> using NPln      = CGAMV<N, typename Rebind<typename CGA<N>::Pln, T>::Type>; 
+template<TT N, class T = VT> using NDlp      = CGAMV<N, typename Rebind<typename CGA<N>::Dlp, T>::Type>;   
+template<TT N, class T = VT> using NTrs      = CGAMV<N, typename Rebind<typename CGA<N>::Trs, T>::Type>;  
+template<TT N, class T = VT> using NMot      = CGAMV<N, typename Rebind<typename CGA<N>::Mot, T>::Type>;  
+template<TT N, class T = VT> using NTrv      = CGAMV<N, typename Rebind<typename CGA<N>::Trv, T>::Type>;  
+template<TT N, class T = VT> using NBst      = CGAMV<N, typename Rebind<typename CGA<N>::Bst, T>::Type>; 
+template<TT N, class T = VT> using NDil      = CGAMV<N, typename Rebind<typename CGA<N>::Dil, T>::Type>;
+template<TT N, class T = VT> using NTsd      = CGAMV<N, typename Rebind<typename CGA<N>::Tsd, T>::Type>;
 
  
 } //vsr::
 
+#ifdef VSR_KERNELS
+#include "vsr_cga3D_kernels.h"
+#endif
+
 #endif
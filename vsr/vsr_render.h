@@ -29,31 +29,32 @@ namespace vsr{
   /*   MBO& operator()(){ return mbo; } */ 
   /* } */
 
-  MBO& MeshBuffer(const Frame& s){ static MBO mbo( Mesh::Frame() ); return mbo; }
-  MBO& MeshBuffer(const Cir& s){ static MBO mbo( Mesh::Circle() ); return mbo; }
+  //buffers are per thread, as is the GL context drawing them
+  MBO& MeshBuffer(const Frame& s){ static thread_local MBO mbo( Mesh::Frame() ); return mbo; }
+  MBO& MeshBuffer(const Cir& s){ static thread_local MBO mbo( Mesh::Circle() ); return mbo; }
   
   vector<MBO>& MeshBuffer(const Vec& s){ 
-    static vector<MBO> m = { Mesh::Cone(.3), MBO( Mesh::Line( Vec(0,0,0), s), GL::DYNAMIC )  }; 
+    static thread_local vector<MBO> m = { Mesh::Cone(.3), MBO( Mesh::Line( Vec(0,0,0), s), GL::DYNAMIC )  }; 
     return m; 
   }
 
   vector<MBO>& MeshBuffer(const Pnt& s){ 
-    static vector<MBO> m = { Mesh::Sphere(), Mesh::Point( Pnt() ) };
+    static thread_local vector<MBO> m = { Mesh::Sphere(), Mesh::Point( Pnt() ) };
     return m; 
   }
 
   vector<MBO>& MeshBuffer(const Sph& s ) { return MeshBuffer( Pnt() ); }
 
   vector<MBO>& MeshBuffer(const Par& s ) { 
-    static vector<MBO> m = { Mesh::Sphere(), Mesh::Points( Ro::split(s) ) };
+    static thread_local vector<MBO> m = { Mesh::Sphere(), Mesh::Points( Ro::split(s) ) };
     return m; 
   }
  
-  MBO& MeshBuffer(const Dll& s ) {  static MBO mbo( Mesh::Line( Vec(0,0,-50), Vec(0,0,50) ), GL::DYNAMIC ); return mbo; }  
+  MBO& MeshBuffer(const Dll& s ) {  static thread_local MBO mbo( Mesh::Line( Vec(0,0,-50), Vec(0,0,50) ), GL::DYNAMIC ); return mbo; }  
   MBO& MeshBuffer(const Lin& s ) {  return MeshBuffer( Dll() ); }  
-  MBO& MeshBuffer( const Pln& p) {  static MBO mbo( Mesh::Grid(10,10) );  return mbo; }
+  MBO& MeshBuffer( const Pln& p) {  static thread_local MBO mbo( Mesh::Grid(10,10) );  return mbo; }
   MBO& MeshBuffer( const Dlp& p) {  return MeshBuffer( Pln() ); }
-  MBO& MeshBuffer( const Biv& p) {  static MBO mbo( Mesh::Circle() ); return mbo; }
+  MBO& MeshBuffer( const Biv& p) {  static thread_local MBO mbo( Mesh::Circle() ); return mbo; }
 
 
   template<class T>
@@ -110,7 +111,7 @@ namespace vsr{
    */
   void Render(const Frame& frame, Renderer * re )  { 
     MBO& fm = MeshBuffer( frame );
-    re -> modelview( vsr::Xf::mat( frame.rot(), frame.vec(), frame.scale() ) );
+    re -> modelview( frame.mat() );
     re -> pipe.line( fm );
   }  
  
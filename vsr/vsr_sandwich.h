@@ -0,0 +1,413 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_sandwich.h
+ *
+ *    Description:  instruction lists for fused sandwich products  b * a * ~b
+ *                  (and  b * a.involution() * ~b), see SandwichProd in vsr_products.h
+ *
+ *                  Instead of evaluating b*a into an intermediate type and then
+ *                  multiplying by ~b, the instruction list is built directly on the
+ *                  bilinear form in b:
+ *
+ *                    r[k] = sum_l a[l] * sum_{i<=j} W(k,l,i,j) * b[i] * b[j]
+ *
+ *                  where the weights W of the b[i]*b[j] and b[j]*b[i] terms are
+ *                  merged at compile time and zero weights are dropped.  Each row
+ *                  is a plain sum of products of the same b[i]*b[j] pairs, so the
+ *                  compiler shares them between rows and contracts row sums into fma.
+ *                  If b is loop invariant (one versor on many elements) the pair
+ *                  sums are hoisted and each element costs one small matrix multiply.
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_sandwich_INC
+#define  vsr_sandwich_INC
+
+#include "vsr_lists.h"
+#include "vsr_instructions.h"
+#include "vsr_versions.h"
+
+namespace vsr {
+
+/*-----------------------------------------------------------------------------
+ *  BITMASK of basis vectors with negative signature in diagonal metric M
+ *-----------------------------------------------------------------------------*/
+template<class M, int N = 0>
+struct NegMask{
+  static const TT Val = ( M::HEAD < 0 ? (1 << N) : 0 ) | NegMask< typename M::TAIL, N+1 >::Val;
+};
+template<class T, int N>
+struct NegMask< MVT<T>, N >{
+  static const TT Val = 0;
+};
+
+/*-----------------------------------------------------------------------------
+ *  Blade arithmetic on numbers (weights are exact in binary: 1, 1/2, ...)
+ *-----------------------------------------------------------------------------*/
+namespace sandwich {
+
+  constexpr unsigned fold( unsigned x, int s ){ return x ^ ( x >> s ); }
+  /// bit p: parity of the bits of a above p
+  constexpr unsigned above( unsigned a ){ return fold( fold( fold( fold( a >> 1, 1 ), 2 ), 4 ), 8 ); }
+
+  /// parity of the swaps to reorder a * b (as signFlip, but without recursion)
+  constexpr int swaps( unsigned a, unsigned b ){ return __builtin_popcount( above(a) & b ) & 1; }
+
+  /// sign of the product of diagonal basis blades a * b
+  constexpr int dsign( TT a, TT b, TT neg ){
+    return ( ( swaps(a,b) + __builtin_popcount( a & b & neg ) ) & 1 ) ? -1 : 1;
+  }
+
+  /// sign of the reverse of blade a
+  constexpr double rev( TT a ){ return ( __builtin_popcount(a) & 2 ) ? -1.0 : 1.0; }
+
+  constexpr TT obit( TT dim ){ return 1 << (dim-2); }
+  constexpr TT ibit( TT dim ){ return 1 << (dim-1); }
+  /// true if a holds exactly one of no, ni (or e+, e-)
+  constexpr bool mixed( TT a, TT dim ){
+    return ( (a & obit(dim)) == 0 ) != ( (a & ibit(dim)) == 0 );
+  }
+  constexpr TT swap( TT a, TT dim ){ return a ^ obit(dim) ^ ibit(dim); }
+
+  /// no = .5e+ + .5e-,  ni = -e+ + e-  (e+ in the no slot, e- in the ni slot)
+  constexpr double pushWt( TT a, int n, TT dim ){
+    return !mixed(a,dim) ? 1.0 : ( a & obit(dim) ) ? .5 : ( n == 0 ? 1.0 : -1.0 );
+  }
+  /// e+ = no - .5ni,  e- = no + .5ni
+  constexpr double popWt( TT a, int n, TT dim ){
+    return !mixed(a,dim) ? 1.0 : ( a & obit(dim) ) ? ( n == 0 ? 1.0 : -.5 ) : ( n == 0 ? .5 : 1.0 );
+  }
+  constexpr TT nth( TT a, int n, TT dim ){ return n == 0 ? a : swap(a,dim); }
+
+  /// quick test whether x*y*z can have a component in blade t, given x^y^z == d
+  constexpr bool reaches( TT d, TT t, TT dim, bool split ){
+    return split ? ( ( d ^ t ) & ~( obit(dim) | ibit(dim) ) ) == 0 && !( mixed(d,dim) ^ mixed(t,dim) ) : d == t;
+  }
+
+  /// coefficient of null blade t in diagonal blade d
+  constexpr double pop( TT d, TT t, TT dim ){
+    return ( d == t ? popWt(d,0,dim) : 0.0 ) + ( mixed(d,dim) && swap(d,dim) == t ? popWt(d,1,dim) : 0.0 );
+  }
+
+  /// coefficient of t in x*y*z, all diagonal (split) or all plain (not split)
+  constexpr double diag( TT x, TT y, TT z, TT t, TT dim, TT neg, bool split ){
+    return dsign(x,y,neg) * dsign(x^y,z,neg) * ( split ? pop( x^y^z, t, dim ) : ( (x^y^z) == t ? 1.0 : 0.0 ) );
+  }
+
+  /// coefficient of t in x*y*z, pushing null blades from position p on
+  constexpr double coef( TT x, TT y, TT z, TT t, TT dim, TT neg, bool split, int p = 0 ){
+    return !split ? diag(x,y,z,t,dim,neg,false) :
+      p == 0 ? pushWt(x,0,dim) * coef( nth(x,0,dim), y, z, t, dim, neg, split, 1 )
+               + ( mixed(x,dim) ? pushWt(x,1,dim) * coef( nth(x,1,dim), y, z, t, dim, neg, split, 1 ) : 0.0 ) :
+      p == 1 ? pushWt(y,0,dim) * coef( x, nth(y,0,dim), z, t, dim, neg, split, 2 )
+               + ( mixed(y,dim) ? pushWt(y,1,dim) * coef( x, nth(y,1,dim), z, t, dim, neg, split, 2 ) : 0.0 ) :
+      p == 2 ? pushWt(z,0,dim) * coef( x, y, nth(z,0,dim), t, dim, neg, split, 3 )
+               + ( mixed(z,dim) ? pushWt(z,1,dim) * coef( x, y, nth(z,1,dim), t, dim, neg, split, 3 ) : 0.0 ) :
+      diag(x,y,z,t,dim,neg,true);
+  }
+
+  /// weights are stored as integer multiples of 1/Den
+  constexpr int Den = 64;
+
+  /// versors of more blades (Mot, Bst, ...) are always staged: their B(B+1)/2 pair
+  /// products alone cost about what (b*a)*~b does, so the fused list is not even
+  /// counted (tests/xSandwich.cpp checks the choice against the count)
+  constexpr int MaxFused = 5;
+
+  constexpr int fix( double w ){ return (int)( w * Den + ( w < 0 ? -.5 : .5 ) ); }
+
+} // sandwich::
+
+/*!
+ *  Metric configuration of a sandwich: diagonal metric M, split into null basis or not
+ */
+template<class Metric, bool SplitIt>
+struct SandwichMetric{
+  static const TT Dim = Metric::Num;
+  static const TT Neg = NegMask<Metric>::Val;
+  /// bits of x^y^z that must equal those of the target blade (all but no, ni if split)
+  static const TT Fixed = SplitIt ? ~( sandwich::obit(Dim) | sandwich::ibit(Dim) ) : ~0;
+
+  /*!
+   *  Merged weight (times sandwich::Den) of a[l] b[i] b[j] in blade k, for blades bi, bj.
+   *  Reversing bj * l * bi gives the coefficient of k in it as rev(k) rev(l) rev(bi) rev(bj)
+   *  times that in bi * l * bj, so the two terms cancel unless rev(k) == rev(l), and then
+   *  coef * rev(bj) + coef * rev(bj) is twice the first.
+   */
+  static constexpr int Weight( TT k, TT l, TT bi, TT bj, bool same ){
+    return sandwich::rev(k) != sandwich::rev(l) || !sandwich::reaches( bi ^ l ^ bj, k, Dim, SplitIt ) ? 0 :
+      sandwich::fix( sandwich::coef( bi, l, bj, k, Dim, Neg, SplitIt ) * ( same ? sandwich::rev(bi) : 2 * sandwich::rev(bj) ) );
+  }
+};
+
+/// W * x for a compile time weight W (in units of 1/sandwich::Den)
+template<int W, bool Whole = ( W % sandwich::Den == 0 ) >
+struct SwScale{
+  template<class T> static constexpr T Exec( const T& x ){ return x * ( (double)W / sandwich::Den ); }
+};
+template<int W>
+struct SwScale<W, true>{
+  template<class T> static constexpr T Exec( const T& x ){ return x * (W / sandwich::Den); }
+};
+template<> struct SwScale<sandwich::Den, true>{
+  template<class T> static constexpr T Exec( const T& x ){ return x; }
+};
+template<> struct SwScale<-sandwich::Den, true>{
+  template<class T> static constexpr T Exec( const T& x ){ return -x; }
+};
+
+/// adds the derivative of s * W * b[i] * b[j] in each b[m] to d[m]
+template<int I, int J, int W, bool Same = ( I == J )>
+struct SwPairDiff{
+  template<class T, class TB>
+  static void Exec( T * d, const T& s, const TB& b ){
+    d[I] += SwScale<W>::Exec( s * b[J] );
+    d[J] += SwScale<W>::Exec( s * b[I] );
+  }
+};
+template<int I, int J, int W>
+struct SwPairDiff<I, J, W, true>{
+  template<class T, class TB>
+  static void Exec( T * d, const T& s, const TB& b ){
+    d[I] += SwScale<2 * W>::Exec( s * b[I] );
+  }
+};
+
+/// W * b[i] * b[j]
+template<int I, int J, int W>
+struct SwPair{
+  template<class TA, class TB>
+  static constexpr typename TA::VT Exec( const TA& b, const TB& ){
+    return SwScale<W>::Exec( b[I] * b[J] );
+  }
+  template<class T, class TB>
+  static void Diff( T * d, const T& s, const TB& b ){ SwPairDiff<I, J, W>::Exec( d, s, b ); }
+  static void print(){ printf(" %g * b[%d] * b[%d]\t", (double)W / sandwich::Den, I, J ); }
+};
+
+/// derivatives of s * (sum of pairs) in each b[m], added to d[m]
+template<class Pairs>
+struct SwDiff;
+template<class ... PS>
+struct SwDiff< XList<PS...> >{
+  template<class T, class TB>
+  static void Exec( T * d, const T& s, const TB& b ){
+    int tmp[] = { 0, ( PS::Diff( d, s, b ), 0 )... };
+    (void)tmp;
+  }
+};
+
+/// a[l] * ( sum of pairs ), negated if Flip (involuted a[l])
+template<int L, class Pairs, bool Flip>
+struct SwRow{
+  static const int Idx = L;
+  template<class TA, class TB>
+  static constexpr typename TA::VT Exec( const TA& a, const TB& b ){
+    return SwScale< Flip ? -sandwich::Den : sandwich::Den >::Exec( a[L] * Pairs::Exec( b, b ) );
+  }
+  /// the coefficient of a[l] alone (an entry of the outermorphism matrix of b)
+  template<class TB>
+  static constexpr typename TB::VT Coef( const TB& b ){
+    return SwScale< Flip ? -sandwich::Den : sandwich::Den >::Exec( Pairs::Exec( b, b ) );
+  }
+  /// adds the derivative of the row in each b[m] to d[m]
+  template<class T, class TA, class TB>
+  static void Diff( T * d, const TA& a, const TB& b ){
+    SwDiff<Pairs>::Exec( d, T( Flip ? -a[L] : a[L] ), b );
+  }
+  static void print(){ printf("%sa[%d] * (", Flip ? "-" : "", L); Pairs::print(); printf(")\n"); }
+};
+
+/*!
+ *  Nonzero pairs I <= J of blades BS contributing a[L] to blade K, as one table per
+ *  (K, L) row.  Pair p = I * N + J enumerates (0,0) (0,1) ... (0,N-1) (1,1) ... and zero pairs are
+ *  skipped by constexpr functions, so templates are only instantiated for the pairs
+ *  that end up in the instruction list.
+ */
+template<TT K, TT L, class Cfg, TT ... BS>
+struct SwPairTable{
+  static const int N = sizeof...(BS);
+  static const int Num = N * N;
+  static constexpr TT Blade[N] = { BS... };
+
+  static constexpr int I( int p ){ return p / N; }
+  static constexpr int J( int p ){ return p % N; }
+
+  static constexpr int W( int p ){
+    return Cfg::Weight( K, L, Blade[ I(p) ], Blade[ J(p) ], I(p) == J(p) );
+  }
+  /// first nonzero pair p = i * N + j (j >= i) from pair (i,j) on, Num if none
+  static constexpr int Next( int i, int j ){
+    return i == N ? Num : j == N ? Next( i + 1, i + 1 ) :
+      ( ( Blade[i] ^ Blade[j] ^ K ^ L ) & Cfg::Fixed ) == 0 && W( i * N + j ) != 0 ? i * N + j : Next( i, j + 1 );
+  }
+};
+
+/// the nonzero pairs of table P from pair p on, appended to XS
+template<class P, int p, bool End = ( p == P::Num ), class ... XS>
+struct SwPairList{
+  static const int Next = P::Next( P::I(p), P::J(p) + 1 );
+  typedef typename SwPairList< P, Next, Next == P::Num, XS..., SwPair< P::I(p), P::J(p), P::W(p) > >::Type Type;
+};
+template<class P, int p, class ... XS>
+struct SwPairList< P, p, true, XS... >{
+  typedef XList<XS...> Type;
+};
+
+/// all nonzero pairs of blades in B (an MVT) contributing a[L] to blade K
+template<class B, TT K, TT L, class Cfg>
+struct SwPairs;
+template<class T, TT ... BS, TT K, TT L, class Cfg>
+struct SwPairs< MVT<T, BS...>, K, L, Cfg >{
+  typedef SwPairTable< K, L, Cfg, BS... > P;
+  typedef typename SwPairList< P, P::Next(0,0) >::Type Type;
+};
+
+/// the MVT a multivector type derives from
+template<class T, TT ... XS>
+MVT<T, XS...> swBase( const MVT<T, XS...>& );
+
+/// rows over the blades of A (input coefficient a[L]) for output blade K
+template<class A, int L, TT K, class B, class Cfg, bool Invol>
+struct SwRows{
+  typedef typename SwPairs< B, K, A::HEAD, Cfg >::Type Pairs;
+  typedef typename XCat<
+    typename Maybe< Pairs::Num == 0, XList<>, XList< SwRow<L, Pairs, Invol && involute(A::HEAD)> > >::Type,
+    typename SwRows< typename A::TAIL, L+1, K, B, Cfg, Invol >::Type
+  >::Type Type;
+};
+template<class T, int L, TT K, class B, class Cfg, bool Invol>
+struct SwRows< MVT<T>, L, K, B, Cfg, Invol >{
+  typedef XList<> Type;
+};
+
+/// one list of rows per output blade of R
+template<class R, class A, class B, class Cfg, bool Invol>
+struct SwIndex{
+  typedef typename XCat<
+    XList< typename SwRows< A, 0, R::HEAD, B, Cfg, Invol >::Type >,
+    typename SwIndex< typename R::TAIL, A, B, Cfg, Invol >::Type
+  >::Type Type;
+};
+template<class T, class A, class B, class Cfg, bool Invol>
+struct SwIndex< MVT<T>, A, B, Cfg, Invol >{
+  typedef XList<> Type;
+};
+
+/*!
+ *  Writes the matrix of a fused instruction list DO (one row list per output blade)
+ *  into m, row major with N columns: m[k*N + l] is the coefficient of a[l] in r[k].
+ *  Entries without instructions are left untouched.
+ */
+template<class DO, int K = 0>
+struct SwMatrix{
+  template<class T, class TB>
+  static void Exec( T * m, int N, const TB& b ){}
+};
+template<class ... RS, class ... XS, int K>
+struct SwMatrix< XList< XList<RS...>, XS... >, K >{
+  template<class T, class TB>
+  static void Exec( T * m, int N, const TB& b ){
+    int tmp[] = { 0, ( m[ K * N + RS::Idx ] = RS::Coef(b), 0 )... };
+    (void)tmp;
+    SwMatrix< XList<XS...>, K+1 >::Exec( m, N, b );
+  }
+};
+
+/*!
+ *  Adds the derivatives of a fused instruction list DO in the coefficients of b into m,
+ *  row major with N columns: m[k*N + i] is the derivative of r[k] in b[i].  Each pair
+ *  W * b[i] * b[j] of a row contributes W * a[l] * b[j] to column i and W * a[l] * b[i]
+ *  to column j, so the list is differentiated at compile time.
+ */
+template<class DO, int K = 0>
+struct SwJacobian{
+  template<class T, class TA, class TB>
+  static void Exec( T * m, int N, const TA& a, const TB& b ){}
+};
+template<class ... RS, class ... XS, int K>
+struct SwJacobian< XList< XList<RS...>, XS... >, K >{
+  template<class T, class TA, class TB>
+  static void Exec( T * m, int N, const TA& a, const TB& b ){
+    int tmp[] = { 0, ( RS::Diff( m + K * N, a, b ), 0 )... };
+    (void)tmp;
+    SwJacobian< XList<XS...>, K+1 >::Exec( m, N, a, b );
+  }
+};
+
+/// number of multiplications in a fused instruction list, pair products included
+template<class X>
+struct SwCost{
+  static const int Val = 1;
+};
+template<>
+struct SwCost< XList<> >{
+  static const int Val = 0;
+};
+template<class X, class ... XS>
+struct SwCost< XList<X, XS...> >{
+  static const int Val = SwCost<X>::Val + SwCost< XList<XS...> >::Val;
+};
+template<int I, int J, int W>
+struct SwCost< SwPair<I,J,W> >{
+  static const int Val = ( W == sandwich::Den || W == -sandwich::Den ) ? 0 : 1;
+};
+template<int L, class Pairs, bool Flip>
+struct SwCost< SwRow<L,Pairs,Flip> >{
+  static const int Val = SwCost<Pairs>::Val + 1;
+};
+
+/*!
+ *  SwCost of the fused list of A (blades AS) and B (blades BS) by constexpr functions
+ *  alone, so that choosing between fused and staged does not build the fused list.
+ *  A pair counts 1 << 16 plus 1 if its weight is not unit, a row 1 more if it has pairs.
+ */
+template<class A, class B, class Cfg>
+struct SwCount;
+template<class T, TT ... AS, class S, TT ... BS, class Cfg>
+struct SwCount< MVT<T, AS...>, MVT<S, BS...>, Cfg >{
+  static constexpr int Sum(){ return 0; }
+  template<class ... XS>
+  static constexpr int Sum( int a, XS ... xs ){ return a + Sum( xs... ); }
+  static constexpr unsigned long long Or(){ return 0; }
+  template<class ... XS>
+  static constexpr unsigned long long Or( unsigned long long a, XS ... xs ){ return a | Or( xs... ); }
+
+  /// blades of B as bits (blade x is bit x % 64 of Lo, or of Hi past 64)
+  static constexpr unsigned long long Bit( int w, TT x ){ return x / 64 == w ? 1ull << ( x % 64 ) : 0; }
+  static constexpr unsigned long long Lo = Or( Bit( 0, BS )... ), Hi = Or( Bit( 1, BS )... );
+  static constexpr bool Has( TT x ){ return ( ( x < 64 ? Lo : Hi ) >> ( x % 64 ) ) & 1; }
+
+  static constexpr int Unit( int w ){ return w == 0 ? 0 : ( 1 << 16 ) + ( w == sandwich::Den || w == -sandwich::Den ? 0 : 1 ); }
+  static constexpr int Pair( TT k, TT l, TT bi, TT bj ){
+    return !Has( bj ) ? 0 : Unit( Cfg::Weight( k, l, bi < bj ? bi : bj, bi < bj ? bj : bi, bi == bj ) );
+  }
+  /// a[l] * bi * bj reaches k only for bj = bi ^ l ^ k, or that with no and ni swapped if split
+  static constexpr int Pairs( TT k, TT l, TT bi ){
+    return Pair( k, l, bi, bi ^ l ^ k ) + ( Cfg::Fixed == TT(~0) ? 0 : Pair( k, l, bi, bi ^ l ^ k ^ ~Cfg::Fixed ) );
+  }
+  /// over ordered pairs each i != j is counted twice (its weight is symmetric): add i == j once more and halve
+  static constexpr int Rows( TT k, TT l ){
+    return sandwich::rev(k) != sandwich::rev(l) ? 0 : ( Sum( Pairs( k, l, BS )... ) + ( ( ( k ^ l ) & Cfg::Fixed ) == 0 ? Sum( Pair( k, l, BS, BS )... ) : 0 ) ) / 2;
+  }
+  static constexpr int Row( int v ){ return v == 0 ? 0 : ( v & 0xFFFF ) + 1; }
+
+  /// cost of output blade k
+  static constexpr int Out( TT k ){ return Sum( Row( Rows( k, AS ) )... ); }
+  static const int Val = Sum( Out( AS )... );
+
+  /// number of pairs writing blade k
+  static constexpr int Terms( TT k ){ return Sum( ( Rows( k, AS ) >> 16 )... ); }
+  /// number of blades written
+  static const int Blades = Sum( ( Terms( AS ) > 0 ? 1 : 0 )... );
+  /// additions: one less than the terms of each blade written
+  static const int Adds = Sum( Terms( AS )... ) - Blades;
+};
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_sandwich_INC  ----- */
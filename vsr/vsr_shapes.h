@@ -17,6 +17,7 @@
  */
 
 #include "vsr_cga3D_op.h"
+#include "vsr_par.h"
 //#include "vsr_cga3D_funcs.h"
 
 #include "gfx/gfx_mesh.h"
@@ -50,8 +51,7 @@ namespace vsr{
         //|
         //a --- b
         for (int j = 0; j < slices; ++j){
-          static bool color = false;
-          color = !color;
+          bool color = j % 2 == 0;
           for (int i = 0; i < stacks; ++i){   
             int a = j * stacks + i;
             int b = (j < slices - 1) ?  a + stacks : i;
@@ -75,17 +75,23 @@ namespace vsr{
     ///Skin Circles -- pass in an array or vector of circles
     template<typename T>
     static inline Mesh Skin( T cir, int num, int res = 10){
+        return Skin( par::seq, cir, num, res );
+    }
+
+    ///Skin Circles, with points on them found by threads of policy (e.g. par::par)
+    template<typename P, typename T>
+    static inline Mesh Skin( const P& policy, T cir, int num, int res = 10,
+                             typename std::enable_if< std::is_same<P, par::Sequential>::value ||
+                                                      std::is_same<P, par::Parallel>::value >::type * = 0 ){
   
         Mesh m;
-        
-        for (int i = 0;  i < res; ++i){
-            double t= 1.0 * i/res;
-            
-            for (int j = 0; j < num; ++j){
-                Vec v = Ro::pnt_cir( cir[j], TWOPI * t );
-                m.add( v[0], v[1], v[2] );
-            }
-        }
+
+        vector<Vec> v( res * num );
+        par::for_each_index( policy, v.size(), [&]( size_t k ){
+            double t= 1.0 * ( k / num )/res;
+            v[k] = Ro::pnt_cir( cir[ k % num ], TWOPI * t );
+        });
+        for (auto& i : v) m.add( i[0], i[1], i[2] );
         
         //Calc Indices (FOR TRIANGLE STRIP)
         int a,b,c,d;
@@ -0,0 +1,88 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_simd.h
+ *
+ *    Description:  fixed width lane packs for running instruction lists across many
+ *                  multivectors at once
+ *
+ *                  MVT< Lanes<double>, XS... > is an ordinary multivector whose
+ *                  coefficients are packs, so every Prod / OProd / IProd / RProd
+ *                  instruction list executes Width elements per instruction.
+ *
+ *                  Width follows the widest vector unit enabled at compile time
+ *                  (-msse2, -mavx2, -mavx512f or -march=native).  Packs are gcc/clang
+ *                  vector extensions, so T must be float or double (or an integer).
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_simd_INC
+#define  vsr_simd_INC
+
+#include <stddef.h>
+#include <string.h>
+
+namespace vsr {
+
+#if defined(__AVX512F__)
+  #define VSR_SIMD_BYTES 64
+#elif defined(__AVX__)
+  #define VSR_SIMD_BYTES 32
+#else
+  #define VSR_SIMD_BYTES 16
+#endif
+
+/// Number of T that fit in one vector register (at least 1)
+template<class T>
+constexpr int simdWidth(){
+  return VSR_SIMD_BYTES / sizeof(T) > 0 ? VSR_SIMD_BYTES / sizeof(T) : 1;
+}
+
+/*!
+ *  \brief  Pack of W scalars operated on element-wise (one vector register)
+ *
+ *  Implicitly constructible from a scalar (broadcast) so that it can stand in for VT
+ *  anywhere inside the product engine.
+ */
+template<class T, int W = simdWidth<T>() >
+struct Lanes {
+
+  typedef T VT;
+  static const int Width = W;
+
+  typedef T Vec __attribute__(( vector_size( W * sizeof(T) ) ));
+  Vec val;
+
+  Lanes() = default;
+
+  Lanes( T s ){ for (int i = 0; i < W; ++i) val[i] = s; }
+
+  /// Load W contiguous scalars (p aligned to W * sizeof(T))
+  static Lanes load( const T * p ){
+    Lanes r; memcpy( &r.val, p, sizeof(Vec) ); return r;
+  }
+  /// Store W contiguous scalars (p aligned to W * sizeof(T))
+  void store( T * p ) const { memcpy( p, &val, sizeof(Vec) ); }
+
+  T operator[] (int i) const { return val[i]; }
+  T& operator[] (int i) { return val[i]; }
+
+  Lanes operator - () const { Lanes r; r.val = -val; return r; }
+
+  Lanes& operator += (const Lanes& b){ val += b.val; return *this; }
+  Lanes& operator -= (const Lanes& b){ val -= b.val; return *this; }
+  Lanes& operator *= (const Lanes& b){ val *= b.val; return *this; }
+  Lanes& operator /= (const Lanes& b){ val /= b.val; return *this; }
+
+  friend Lanes operator + (Lanes a, const Lanes& b){ return a += b; }
+  friend Lanes operator - (Lanes a, const Lanes& b){ return a -= b; }
+  friend Lanes operator * (Lanes a, const Lanes& b){ return a *= b; }
+  friend Lanes operator / (Lanes a, const Lanes& b){ return a /= b; }
+};
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_simd_INC  ----- */
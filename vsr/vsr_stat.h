@@ -13,6 +13,9 @@
 #include <stdlib.h>
 #include <time.h> 
 #include <math.h>
+#include <random>
+#include <thread>
+#include <functional>
 //#include <tr1/random>
 
 namespace vsr{
@@ -25,38 +28,41 @@ namespace vsr{
 
 /*! 
  Probability Density Functions
+
+ Each thread draws from its own generator (no shared state, unlike rand()), 
+ so Seed only affects the calling thread.
  */
     struct Rand {
         
+        /// This thread's generator
+        inline static std::mt19937& Engine() {
+            static thread_local std::mt19937 gen;
+            return gen;
+        }
 
         /// Seed 
-        
-        // inline static void Seed(int num){
-        //     srand(num);
-        //     gen.seed( num );
-        // }  
+        inline static void Seed(unsigned num){
+            Engine().seed( num );
+        }  
 
+        /// Seed from the time (and the thread, so threads seeded together differ)
         inline static void Seed() { 
-            
-            //typical srand
-            srand( time(NULL) ); 
-            //gen.seed( time(NULL) );
-            
+            Seed( time(NULL) ^ std::hash<std::thread::id>()( std::this_thread::get_id() ) );
         }
         
         /// Number Between 0 and 1; 
-        inline static double Num() { return 1.0 * rand() / (RAND_MAX); }
+        inline static double Num() { return std::generate_canonical<double, 32>( Engine() ); }
         
         /// Number Between 0 and max
-        inline static double Num(double max) { return max * rand() / (RAND_MAX); }
+        inline static double Num(double max) { return max * Num(); }
 
         /// Number Between low and high
         inline static double Num(double low, double high){
-            return low + ( (high-low) * rand() / RAND_MAX );
+            return low + (high-low) * Num();
         }
 
         /// Random Boolean
-        inline static bool Boolean() { return rand() & 1; }            
+        inline static bool Boolean() { return Engine()() & 1; }            
 
         /// Integer between high and low
         inline static int Int( int high, int low = 0 ) {
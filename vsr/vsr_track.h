@@ -0,0 +1,207 @@
+/*
+ * =====================================================================================
+ *
+ *       Filename:  vsr_track.h
+ *
+ *    Description:  precomputed screw motion through key motors, for sampling at frame rate
+ *
+ *                  MotorTrack logs each step between consecutive keys once, when it is
+ *                  built.  Segment i then moves key i along
+ *
+ *                    M(s) = Gen::mot( p_i(s) ) * key[i],   0 <= s <= 1
+ *
+ *                  where p_i is a polynomial in the dual line of the step: linear (the
+ *                  constant screw of Gen::ratio) or a cubic hermite whose tangents average
+ *                  the neighbouring steps, so velocity is nearly continuous at the keys.
+ *                  Either passes through every key.  Sampling is one closed form exponential
+ *                  and one motor product, with no logarithm and no search (keys are evenly
+ *                  spaced over 0 <= t <= 1):
+ *
+ *                    MotorTrack track( keys, CUBIC );
+ *                    Mot m = track.at( .3 );
+ *                    track.eval( ts, n, mots );            //n motors
+ *                    track.mat( ts, n, floats );           //n column-major 4x4 matrices
+ *
+ *                  eval() and mat() push blocks of samples through the exponential and
+ *                  motor product kernels of vsr_dispatch.h (link libvsr).  Tracks built
+ *                  from a Twist, CoupledTwist or NTwist sample their mot(t).
+ *
+ *         Author:  Pablo Colapinto (), gmail -> wolftype
+ *
+ * =====================================================================================
+ */
+
+#ifndef  vsr_track_INC
+#define  vsr_track_INC
+
+#include <vector>
+
+#include "vsr_twist.h"
+#include "vsr_batch.h"
+
+namespace vsr {
+
+/*!
+ *  \brief  Piecewise screw motion through evenly spaced key motors
+ *
+ *  Interpolation is LINEAR or CUBIC (anything else is taken as CUBIC).  Keys should be
+ *  normalized; each step takes the shorter of the two screws between its keys, so a
+ *  key may come back negated (the same rigid motion).
+ */
+class MotorTrack {
+
+  public:
+
+  /// Segment i: M(s) = Gen::mot( ( (c3 * s + c2) * s + c1 ) * s ) * key
+  struct Segment {
+    Mot key;
+    Dll c1, c2, c3;
+  };
+
+  private:
+
+  vector<Segment> mSeg;
+  Interpolation mMode;
+
+  /// Segment and local parameter of t (clamped to 0 ... 1)
+  int locate( double t, double& s ) const {
+    int n = mSeg.size();
+    double u = ( t < 0 ? 0 : t > 1 ? 1 : t ) * n;
+    int i = u;
+    if ( i > n - 1 ) i = n - 1;
+    s = u - i;
+    return i;
+  }
+
+  static Dll poly( const Segment& g, double s ){
+    return ( ( g.c3 * s + g.c2 ) * s + g.c1 ) * s;
+  }
+
+  public:
+
+  MotorTrack() : mMode( LINEAR ) {}
+
+  explicit MotorTrack( const vector<Mot>& keys, Interpolation mode = LINEAR ) { set( keys, mode ); }
+
+  /// num keys of t.mot( i / (num-1) ): exact along a single twist with LINEAR and num = 2
+  MotorTrack( const Twist& t, int num = 2, Interpolation mode = LINEAR ) { sample( t, num, mode ); }
+  MotorTrack( const CoupledTwist& t, int num, Interpolation mode = CUBIC ) { sample( t, num, mode ); }
+  MotorTrack( const NTwist& t, int num, Interpolation mode = CUBIC ) { sample( t, num, mode ); }
+
+  /// Rebuild from keys (at least two)
+  void set( const vector<Mot>& keys, Interpolation mode = LINEAR ){
+
+    mMode = mode;
+    int n = keys.size() - 1;
+    mSeg.resize( n > 0 ? n : 0 );
+    if ( n < 1 ) return;
+
+    //step i as a dual line, turning the shorter way round: key i+1 takes the sign
+    //of the end of step i so the track is continuous there
+    vector<Mot> key( keys );
+    vector<Dll> step( n );
+    for (int i = 0; i < n; ++i){
+      Mot m = key[i+1] / key[i];
+      VT r = m.rnorm(); if ( r != 0 ) m /= r;
+      if ( m[0] < 0 ){ m *= -1; key[i+1] *= -1; }
+      if ( m[0] > 1 ) m[0] = 1;
+      step[i] = Gen::log( m );
+    }
+
+    for (int i = 0; i < n; ++i){
+      Segment& g = mSeg[i];
+      g.key = key[i];
+      if ( mode == LINEAR ){
+        g.c1 = step[i]; g.c2 = Dll(); g.c3 = Dll();
+      } else {
+        Dll ta = i > 0 ? ( step[i-1] + step[i] ) * .5 : step[i];
+        Dll tb = i < n - 1 ? ( step[i] + step[i+1] ) * .5 : step[i];
+        g.c1 = ta;
+        g.c2 = step[i] * 3 - ta * 2 - tb;
+        g.c3 = ta + tb - step[i] * 2;
+      }
+    }
+  }
+
+  /// Rebuild from num samples of f.mot( t ), 0 <= t <= 1
+  template<class F>
+  void sample( const F& f, int num, Interpolation mode ){
+    vector<Mot> keys( num < 2 ? 2 : num );
+    for (size_t i = 0; i < keys.size(); ++i) keys[i] = f.mot( (double)i / ( keys.size() - 1 ) );
+    set( keys, mode );
+  }
+
+  int num() const { return mSeg.size(); }                     ///< Number of segments
+  Interpolation mode() const { return mMode; }
+  const Segment& segment( int i ) const { return mSeg[i]; }
+
+  /// Motor at t, 0 <= t <= 1
+  Mot at( double t ) const {
+    double s; const Segment& g = mSeg[ locate( t, s ) ];
+    return Gen::mot( poly( g, s ) ) * g.key;
+  }
+
+  Mot operator() ( double t ) const { return at( t ); }
+
+  /// Column-major 4x4 matrix (OpenGL order) of unit motor m
+  template<class T>
+  static void mat( const Mot& m, T * x ){
+    double w = m[0], a = m[1], b = m[2], c = m[3];
+    //rotation of the rotor part, columns are the images of e1, e2, e3
+    x[0] = w*w - a*a - b*b + c*c;  x[1] = -2 * ( w*a + b*c );       x[2] = 2 * ( a*c - w*b );        x[3] = 0;
+    x[4] = 2 * ( w*a - b*c );      x[5] = w*w - a*a + b*b - c*c;  x[6] = -2 * ( w*c + a*b );       x[7] = 0;
+    x[8] = 2 * ( w*b + a*c );      x[9] = 2 * ( w*c - a*b );       x[10] = w*w + a*a - b*b - c*c; x[11] = 0;
+    //translation: m * ~rotor = 1 - v ni / 2
+    Drv d( m * Rot( w, -a, -b, -c ) );
+    x[12] = -2 * d[0]; x[13] = -2 * d[1]; x[14] = -2 * d[2]; x[15] = 1;
+  }
+
+  /// r[i] = at( t[i] ) for n samples
+  template<int Acc = simd::Full>
+  void eval( const double * t, size_t n, Mot * r ) const {
+    blocks<Acc>( t, n, [&]( const NMotBatch<5>& m, size_t i ){
+      for (size_t k = 0; k < m.size(); ++k) for (int j = 0; j < Mot::Num; ++j) r[i+k][j] = m.data(j)[k];
+    });
+  }
+
+  /// 16 T of column-major matrix per sample into r, for n samples
+  template<int Acc = simd::Full, class T>
+  void mat( const double * t, size_t n, T * r ) const {
+    blocks<Acc>( t, n, [&]( const NMotBatch<5>& m, size_t i ){
+      for (size_t k = 0; k < m.size(); ++k) mat( Mot( m.get(k) ), r + ( i + k ) * 16 );
+    });
+  }
+
+  template<int Acc = simd::Full>
+  vector<Mot> eval( const vector<double>& t ) const {
+    vector<Mot> r( t.size() ); eval<Acc>( t.data(), t.size(), r.data() ); return r;
+  }
+
+  private:
+
+  /// f( motors, first ) for each run of up to Block samples of t, evaluated in structure of arrays
+  template<int Acc, class F>
+  void blocks( const double * t, size_t n, F f ) const {
+    static const size_t Block = 256;
+    size_t b = n < Block ? n : Block;
+    NDllBatch<5> d( b );
+    NMotBatch<5> k( b ), e( b ), m( b );
+    for (size_t i = 0; i < n; i += b){
+      size_t len = n - i < b ? n - i : b;
+      if ( len != d.size() ){ d.resize( len ); k.resize( len ); e.resize( len ); m.resize( len ); }
+      for (size_t j = 0; j < len; ++j){
+        double s; const Segment& g = mSeg[ locate( t[i+j], s ) ];
+        d.set( j, poly( g, s ) );
+        k.set( j, g.key );
+      }
+      Gen::mot<Acc>( d, e );
+      e.gp( k, m );
+      f( m, i );
+    }
+  }
+
+};
+
+} //vsr::
+
+#endif   /* ----- #ifndef vsr_track_INC  ----- */
@@ -215,7 +215,7 @@ namespace vsr {
 			void periodZ( double theta ) { period(theta,2); }
 			
 			/// Concatenated Motors (x first, then y, then z ) with weight of t
-			Mot mot(double t) { return mTwist[2].mot(t) * mTwist[1].mot(t) * mTwist[0].mot(t); }
+			Mot mot(double t) const { return mTwist[2].mot(t) * mTwist[1].mot(t) * mTwist[0].mot(t); }
 			/// Bivector Generator of motor at t
 			Dll dll(double t) { Mot m = mot(t); m/=m.rnorm(); return Gen::log( m ); }
 //			Mot motor(double t) { return Gen::mot_dll( dll()*t ); }
@@ -239,7 +239,7 @@ namespace vsr {
 			
 		public:
 		
-			NTwist(int n) : mNum(n) { mTwist.resize(mNum); }
+			NTwist(int n) : mDll(0), mNum(n) { mTwist.resize(mNum); }
 			~NTwist() { if (mDll) delete[] mDll; }
 			
 			/// Gets raw data (dual line) of twist
@@ -258,7 +258,7 @@ namespace vsr {
 			void period( double theta, int i ) { mTwist[i].period(theta); }
 			
 			/// Concatenated Motors (x first, then y, then z ) with weight of t
-			Mot mot(double t) { 
+			Mot mot(double t) const { 
 				Mot rm;
 				rm[0] = 1;				
 				for (int i =mNum-1; i >= 0; --i){
@@ -21,8 +21,8 @@ template<class A, int IDX=0>
 struct Reverse{
 	typedef typename XCat< XList< InstFlip< reverse(A::HEAD), IDX> > , typename Reverse<typename A::TAIL, IDX+1>::Type >::Type Type; 
 };
-template<int IDX>
-struct Reverse< MV<>, IDX >{
+template<class T, int IDX>
+struct Reverse< MVT<T>, IDX >{
 	typedef XList<> Type;  
 };
 
@@ -30,8 +30,8 @@ template<class A, int IDX=0>
 struct Conjugate{
 	typedef typename XCat< XList< InstFlip< conjugate(A::HEAD), IDX> > , typename Conjugate<typename A::TAIL, IDX+1>::Type >::Type Type; 
 };
-template<int IDX>
-struct Conjugate< MV<>, IDX >{
+template<class T, int IDX>
+struct Conjugate< MVT<T>, IDX >{
 	typedef XList<> Type;  
 };
 
@@ -39,13 +39,76 @@ template<class A, int IDX=0>
 struct Involute{
 	typedef typename XCat< XList< InstFlip< involute(A::HEAD), IDX> > , typename Involute<typename A::TAIL, IDX+1>::Type >::Type Type; 
 };
-template<int IDX>
-struct Involute< MV<>, IDX >{
+template<class T, int IDX>
+struct Involute< MVT<T>, IDX >{
 	typedef XList<> Type;  
 };
 
+//call f( IDX ) for each coefficient a list of InstFlip negates (e.g. to reverse in place)
+template<class L>
+struct Flips;
+template<>
+struct Flips< XList<> >{
+	template<class F> static void each( F ){}
+};
+template<bool N, int IDX, class ... XS>
+struct Flips< XList< InstFlip<N,IDX>, XS... > >{
+	template<class F> static void each( F f ){ if ( N ) f( IDX ); Flips< XList<XS...> >::each( f ); }
+};
+
+//r[K] = instruction K of a list on a, written straight into r (which must not alias a)
+template<class L, int K=0>
+struct Store;
+template<int K>
+struct Store< XList<>, K >{
+	template<class R, class A> static void Exec( R&, const A& ){}
+};
+template<class X, class ... XS, int K>
+struct Store< XList<X, XS...>, K >{
+	template<class R, class A> static void Exec( R& r, const A& a ){ r[K] = X::Exec( a ); Store< XList<XS...>, K+1 >::Exec( r, a ); }
+};
+
+//PRODUCT BY ONE UNIT BLADE: each row of the instruction list of a * b, b a single blade,
+//reads a[idxA] * b[0] with a sign.  With b = +-1 (Neg for -1) that is a signed permutation
+//of a with no multiplies left
+template<class I>
+struct InstSign;
+template<bool F, TT R, int IDXA, int IDXB>
+struct InstSign< Instruct<F,R,IDXA,IDXB> >{ static const bool Neg = F; };
+template<bool F, TT A, TT B, int IDXA, int IDXB>
+struct InstSign< Inst<F,A,B,IDXA,IDXB> >{ static const bool Neg = F; };
+
+template<class Row, bool Neg>
+struct PermRow{
+	typedef typename Row::HEAD X;
+	typedef InstFlip< InstSign<X>::Neg != Neg, X::idxA > Head;
+	template<class TA>
+	static constexpr typename TA::VT Exec(const TA& a){
+		return Head::Exec(a) + PermRow< typename Row::TAIL, Neg >::Exec(a);
+	}
+};
+template<class X, bool Neg>
+struct PermRow< XList<X>, Neg >{
+	template<class TA>
+	static constexpr typename TA::VT Exec(const TA& a){
+		return InstFlip< InstSign<X>::Neg != Neg, X::idxA >::Exec(a);
+	}
+};
+template<bool Neg>
+struct PermRow< XList<>, Neg > : InstCast<-1> {};
+
+template<class DO, bool Neg>
+struct BladePerm{
+	typedef typename XCat< XList< PermRow< typename DO::HEAD, Neg > >, typename BladePerm< typename DO::TAIL, Neg >::Type >::Type Type;
+};
+template<bool Neg>
+struct BladePerm< XList<>, Neg >{
+	typedef XList<> Type;
+};
+
 
-constexpr int find(int n, const MV<>, int idx){
+template<class T>
+constexpr int find(int n, const MVT<T>&, int idx){
 	return -1;
 }
 template<class A>
@@ -58,39 +121,62 @@ template<class A, class B>
 struct Cast{
 	typedef typename XCat< XList< InstCast< find( A::HEAD, B() ) > > , typename Cast< typename A::TAIL, B >::Type >::Type Type;  
 };  
-template<class B>
-struct Cast< MV<>, B >{
+template<class T, class B>
+struct Cast< MVT<T>, B >{
 	typedef XList<> Type;  
 };     
 
 
 
 
-template<TT X, TT...XS> template<class A> 
-A MV<X,XS...>::cast() const{
- return Cast<  A, MV<X,XS...> >::Type::template Cast<A>( *this );
+//COPY the first coefficients of a B (N of them) to an A, by index
+template<class A, int N, int IDX=0>
+struct Copy{
+	typedef typename XCat< XList< InstCast< ( IDX < N ? IDX : -1 ) > > , typename Copy< typename A::TAIL, N, IDX+1 >::Type >::Type Type;
+};
+template<class T, int N, int IDX>
+struct Copy< MVT<T>, N, IDX >{
+	typedef XList<> Type;
+};
+
+//instruction I<IDX> for every coefficient of A (e.g. InstSum, InstScale)
+template<class A, template<int> class I, int IDX=0>
+struct Each{
+	typedef typename XCat< XList< I<IDX> > , typename Each< typename A::TAIL, I, IDX+1 >::Type >::Type Type;
+};
+template<class T, template<int> class I, int IDX>
+struct Each< MVT<T>, I, IDX >{
+	typedef XList<> Type;
+};
+
+template<class T, TT X, TT...XS> template<class A> 
+constexpr A MVT<T,X,XS...>::cast() const{
+ return Cast<  A, MVT<T,X,XS...> >::Type::template Cast<A>( *this );
 }  
 
-template<TT X, TT...XS> template<class A>
-A MV<X,XS...>::copy() const{
-	A tmp;
-	for (int i = 0; i < A::Num; ++i) tmp[i] = (*this)[i];
-	return tmp;
+template<class T, TT X, TT...XS> template<class A>
+constexpr A MVT<T,X,XS...>::copy() const{
+	return Copy< A, MVT<T,X,XS...>::Num >::Type::template Cast<A>( *this );
+}
+
+/// unit blade X as an A (zero if A has no blade X), e.g. basis<Vec,1>() == Vec(1,0,0)
+template<class A, TT X>
+constexpr A basis(){
+	return MVT<typename A::VT, X>( 1 ).template cast<A>();
 }
-              
 
 
-template<TT X, TT...XS> template<TT IDX> 
-VT MV<X,XS...>::get() const{
+template<class T, TT X, TT...XS> template<TT IDX> 
+constexpr T MVT<T,X,XS...>::get() const{
  return val[ find(IDX, *this) ];
 }
-template<TT X, TT...XS> template<TT IDX> 
-VT& MV<X,XS...>::get() {
+template<class T, TT X, TT...XS> template<TT IDX> 
+T& MVT<T,X,XS...>::get() {
  return val[ find(IDX, *this) ];
 } 
 
-template<TT X, TT...XS> template<TT IDX> 
- MV<X,XS...>& MV<X,XS...>::set(VT v)
+template<class T, TT X, TT...XS> template<TT IDX> 
+ MVT<T,X,XS...>& MVT<T,X,XS...>::set(T v)
 {
 	get<IDX>() = v;
 	return *this;
@@ -103,13 +189,13 @@ template<TT X, TT...XS> template<TT IDX>
 // template<TT X, TT ... XS> MV<X,XS...> MV<X,XS...>::xz = MV<X,XS...>().set<5>(1);  
 // template<TT X, TT ... XS> MV<X,XS...> MV<X,XS...>::yz = MV<X,XS...>().set<6>(1);     
 
-template<TT X, TT...XS> 
-MV<X,XS...> MV<X,XS...>::conjugation() const{
-	return Conjugate<MV<X,XS...>>::Type::template Make(*this);
+template<class T, TT X, TT...XS> 
+constexpr MVT<T,X,XS...> MVT<T,X,XS...>::conjugation() const{
+	return Conjugate<MVT<T,X,XS...>>::Type::template Make(*this);
 }
-template<TT X, TT...XS> 
-MV<X,XS...> MV<X,XS...>::involution() const{
-	return Involute<MV<X,XS...>>::Type::template Make(*this);
+template<class T, TT X, TT...XS> 
+constexpr MVT<T,X,XS...> MVT<T,X,XS...>::involution() const{
+	return Involute<MVT<T,X,XS...>>::Type::template Make(*this);
 } 
 
 // template< TT X, TT ...XS>